@@ -0,0 +1,134 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBDiskCache.h
+/// \brief  Persistent on-disk cache of CCDB objects, shared between processes
+///
+
+#ifndef O2_CCDB_CCDBDISKCACHE_H
+#define O2_CCDB_CCDBDISKCACHE_H
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace ccdb
+{
+
+/// A local, content-addressed cache of the blobs served by the CCDB.
+///
+/// The blobs are stored once under blobs/<content hash>. For each query
+/// (path, metadata, time machine limits) a set of entries under
+/// index/<query hash>/ records the headers of the reply, among which the
+/// validity interval and the ETag of the object. A query for a timestamp
+/// covered by one of the entries is revalidated with a conditional request
+/// (If-None-Match with the cached ETag), so that the blob is only downloaded
+/// when it actually changed. If the server cannot be reached, the cached
+/// blob is served as is.
+///
+/// The cache can be shared by all the processes of a node: the files are
+/// written to a temporary file and atomically renamed, while the lookup and
+/// the update of a given query are serialised by a file lock, so that only
+/// the first process downloads a given object and the others find it.
+class CCDBDiskCache
+{
+ public:
+  using Headers = std::map<std::string, std::string>;
+
+  /// What the fetcher got for a given request
+  struct FetchResult {
+    enum Status {
+      Downloaded,  // the content and its headers were retrieved
+      NotModified, // the object with the ETag passed to the fetcher is still the right one
+      Failed       // the request failed
+    };
+    Status status = Failed;
+    std::vector<char> content;
+    Headers headers;
+  };
+
+  /// Retrieve the object from the server. When the argument is not empty, it
+  /// is the ETag of the cached object, to be used for a conditional request.
+  using Fetcher = std::function<FetchResult(std::string const& etag)>;
+
+  struct Entry {
+    std::string blob;
+    Headers headers;
+    long validFrom = 0;
+    long validUntil = 0;
+    long created = 0;
+    /// When (ms since epoch) the entry was last confirmed by the server
+    long checked = 0;
+  };
+
+  struct Stats {
+    size_t downloads = 0;     // objects downloaded from the server
+    size_t revalidations = 0; // conditional requests answered with "not modified"
+    size_t fresh = 0;         // objects served without contacting the server
+    size_t stale = 0;         // objects served because the server was not reachable
+    size_t misses = 0;        // requests which could not be served
+  };
+
+  /// @param dir the directory holding the cache, created if needed
+  /// @param revalidateAfter how long (ms) an entry is trusted without asking
+  ///        the server again, 0 to always revalidate
+  CCDBDiskCache(std::string const& dir, long revalidateAfter = 0);
+
+  /// Get the blob of the object valid at @a timestamp for the query @a key,
+  /// using @a fetch when it needs to be downloaded or revalidated.
+  /// @return true if @a content and @a headers were filled.
+  bool get(std::string const& key, long timestamp, Fetcher const& fetch, std::vector<char>& content, Headers& headers);
+
+  /// @return the cached entry for @a key covering @a timestamp, if any. When
+  /// several do, the most recently created one is returned.
+  std::optional<Entry> lookup(std::string const& key, long timestamp) const;
+
+  /// Add the blob @a content, downloaded for the query @a key, to the cache.
+  /// The headers need to provide the validity of the object.
+  /// @return false if the entry could not be stored.
+  bool store(std::string const& key, std::vector<char> const& content, Headers const& headers);
+
+  /// @return the identifier of a query
+  static std::string makeKey(std::string const& path, std::map<std::string, std::string> const& metadata,
+                             std::string const& createdNotAfter = "", std::string const& createdNotBefore = "");
+
+  std::string const& getDirectory() const { return mDir; }
+  long getRevalidateAfter() const { return mRevalidateAfter; }
+  void setRevalidateAfter(long ms) { mRevalidateAfter = ms; }
+  /// @return a snapshot of the statistics, which can be updated by other threads
+  Stats getStats() const;
+
+ private:
+  std::string indexDir(std::string const& key) const;
+  std::string blobPath(std::string const& blob) const;
+  bool readBlob(std::string const& blob, std::vector<char>& content) const;
+  /// Mark the entry as just confirmed by the server
+  void touch(std::string const& key, Entry& entry);
+  /// Write @a size bytes to @a path, going through a temporary file
+  static bool writeAtomically(std::string const& path, char const* data, size_t size);
+  void count(size_t Stats::*counter);
+
+  std::string mDir;
+  long mRevalidateAfter = 0;
+  Stats mStats;
+  mutable std::mutex mStatsMutex;
+};
+
+} // namespace ccdb
+} // namespace o2
+
+#endif // O2_CCDB_CCDBDISKCACHE_H
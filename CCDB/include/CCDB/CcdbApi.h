@@ -24,6 +24,7 @@
 #include <TObject.h>
 #include <TMessage.h>
 #include "CCDB/CcdbObjectInfo.h"
+#include "CCDB/CCDBDiskCache.h"
 #include <CommonUtils/ConfigurableParam.h>
 #include <type_traits>
 
@@ -72,6 +73,21 @@ class CcdbApi //: public DatabaseInterface
    */
   std::string const& getURL() const { return mUrl; }
 
+  /**
+   * Keep the retrieved objects in a persistent cache, which can be shared by
+   * several processes. Also enabled by the ALICEO2_CCDB_DISKCACHE environment
+   * variable (and ALICEO2_CCDB_DISKCACHE_REVALIDATE for the second argument).
+   *
+   * @param dir The directory of the cache
+   * @param revalidateAfter How long (ms) cached objects are served without checking with the server, 0 to always check
+   */
+  void setDiskCache(std::string const& dir, long revalidateAfter = 0);
+
+  /**
+   * Query the disk cache, nullptr if not enabled
+   */
+  CCDBDiskCache* getDiskCache() const { return mDiskCache.get(); }
+
   /**
    * Create a binary image of the arbitrary type object, if CcdbObjectInfo pointer is provided, register there 
    *
@@ -386,6 +402,9 @@ class CcdbApi //: public DatabaseInterface
    */
   void* downloadAlienContent(std::string const& fullUrl, std::type_info const& tinfo) const;
 
+  /// Helper function to download the binary image of a file on alien:// storage, returns false in case of failure
+  bool downloadAlienBlob(std::string const& fullUrl, std::vector<char>& blob) const;
+
   // initialize the TGrid (Alien connection)
   bool initTGrid() const;
   // checks if an alien token is available, required to make a TGrid connection
@@ -393,7 +412,16 @@ class CcdbApi //: public DatabaseInterface
 
   /// Queries the CCDB server and navigates through possible redirects until binary content is found; Retrieves content as instance
   /// given by tinfo if that is possible. Returns nullptr if something fails...
-  void* navigateURLsAndRetrieveContent(CURL*, std::string const& url, std::type_info const& tinfo, std::map<std::string, std::string>* headers) const;
+  /// When blob is not nullptr, the binary content is stored there instead of being interpreted.
+  /// The headers of the redirections are added to the ones of the first reply, without replacing them.
+  /// When responseCode is not nullptr, it is set to the HTTP code of the last reply (-1 if none).
+  void* navigateURLsAndRetrieveContent(CURL*, std::string const& url, std::type_info const& tinfo, std::map<std::string, std::string>* headers,
+                                       std::vector<char>* blob = nullptr, long* responseCode = nullptr) const;
+
+  /// Retrieve the object going through the disk cache, revalidating the cached version with the server
+  void* retrieveThroughDiskCache(std::type_info const& tinfo, std::string const& path, std::map<std::string, std::string> const& metadata,
+                                 long timestamp, std::map<std::string, std::string>* headers, std::string const& etag,
+                                 const std::string& createdNotAfter, const std::string& createdNotBefore) const;
 
   // helper that interprets a content chunk as TMemFile and extracts the object therefrom
   void* interpretAsTMemFileAndExtract(char* contentptr, size_t contentsize, std::type_info const& tinfo) const;
@@ -413,6 +441,7 @@ class CcdbApi //: public DatabaseInterface
   mutable TGrid* mAlienInstance = nullptr;                       // a cached connection to TGrid (needed for Alien locations)
   bool mHaveAlienToken = false;                                  // stores if an alien token is available
   static std::unique_ptr<TJAlienCredentials> mJAlienCredentials; // access JAliEn credentials
+  std::unique_ptr<CCDBDiskCache> mDiskCache;                     //! persistent cache of the retrieved objects
 
   ClassDefNV(CcdbApi, 1);
 };
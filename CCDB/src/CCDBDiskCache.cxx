@@ -0,0 +1,293 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBDiskCache.cxx
+///
+
+#include "CCDB/CCDBDiskCache.h"
+#include "CCDB/CCDBTimeStampUtils.h"
+#include <FairLogger.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace o2
+{
+namespace ccdb
+{
+
+namespace
+{
+constexpr const char* CHECKED_HEADER = "X-Cache-Checked";
+
+std::string fnv1a(char const* data, size_t size)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  char result[17];
+  snprintf(result, sizeof(result), "%016llx", static_cast<unsigned long long>(hash));
+  return result;
+}
+
+long toLong(CCDBDiskCache::Headers const& headers, std::string const& key, long defaultValue)
+{
+  auto it = headers.find(key);
+  if (it == headers.end()) {
+    return defaultValue;
+  }
+  try {
+    return std::stol(it->second);
+  } catch (...) {
+    return defaultValue;
+  }
+}
+
+/// Exclusive lock on a file, shared by all the processes using it.
+struct FileLock {
+  FileLock(std::string const& path)
+  {
+    fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+      close(fd);
+      fd = -1;
+    }
+    if (fd < 0) {
+      LOG(WARN) << "Could not lock " << path << ", continuing without";
+    }
+  }
+  ~FileLock()
+  {
+    if (fd >= 0) {
+      flock(fd, LOCK_UN);
+      close(fd);
+    }
+  }
+  int fd = -1;
+};
+} // namespace
+
+CCDBDiskCache::CCDBDiskCache(std::string const& dir, long revalidateAfter)
+  : mDir{dir},
+    mRevalidateAfter{revalidateAfter}
+{
+  std::error_code ec;
+  std::filesystem::create_directories(mDir + "/blobs", ec);
+  std::filesystem::create_directories(mDir + "/index", ec);
+  if (ec) {
+    LOG(ERROR) << "Could not create CCDB disk cache in " << mDir << ": " << ec.message();
+  }
+}
+
+std::string CCDBDiskCache::makeKey(std::string const& path, std::map<std::string, std::string> const& metadata,
+                                   std::string const& createdNotAfter, std::string const& createdNotBefore)
+{
+  std::string key = path;
+  for (auto& [name, value] : metadata) {
+    key += "/" + name + "=" + value;
+  }
+  return key + "|" + createdNotAfter + "|" + createdNotBefore;
+}
+
+std::string CCDBDiskCache::indexDir(std::string const& key) const
+{
+  return mDir + "/index/" + fnv1a(key.data(), key.size());
+}
+
+std::string CCDBDiskCache::blobPath(std::string const& blob) const
+{
+  return mDir + "/blobs/" + blob;
+}
+
+bool CCDBDiskCache::writeAtomically(std::string const& path, char const* data, size_t size)
+{
+  // The temporary name is unique among all the threads and processes sharing the cache
+  std::string tmp = path + ".tmp.XXXXXX";
+  int fd = mkstemp(tmp.data());
+  if (fd < 0) {
+    return false;
+  }
+  fchmod(fd, 0644);
+  bool ok = true;
+  for (size_t written = 0; ok && written < size;) {
+    auto n = write(fd, data + written, size - written);
+    ok = n > 0;
+    written += ok ? n : 0;
+  }
+  ok = (close(fd) == 0) && ok;
+  std::error_code ec;
+  if (ok) {
+    std::filesystem::rename(tmp, path, ec);
+  }
+  if (!ok || ec) {
+    std::filesystem::remove(tmp, ec);
+    return false;
+  }
+  return true;
+}
+
+bool CCDBDiskCache::readBlob(std::string const& blob, std::vector<char>& content) const
+{
+  std::ifstream in(blobPath(blob), std::ios::binary | std::ios::ate);
+  if (!in.is_open()) {
+    return false;
+  }
+  content.resize(in.tellg());
+  in.seekg(0);
+  return bool(in.read(content.data(), content.size())) && fnv1a(content.data(), content.size()) == blob;
+}
+
+std::optional<CCDBDiskCache::Entry> CCDBDiskCache::lookup(std::string const& key, long timestamp) const
+{
+  std::optional<Entry> result;
+  std::error_code ec;
+  for (auto& file : std::filesystem::directory_iterator(indexDir(key), ec)) {
+    if (file.path().extension() != ".meta") {
+      continue;
+    }
+    Entry entry;
+    entry.blob = file.path().stem().string();
+    std::ifstream in(file.path());
+    std::string line;
+    while (std::getline(in, line)) {
+      auto pos = line.find(':');
+      if (pos != std::string::npos) {
+        entry.headers[line.substr(0, pos)] = line.substr(pos + 2);
+      }
+    }
+    entry.validFrom = toLong(entry.headers, "Valid-From", 0);
+    entry.validUntil = toLong(entry.headers, "Valid-Until", 0);
+    entry.created = toLong(entry.headers, "Created", 0);
+    entry.checked = toLong(entry.headers, CHECKED_HEADER, 0);
+    entry.headers.erase(CHECKED_HEADER);
+    if (timestamp < entry.validFrom || timestamp >= entry.validUntil) {
+      continue;
+    }
+    if (!result || entry.created > result->created) {
+      result = std::move(entry);
+    }
+  }
+  return result;
+}
+
+bool CCDBDiskCache::store(std::string const& key, std::vector<char> const& content, Headers const& headers)
+{
+  if (headers.count("Valid-From") == 0 || headers.count("Valid-Until") == 0) {
+    LOG(WARN) << "Not caching " << key << ": the validity of the object is unknown";
+    return false;
+  }
+  Entry entry;
+  entry.blob = fnv1a(content.data(), content.size());
+  entry.headers = headers;
+  auto blob = blobPath(entry.blob);
+  // Blobs are content addressed, so an existing one is already the right one.
+  if (!std::filesystem::exists(blob) && !writeAtomically(blob, content.data(), content.size())) {
+    LOG(WARN) << "Could not write " << blob;
+    return false;
+  }
+  touch(key, entry);
+  return true;
+}
+
+void CCDBDiskCache::touch(std::string const& key, Entry& entry)
+{
+  entry.checked = getCurrentTimestamp();
+  std::ostringstream out;
+  for (auto& [name, value] : entry.headers) {
+    // Multiline values cannot be represented and are not needed anyway
+    if (value.find('\n') == std::string::npos) {
+      out << name << ": " << value << "\n";
+    }
+  }
+  out << CHECKED_HEADER << ": " << entry.checked << "\n";
+  auto meta = out.str();
+  auto dir = indexDir(key);
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (!writeAtomically(dir + "/" + entry.blob + ".meta", meta.data(), meta.size())) {
+    LOG(WARN) << "Could not update the CCDB disk cache index for " << key;
+  }
+}
+
+CCDBDiskCache::Stats CCDBDiskCache::getStats() const
+{
+  std::lock_guard<std::mutex> guard(mStatsMutex);
+  return mStats;
+}
+
+void CCDBDiskCache::count(size_t Stats::*counter)
+{
+  std::lock_guard<std::mutex> guard(mStatsMutex);
+  mStats.*counter += 1;
+}
+
+bool CCDBDiskCache::get(std::string const& key, long timestamp, Fetcher const& fetch, std::vector<char>& content, Headers& headers)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(mDir + "/index", ec);
+  // Only one process at the time looks up and updates a given query, so
+  // that the ones starting together do not all download the same object.
+  FileLock lock(indexDir(key) + ".lock");
+
+  auto entry = lookup(key, timestamp);
+  bool haveBlob = entry && readBlob(entry->blob, content);
+  if (haveBlob && mRevalidateAfter > 0 && getCurrentTimestamp() - entry->checked < mRevalidateAfter) {
+    count(&Stats::fresh);
+    headers = entry->headers;
+    return true;
+  }
+
+  std::string etag;
+  if (haveBlob && entry->headers.count("ETag")) {
+    etag = entry->headers["ETag"];
+  }
+  auto result = fetch(etag);
+  if (result.status == FetchResult::Downloaded && result.content.empty()) {
+    result.status = FetchResult::Failed;
+  }
+  if (result.status == FetchResult::NotModified && etag.empty()) {
+    result.status = FetchResult::Failed; // nothing to confirm
+  }
+  if (result.status == FetchResult::Downloaded) {
+    count(&Stats::downloads);
+    store(key, result.content, result.headers);
+    content = std::move(result.content);
+    headers = std::move(result.headers);
+    return true;
+  }
+  if (haveBlob && result.status == FetchResult::NotModified) {
+    count(&Stats::revalidations);
+    touch(key, *entry);
+    headers = entry->headers;
+    return true;
+  }
+  if (haveBlob && result.status == FetchResult::Failed) {
+    LOG(WARN) << "Could not revalidate " << key << ", using the cached object";
+    count(&Stats::stale);
+    headers = entry->headers;
+    return true;
+  }
+  count(&Stats::misses);
+  content.clear();
+  headers = std::move(result.headers);
+  return false;
+}
+
+} // namespace ccdb
+} // namespace o2
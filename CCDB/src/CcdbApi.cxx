@@ -16,6 +16,7 @@
 
 #include "CCDB/CcdbApi.h"
 #include "CCDB/CCDBQuery.h"
+#include "CCDB/CCDBDiskCache.h"
 #include "CommonUtils/StringUtils.h"
 #include "CommonUtils/MemFileHelper.h"
 #include <chrono>
@@ -75,6 +76,13 @@ void CcdbApi::init(std::string const& host)
     initInSnapshotMode(path);
   } else {
     curlInit();
+    // The environment option ALICEO2_CCDB_DISKCACHE enables a persistent cache
+    // of the retrieved objects, which can be shared by all the processes of a node.
+    auto diskcache = getenv("ALICEO2_CCDB_DISKCACHE");
+    if (diskcache) {
+      auto revalidate = getenv("ALICEO2_CCDB_DISKCACHE_REVALIDATE");
+      setDiskCache(diskcache, revalidate ? std::atol(revalidate) : 0);
+    }
   }
 
   // find out if we can can in principle connect to Alien
@@ -787,6 +795,27 @@ void* CcdbApi::downloadAlienContent(std::string const& url, std::type_info const
   return nullptr;
 }
 
+bool CcdbApi::downloadAlienBlob(std::string const& url, std::vector<char>& blob) const
+{
+  blob.clear();
+  if (!initTGrid()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(gIOMutex);
+  std::unique_ptr<TFile> file(TMemFile::Open(url.c_str(), "OPEN"));
+  if (!file || file->IsZombie()) {
+    return false;
+  }
+  blob.resize(file->GetSize());
+  // ReadBuffer returns true in case of failure
+  if (blob.empty() || file->ReadBuffer(blob.data(), 0, blob.size())) {
+    LOG(ERROR) << "Could not read " << url;
+    blob.clear();
+    return false;
+  }
+  return true;
+}
+
 void* CcdbApi::interpretAsTMemFileAndExtract(char* contentptr, size_t contentsize, std::type_info const& tinfo) const
 {
   void* result = nullptr;
@@ -807,7 +836,8 @@ void* CcdbApi::interpretAsTMemFileAndExtract(char* contentptr, size_t contentsiz
 }
 
 // navigate sequence of URLs until TFile content is found; object is extracted and returned
-void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string const& url, std::type_info const& tinfo, std::map<string, string>* headers) const
+void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string const& url, std::type_info const& tinfo, std::map<string, string>* headers,
+                                              std::vector<char>* blob, long* responseCode) const
 {
   // a global internal data structure that can be filled with HTTP header information
   // static --> to avoid frequent alloc/dealloc as optimization
@@ -816,6 +846,16 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
 
   // let's see first of all if the url is something specific that curl cannot handle
   if (url.find("alien:/", 0) != std::string::npos) {
+    if (blob) {
+      bool ok = downloadAlienBlob(url, *blob);
+      if (responseCode) {
+        *responseCode = ok ? 200 : -1;
+      }
+      if (!ok && headers) {
+        (*headers)["Error"] = "An error occurred during retrieval";
+      }
+      return nullptr;
+    }
     return downloadAlienContent(url, tinfo);
   }
   // add other final cases here
@@ -846,6 +886,9 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
   bool errorflag = false;
   bool cachingflag = false;
   if (res == CURLE_OK && curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response_code) == CURLE_OK) {
+    if (responseCode) {
+      *responseCode = response_code;
+    }
     if (headers) {
       for (auto& p : headerData) {
         (*headers)[p.first] = p.second;
@@ -853,7 +896,11 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
     }
     if (200 <= response_code && response_code < 300) {
       // good response and the content is directly provided and should have been dumped into "chunk"
-      content = interpretAsTMemFileAndExtract(chunk.memory, chunk.size, tinfo);
+      if (blob) {
+        blob->assign(chunk.memory, chunk.memory + chunk.size);
+      } else {
+        content = interpretAsTMemFileAndExtract(chunk.memory, chunk.size, tinfo);
+      }
     } else if (response_code == 304) {
       // this means the object exist but I am not serving
       // it since it's already in your possession
@@ -891,15 +938,27 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
           }
         }
       }
+      bool found = false;
       for (auto& l : locs) {
         if (l.size() > 0) {
           LOG(DEBUG) << "Trying content location " << l;
-          content = navigateURLsAndRetrieveContent(curl_handle, l, tinfo, nullptr);
-          if (content /* or other success marker in future */) {
+          std::map<string, string> locationHeaders;
+          long locationCode = -1;
+          content = navigateURLsAndRetrieveContent(curl_handle, l, tinfo, headers ? &locationHeaders : nullptr, blob, &locationCode);
+          found = content || (blob && !blob->empty()) || locationCode == 304;
+          if (responseCode) {
+            *responseCode = locationCode;
+          }
+          if (found) {
+            // the headers of the CCDB server (validity, ETag, ...) take precedence over the ones of the storage
+            if (headers) {
+              headers->insert(locationHeaders.begin(), locationHeaders.end());
+            }
             break;
           }
         }
       }
+      errorflag = !found;
     } else if (response_code == 404) {
       LOG(ERROR) << "Requested resource does not exist: " << url;
       errorflag = true;
@@ -981,6 +1040,10 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
 
   // normal mode follows
 
+  if (mDiskCache && !mInSnapshotMode) {
+    return retrieveThroughDiskCache(tinfo, path, metadata, timestamp, headers, etag, createdNotAfter, createdNotBefore);
+  }
+
   CURL* curl_handle = curl_easy_init();
   string fullUrl = getFullUrlForRetrieval(curl_handle, path, metadata, timestamp);
   // if we are in snapshot mode we can simply open the file; extract the object and return
@@ -1009,6 +1072,69 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
   return content;
 }
 
+void CcdbApi::setDiskCache(std::string const& dir, long revalidateAfter)
+{
+  LOG(INFO) << "Caching CCDB objects in " << dir;
+  mDiskCache = std::make_unique<CCDBDiskCache>(dir, revalidateAfter);
+}
+
+void* CcdbApi::retrieveThroughDiskCache(std::type_info const& tinfo, std::string const& path,
+                                        std::map<std::string, std::string> const& metadata, long timestamp,
+                                        std::map<std::string, std::string>* headers, std::string const& etag,
+                                        const std::string& createdNotAfter, const std::string& createdNotBefore) const
+{
+  auto fetch = [&](std::string const& cachedEtag) {
+    // Only an explicit 304 from the last server asked means that the cached
+    // object is still valid, any other answer without content is a failure
+    CCDBDiskCache::FetchResult result;
+    CURL* curl_handle = curl_easy_init();
+    string fullUrl = getFullUrlForRetrieval(curl_handle, path, metadata, timestamp);
+    struct curl_slist* list = nullptr;
+    if (!cachedEtag.empty()) {
+      list = curl_slist_append(list, ("If-None-Match: " + cachedEtag).c_str());
+    } else {
+      list = curl_slist_append(list, ("If-None-Match: " + to_string(timestamp)).c_str());
+    }
+    if (!createdNotAfter.empty()) {
+      list = curl_slist_append(list, ("If-Not-After: " + createdNotAfter).c_str());
+    }
+    if (!createdNotBefore.empty()) {
+      list = curl_slist_append(list, ("If-Not-Before: " + createdNotBefore).c_str());
+    }
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, list);
+    long responseCode = -1;
+    navigateURLsAndRetrieveContent(curl_handle, fullUrl, tinfo, &result.headers, &result.content, &responseCode);
+    curl_easy_cleanup(curl_handle);
+    curl_slist_free_all(list);
+    if (200 <= responseCode && responseCode < 300 && !result.content.empty()) {
+      result.status = CCDBDiskCache::FetchResult::Downloaded;
+    } else if (responseCode == 304 && !cachedEtag.empty()) {
+      result.status = CCDBDiskCache::FetchResult::NotModified;
+    }
+    return result;
+  };
+
+  std::vector<char> content;
+  CCDBDiskCache::Headers cachedHeaders;
+  auto found = mDiskCache->get(CCDBDiskCache::makeKey(path, metadata, createdNotAfter, createdNotBefore), timestamp, fetch, content, cachedHeaders);
+  if (headers) {
+    for (auto& [name, value] : cachedHeaders) {
+      (*headers)[name] = value;
+    }
+  }
+  if (!found) {
+    if (headers) {
+      (*headers)["Error"] = "An error occurred during retrieval";
+    }
+    return nullptr;
+  }
+  // The caller already holds this very object
+  if (!etag.empty() && cachedHeaders["ETag"] == etag) {
+    return nullptr;
+  }
+  return interpretAsTMemFileAndExtract(content.data(), content.size(), tinfo);
+}
+
 size_t CurlWrite_CallbackFunc_StdString2(void* contents, size_t size, size_t nmemb, std::string* s)
 {
   size_t newLength = size * nmemb;
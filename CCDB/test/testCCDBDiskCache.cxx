@@ -0,0 +1,265 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCCDBDiskCache.cxx
+/// \brief  Test the persistent CCDB cache against a local stand-in of the server
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CCDBDiskCache.h"
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace o2::ccdb;
+
+namespace
+{
+/// Serves a single object from a local directory, the way the CCDB would.
+struct LocalServer {
+  LocalServer(std::string const& dir) : dir{dir}
+  {
+    std::filesystem::create_directories(dir);
+  }
+
+  void publish(std::string const& content, std::string const& etag, long from, long until)
+  {
+    std::ofstream(dir + "/object") << content;
+    std::ofstream(dir + "/headers") << etag << " " << from << " " << until;
+  }
+
+  CCDBDiskCache::FetchResult fetch(std::string const& cachedEtag)
+  {
+    requests++;
+    CCDBDiskCache::FetchResult result;
+    if (down) {
+      result.headers["Error"] = "An error occurred during retrieval";
+      return result;
+    }
+    std::string etag;
+    long from, until;
+    std::ifstream(dir + "/headers") >> etag >> from >> until;
+    result.headers = {{"ETag", etag}, {"Valid-From", std::to_string(from)}, {"Valid-Until", std::to_string(until)}};
+    if (etag == cachedEtag) {
+      result.status = CCDBDiskCache::FetchResult::NotModified;
+      return result;
+    }
+    std::ifstream in(dir + "/object", std::ios::binary);
+    result.content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    result.status = CCDBDiskCache::FetchResult::Downloaded;
+    downloads++;
+    return result;
+  }
+
+  CCDBDiskCache::Fetcher fetcher()
+  {
+    return [this](std::string const& etag) { return fetch(etag); };
+  }
+
+  std::string dir;
+  bool down = false;
+  std::atomic<int> requests = 0;
+  std::atomic<int> downloads = 0;
+};
+
+struct TmpDir {
+  TmpDir()
+  {
+    path = (std::filesystem::temp_directory_path() / ("ccdbdiskcache_" + std::to_string(getpid()))).string();
+    std::filesystem::remove_all(path);
+  }
+  ~TmpDir() { std::filesystem::remove_all(path); }
+  std::string path;
+};
+
+std::string asString(std::vector<char> const& content)
+{
+  return std::string(content.begin(), content.end());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestRevalidation)
+{
+  TmpDir tmp;
+  LocalServer server(tmp.path + "/server");
+  server.publish("first", "\"uuid-1\"", 1000, 2000);
+  auto key = CCDBDiskCache::makeKey("Test/DiskCache", {});
+
+  std::vector<char> content;
+  CCDBDiskCache::Headers headers;
+  {
+    CCDBDiskCache cache(tmp.path + "/cache");
+    BOOST_CHECK(cache.get(key, 1500, server.fetcher(), content, headers));
+    BOOST_CHECK_EQUAL(asString(content), "first");
+    BOOST_CHECK_EQUAL(headers["ETag"], "\"uuid-1\"");
+    BOOST_CHECK_EQUAL(cache.getStats().downloads, 1);
+  }
+
+  // A new instance (i.e. another process) only revalidates what is on disk.
+  CCDBDiskCache cache(tmp.path + "/cache");
+  BOOST_CHECK(cache.get(key, 1200, server.fetcher(), content, headers));
+  BOOST_CHECK_EQUAL(asString(content), "first");
+  BOOST_CHECK_EQUAL(headers["Valid-Until"], "2000");
+  BOOST_CHECK_EQUAL(cache.getStats().revalidations, 1);
+  BOOST_CHECK_EQUAL(server.downloads, 1);
+
+  // A new version of the object is picked up by the conditional request.
+  server.publish("second", "\"uuid-2\"", 1000, 3000);
+  BOOST_CHECK(cache.get(key, 1500, server.fetcher(), content, headers));
+  BOOST_CHECK_EQUAL(asString(content), "second");
+  BOOST_CHECK_EQUAL(server.downloads, 2);
+  BOOST_REQUIRE(cache.lookup(key, 2500).has_value());
+  BOOST_CHECK_EQUAL(cache.lookup(key, 2500)->headers["ETag"], "\"uuid-2\"");
+  BOOST_CHECK(cache.lookup(key, 3500).has_value() == false);
+
+  // Nothing covers this timestamp: unconditional request.
+  server.publish("third", "\"uuid-3\"", 3000, 4000);
+  BOOST_CHECK(cache.get(key, 3500, server.fetcher(), content, headers));
+  BOOST_CHECK_EQUAL(asString(content), "third");
+  BOOST_CHECK_EQUAL(server.downloads, 3);
+}
+
+BOOST_AUTO_TEST_CASE(TestOfflineAndFreshness)
+{
+  TmpDir tmp;
+  LocalServer server(tmp.path + "/server");
+  server.publish("payload", "\"uuid-1\"", 0, 1000);
+  auto key = CCDBDiskCache::makeKey("Test/DiskCache", {{"key", "value"}});
+
+  std::vector<char> content;
+  CCDBDiskCache::Headers headers;
+  CCDBDiskCache cache(tmp.path + "/cache", 60000);
+  BOOST_CHECK(cache.get(key, 10, server.fetcher(), content, headers));
+  // Within the revalidation interval the server is not contacted at all
+  BOOST_CHECK(cache.get(key, 20, server.fetcher(), content, headers));
+  BOOST_CHECK_EQUAL(server.requests, 1);
+  BOOST_CHECK_EQUAL(cache.getStats().fresh, 1);
+
+  // When the server is down the cached object is still served
+  cache.setRevalidateAfter(0);
+  server.down = true;
+  BOOST_CHECK(cache.get(key, 30, server.fetcher(), content, headers));
+  BOOST_CHECK_EQUAL(asString(content), "payload");
+  BOOST_CHECK_EQUAL(cache.getStats().stale, 1);
+  // ... but not for what was never cached
+  BOOST_CHECK(cache.get(key, 2000, server.fetcher(), content, headers) == false);
+  BOOST_CHECK_EQUAL(headers.count("Error"), 1);
+  BOOST_CHECK_EQUAL(cache.getStats().misses, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestConcurrentStartup)
+{
+  TmpDir tmp;
+  LocalServer server(tmp.path + "/server");
+  server.publish("shared", "\"uuid-1\"", 0, 1000);
+  auto key = CCDBDiskCache::makeKey("Test/DiskCache", {});
+  auto slowFetch = [&server](std::string const& etag) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return server.fetch(etag);
+  };
+
+  std::atomic<int> served = 0;
+  std::vector<std::thread> clients;
+  for (int i = 0; i < 8; ++i) {
+    clients.emplace_back([&]() {
+      CCDBDiskCache cache(tmp.path + "/cache");
+      std::vector<char> content;
+      CCDBDiskCache::Headers headers;
+      if (cache.get(key, 500, slowFetch, content, headers) && asString(content) == "shared") {
+        served++;
+      }
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  BOOST_CHECK_EQUAL(served, 8);
+  BOOST_CHECK_EQUAL(server.downloads, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestFailedRevalidation)
+{
+  TmpDir tmp;
+  LocalServer server(tmp.path + "/server");
+  server.publish("payload", "\"uuid-1\"", 0, 1000);
+  auto key = CCDBDiskCache::makeKey("Test/DiskCache", {});
+
+  std::vector<char> content;
+  CCDBDiskCache::Headers headers;
+  CCDBDiskCache cache(tmp.path + "/cache");
+  BOOST_CHECK(cache.get(key, 10, server.fetcher(), content, headers));
+  auto checked = cache.lookup(key, 10)->checked;
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  // Neither an empty download nor a failure confirms the cached entry
+  auto emptyDownload = [](std::string const&) {
+    CCDBDiskCache::FetchResult result;
+    result.status = CCDBDiskCache::FetchResult::Downloaded;
+    return result;
+  };
+  BOOST_CHECK(cache.get(key, 10, emptyDownload, content, headers));
+  BOOST_CHECK_EQUAL(asString(content), "payload");
+  server.down = true;
+  BOOST_CHECK(cache.get(key, 10, server.fetcher(), content, headers));
+  BOOST_CHECK_EQUAL(asString(content), "payload");
+  BOOST_CHECK_EQUAL(cache.getStats().stale, 2);
+  BOOST_CHECK_EQUAL(cache.getStats().revalidations, 0);
+  BOOST_CHECK_EQUAL(cache.lookup(key, 10)->checked, checked);
+
+  // "Not modified" without a cached object to confirm is a miss
+  auto notModified = [](std::string const&) {
+    CCDBDiskCache::FetchResult result;
+    result.status = CCDBDiskCache::FetchResult::NotModified;
+    return result;
+  };
+  BOOST_CHECK(cache.get(key, 2000, notModified, content, headers) == false);
+  BOOST_CHECK_EQUAL(cache.getStats().misses, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestSharedInstance)
+{
+  TmpDir tmp;
+  LocalServer server(tmp.path + "/server");
+  server.publish("shared", "\"uuid-1\"", 0, 1000);
+  auto key = CCDBDiskCache::makeKey("Test/DiskCache", {});
+
+  // All the threads of a process use the same cache
+  CCDBDiskCache cache(tmp.path + "/cache");
+  std::atomic<int> served = 0;
+  std::vector<std::thread> clients;
+  for (int i = 0; i < 8; ++i) {
+    clients.emplace_back([&]() {
+      for (int j = 0; j < 10; ++j) {
+        std::vector<char> content;
+        CCDBDiskCache::Headers headers;
+        if (cache.get(key, 500, server.fetcher(), content, headers) && asString(content) == "shared") {
+          served++;
+        }
+      }
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  BOOST_CHECK_EQUAL(served, 80);
+  BOOST_CHECK_EQUAL(server.downloads, 1);
+  auto stats = cache.getStats();
+  BOOST_CHECK_EQUAL(stats.downloads, 1);
+  BOOST_CHECK_EQUAL(stats.revalidations, 79);
+}
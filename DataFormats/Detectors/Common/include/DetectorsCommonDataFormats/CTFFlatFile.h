@@ -0,0 +1,146 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.h
+/// \brief Flat (non-ROOT) CTF file format, read via mmap w/o deserialization
+
+#ifndef ALICEO2_CTF_FLATFILE_H
+#define ALICEO2_CTF_FLATFILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+/// Layout of the flat CTF file, all offsets and sizes in bytes, every object starts at an offset aligned to
+/// o2::ctf::Alignment, so that the detector images (flat EncodedBlocks buffers) can be used directly from the
+/// memory mapped file with CTF::getImage:
+/// FileHeader | TF record | TF record ...
+/// TF record: RecordHeader | DetEntry[nDetectors] | detector image | detector image ...
+struct CTFFlatFileFormat {
+  static constexpr char Magic[8] = {'O', '2', 'C', 'T', 'F', 'F', 'L', 'T'};
+  static constexpr uint32_t Version = 1;
+  static constexpr std::string_view FileExtension = ".ctf";
+
+  struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+  };
+
+  struct RecordHeader {
+    uint64_t recordSize;    // full size of the record, including this header
+    uint64_t run;           // CTFHeader::run
+    uint64_t detectors;     // CTFHeader::detectors
+    uint32_t firstTForbit;  // CTFHeader::firstTForbit
+    uint32_t nDetectors;    // number of DetEntry following the header
+  };
+
+  struct DetEntry {
+    uint32_t detID;
+    uint32_t reserved;
+    uint64_t offset; // wrt the record start
+    uint64_t size;
+  };
+};
+
+/// Writes CTFs to a flat file, TF by TF
+class CTFFlatFileWriter
+{
+ public:
+  CTFFlatFileWriter() = default;
+  ~CTFFlatFileWriter();
+
+  /// open new file (closing the previous one, if any) and write the file header
+  void open(const std::string& fileName);
+  /// close the file, throws if the buffered data could not be written
+  void close();
+  bool isOpen() const { return mFile != nullptr; }
+
+  /// start new TF record
+  void beginTF();
+  /// add flat EncodedBlocks image of the detector to the current TF (the data are copied)
+  void addDetector(o2::detectors::DetID det, const void* data, size_t size);
+  /// write current TF record with provided header, return its size
+  size_t endTF(const CTFHeader& header);
+
+  size_t getNTFs() const { return mNTFs; }
+  size_t getFileSize() const { return mFileSize; }
+
+ private:
+  FILE* mFile = nullptr;
+  std::string mFileName{};
+  std::vector<CTFFlatFileFormat::DetEntry> mEntries{};
+  std::vector<char> mPayload{};
+  size_t mNTFs = 0;
+  size_t mFileSize = 0;
+};
+
+/// Read-only access to the flat CTF file mapped to memory. The detector images are returned as pointers to the
+/// mapped pages, i.e. no copy and no deserialization is involved, they stay valid until the reader is destroyed.
+class CTFFlatFileReader
+{
+ public:
+  struct Image {
+    const void* data = nullptr;
+    size_t size = 0;
+    bool empty() const { return size == 0; }
+  };
+
+  CTFFlatFileReader() = default;
+  explicit CTFFlatFileReader(const std::string& fileName) { open(fileName); }
+  ~CTFFlatFileReader() { close(); }
+  CTFFlatFileReader(const CTFFlatFileReader&) = delete;
+  CTFFlatFileReader& operator=(const CTFFlatFileReader&) = delete;
+
+  /// check if the file starts with flat CTF file header
+  static bool isFlatFile(const std::string& fileName);
+
+  /// map the file and build the index of TF records, throws on invalid file or corrupted TF record.
+  /// A truncated last record is ignored.
+  void open(const std::string& fileName);
+  void close();
+  bool isOpen() const { return mBase != nullptr; }
+
+  size_t getNTFs() const { return mRecords.size(); }
+  CTFHeader getHeader(size_t tf) const;
+
+  /// flat image of the detector in given TF, empty if not present. To be used as CTF::getImage(image.data)
+  Image getDetectorImage(size_t tf, o2::detectors::DetID det) const;
+
+  /// hint the kernel to start reading given TF record
+  void prefetch(size_t tf) const;
+
+  const std::string& getFileName() const { return mFileName; }
+
+ private:
+  const CTFFlatFileFormat::RecordHeader* getRecord(size_t tf) const;
+  /// check that the detector table and the images of the record, whose size was validated, lie within it
+  static bool checkRecord(const CTFFlatFileFormat::RecordHeader& record);
+
+  std::string mFileName{};
+  const char* mBase = nullptr;
+  size_t mSize = 0;
+  std::vector<size_t> mRecords{}; // offsets of TF records
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
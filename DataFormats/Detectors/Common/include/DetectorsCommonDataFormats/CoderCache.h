@@ -0,0 +1,167 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CoderCache.h
+/// \brief Per-slot cache of the entropy coders built from the data of previous TFs
+
+#ifndef ALICEO2_CTF_CODERCACHE_H
+#define ALICEO2_CTF_CODERCACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "rANS/rans.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+/// Cache of the rANS coders used when no external dictionary is provided, one entry per block slot.
+/// An encoder built for a message is reused for the following messages of the same slot as long as their statistics
+/// did not drift away: the symbol range must be covered by the cached frequency table and the extra cost of encoding
+/// with the cached table (Kullback-Leibler divergence, in bits per symbol) must stay below a threshold. Otherwise only
+/// the encoder of this slot is rebuilt from the current message.
+/// A decoder is reused as long as the dictionary stored in the block is identical to the one it was built from.
+/// Different slots may be accessed concurrently.
+class CoderCache
+{
+ public:
+  using count_t = o2::rans::FrequencyTable::count_t;
+
+  CoderCache(int nSlots, double maxDrift = 0.05) : mEncoders(nSlots), mDecoders(nSlots), mMaxDrift(maxDrift) {}
+
+  template <typename source_T>
+  using encoder_t = o2::rans::LiteralEncoder64<source_T>;
+  template <typename dest_T>
+  using decoder_t = o2::rans::LiteralDecoder64<dest_T>;
+
+  /// encoder for the message with provided frequencies, together with the frequency table it was built from
+  /// (to be stored as the dictionary of the block)
+  template <typename source_T>
+  std::pair<const encoder_t<source_T>*, const o2::rans::FrequencyTable*> getEncoder(int slot, const o2::rans::FrequencyTable& frequencies, uint8_t probabilityBits);
+
+  /// decoder for the block with provided dictionary
+  template <typename dest_T>
+  const decoder_t<dest_T>* getDecoder(int slot, const count_t* dict, int nDict, int32_t min, int32_t max, uint8_t probabilityBits);
+
+  void setMaxDrift(double v) { mMaxDrift = v; }
+  double getMaxDrift() const { return mMaxDrift; }
+
+  size_t getNEncoderBuilds() const { return mNEncoderBuilds; }
+  size_t getNDecoderBuilds() const { return mNDecoderBuilds; }
+
+  void clear()
+  {
+    for (auto& e : mEncoders) {
+      e = EncoderEntry{};
+    }
+    for (auto& d : mDecoders) {
+      d = DecoderEntry{};
+    }
+  }
+
+  /// extra cost in bits per symbol of encoding a message with statistics "current" using the model "reference",
+  /// symbols not covered by the reference are accounted as literals of literalBits
+  static double getDrift(const o2::rans::FrequencyTable& reference, const o2::rans::FrequencyTable& current, size_t literalBits);
+
+ private:
+  struct EncoderEntry {
+    std::shared_ptr<void> encoder{};
+    o2::rans::FrequencyTable frequencies{};
+    uint8_t probabilityBits = 0;
+  };
+
+  struct DecoderEntry {
+    std::shared_ptr<void> decoder{};
+    std::vector<count_t> dict{};
+    int32_t min = 0;
+    int32_t max = 0;
+    uint8_t probabilityBits = 0;
+  };
+
+  std::vector<EncoderEntry> mEncoders;
+  std::vector<DecoderEntry> mDecoders;
+  double mMaxDrift = 0.05;
+  std::atomic<size_t> mNEncoderBuilds{0};
+  std::atomic<size_t> mNDecoderBuilds{0};
+};
+
+///_____________________________________________________________________________
+inline double CoderCache::getDrift(const o2::rans::FrequencyTable& reference, const o2::rans::FrequencyTable& current, size_t literalBits)
+{
+  const double nCurrent = current.getNumSamples();
+  const double nReference = reference.getNumSamples();
+  if (nCurrent == 0) {
+    return 0.;
+  }
+  if (nReference == 0) {
+    return literalBits;
+  }
+  double drift = 0.;
+  const auto refMin = reference.getMinSymbol(), refMax = reference.getMaxSymbol();
+  auto symbol = current.getMinSymbol();
+  for (auto count : current) {
+    if (count) {
+      const auto refCount = (symbol >= refMin && symbol <= refMax) ? reference[symbol] : 0;
+      const double p = count / nCurrent;
+      drift += refCount ? p * std::log2(p * nReference / refCount) : p * literalBits;
+    }
+    ++symbol;
+  }
+  return drift;
+}
+
+///_____________________________________________________________________________
+template <typename source_T>
+std::pair<const CoderCache::encoder_t<source_T>*, const o2::rans::FrequencyTable*> CoderCache::getEncoder(int slot, const o2::rans::FrequencyTable& frequencies, uint8_t probabilityBits)
+{
+  assert(slot < int(mEncoders.size()));
+  auto& entry = mEncoders[slot];
+  const bool reuse = entry.encoder && entry.probabilityBits == probabilityBits &&
+                     getDrift(entry.frequencies, frequencies, sizeof(source_T) * 8) < mMaxDrift;
+  if (!reuse) {
+    entry.frequencies = frequencies;
+    entry.probabilityBits = probabilityBits;
+    entry.encoder = std::make_shared<encoder_t<source_T>>(entry.frequencies, probabilityBits);
+    mNEncoderBuilds++;
+  }
+  return {static_cast<const encoder_t<source_T>*>(entry.encoder.get()), &entry.frequencies};
+}
+
+///_____________________________________________________________________________
+template <typename dest_T>
+const CoderCache::decoder_t<dest_T>* CoderCache::getDecoder(int slot, const count_t* dict, int nDict, int32_t min, int32_t max, uint8_t probabilityBits)
+{
+  assert(slot < int(mDecoders.size()));
+  auto& entry = mDecoders[slot];
+  const bool reuse = entry.decoder && entry.min == min && entry.max == max && entry.probabilityBits == probabilityBits &&
+                     entry.dict.size() == size_t(nDict) && std::equal(dict, dict + nDict, entry.dict.begin());
+  if (!reuse) {
+    o2::rans::FrequencyTable frequencies;
+    frequencies.addFrequencies(dict, dict + nDict, min, max);
+    entry.dict.assign(dict, dict + nDict);
+    entry.min = min;
+    entry.max = max;
+    entry.probabilityBits = probabilityBits;
+    entry.decoder = std::make_shared<decoder_t<dest_T>>(frequencies, probabilityBits);
+    mNDecoderBuilds++;
+  }
+  return static_cast<const decoder_t<dest_T>*>(entry.decoder.get());
+}
+
+} // namespace ctf
+} // namespace o2
+
+#endif
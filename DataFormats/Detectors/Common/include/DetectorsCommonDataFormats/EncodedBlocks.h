@@ -19,6 +19,7 @@
 #undef NDEBUG
 #include <cassert>
 #include <type_traits>
+#include <vector>
 #include <Rtypes.h>
 #include "rANS/rans.h"
 #include "rANS/utils.h"
@@ -26,6 +27,7 @@
 #include "CommonUtils/StringUtils.h"
 #include "Framework/Logger.h"
 #include "DetectorsCommonDataFormats/CTFDictHeader.h"
+#include "DetectorsCommonDataFormats/CoderCache.h"
 
 namespace o2
 {
@@ -93,10 +95,21 @@ inline size_t calculatePaddedSize(size_t nElems) noexcept
 ///>>======================== Auxiliary classes =======================>>
 
 struct ANSHeader {
+  // majorVersion 0: classic coder with 2 interleaved rANS states
+  // majorVersion 1: N-stream interleaved coder, minorVersion holds the number of streams N (4, 8 or 16)
+  static constexpr uint8_t InterleavedVersion = 1;
+
   uint8_t majorVersion;
   uint8_t minorVersion;
 
   void clear() { majorVersion = minorVersion = 0; }
+  void setInterleaved(uint8_t nStreams)
+  {
+    majorVersion = InterleavedVersion;
+    minorVersion = nStreams;
+  }
+  // number of streams of the interleaved coder, 0 for the classic one
+  size_t getNInterleavedStreams() const { return majorVersion == InterleavedVersion ? minorVersion : 0; }
   ClassDefNV(ANSHeader, 1);
 };
 
@@ -326,6 +339,17 @@ struct Block {
   ClassDefNV(Block, 1);
 }; // namespace ctf
 
+/// image of a single encoded slot living outside of the flat buffer: filled by EncodedBlocks::encodeToScratch,
+/// which does not modify the container, so that different slots can be encoded concurrently, and moved to the
+/// flat buffer by EncodedBlocks::storeEncodedSlot
+template <typename W = uint32_t>
+struct EncodedSlot {
+  Metadata metadata{};
+  std::vector<W> dict{};
+  std::vector<W> data{};
+  std::vector<W> literals{};
+};
+
 ///<<======================== Auxiliary classes =======================<<
 
 template <typename H, int N, typename W = uint32_t>
@@ -419,22 +443,37 @@ class EncodedBlocks
 
   /// encode vector src to bloc at provided slot
   template <typename VE, typename buffer_T>
-  inline void encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f)
+  inline void encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f, CoderCache* cache = nullptr)
   {
-    encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc);
+    encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc, cache);
   }
 
   /// encode vector src to bloc at provided slot
   template <typename input_IT, typename buffer_T>
-  void encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f);
+  void encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f, CoderCache* cache = nullptr);
+
+  /// encode vector src to standalone image of a slot, the container is not modified (safe to call concurrently for different slots)
+  template <typename VE>
+  inline void encodeToScratch(const VE& src, int slot, EncodedSlot<W>& dest, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f, CoderCache* cache = nullptr) const
+  {
+    encodeToScratch(std::begin(src), std::end(src), slot, dest, symbolTablePrecision, opt, encoderExt, memfc, cache);
+  }
+
+  /// encode source message to standalone image of a slot, the container is not modified (safe to call concurrently for different slots)
+  template <typename input_IT>
+  void encodeToScratch(const input_IT srcBegin, const input_IT srcEnd, int slot, EncodedSlot<W>& dest, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f, CoderCache* cache = nullptr) const;
+
+  /// store image produced by encodeToScratch at provided slot, slots must be stored in order as with encode
+  template <typename buffer_T>
+  void storeEncodedSlot(const EncodedSlot<W>& src, int slot, buffer_T* buffer = nullptr);
 
   /// decode block at provided slot to destination vector (will be resized as needed)
   template <class container_T, class container_IT = typename container_T::iterator>
-  void decode(container_T& dest, int slot, const void* decoderExt = nullptr) const;
+  void decode(container_T& dest, int slot, const void* decoderExt = nullptr, CoderCache* cache = nullptr) const;
 
   /// decode block at provided slot to destination pointer, the needed space assumed to be available
   template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
-  void decode(D_IT dest, int slot, const void* decoderExt = nullptr) const;
+  void decode(D_IT dest, int slot, const void* decoderExt = nullptr, CoderCache* cache = nullptr) const;
 
   /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
   static std::vector<char> createDictionaryBlocks(const std::vector<o2::rans::FrequencyTable>& vfreq, const std::vector<Metadata>& prbits);
@@ -723,10 +762,11 @@ template <typename H, int N, typename W>
 template <class container_T, class container_IT>
 inline void EncodedBlocks<H, N, W>::decode(container_T& dest,            // destination container
                                            int slot,                     // slot of the block to decode
-                                           const void* decoderExt) const // optional externally provided decoder
+                                           const void* decoderExt,       // optional externally provided decoder
+                                           CoderCache* cache) const      // optional cache of decoders built from stored dictionaries
 {
   dest.resize(mMetadata[slot].messageLength); // allocate output buffer
-  decode(std::begin(dest), slot, decoderExt);
+  decode(std::begin(dest), slot, decoderExt, cache);
 }
 
 ///_____________________________________________________________________________
@@ -734,7 +774,8 @@ template <typename H, int N, typename W>
 template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool>>
 void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to destination
                                     int slot,                     // slot of the block to decode
-                                    const void* decoderExt) const // optional externally provided decoder
+                                    const void* decoderExt,       // optional externally provided decoder
+                                    CoderCache* cache) const      // optional cache of decoders built from stored dictionaries
 {
   // get references to the right data
   const auto& block = mBlocks[slot];
@@ -751,7 +792,9 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
       }
       const o2::rans::LiteralDecoder64<dest_t>* decoder = reinterpret_cast<const o2::rans::LiteralDecoder64<dest_t>*>(decoderExt);
       std::unique_ptr<o2::rans::LiteralDecoder64<dest_t>> decoderLoc;
-      if (block.getNDict()) { // if dictionaty is saved, prefer it
+      if (block.getNDict() && cache) { // if dictionaty is saved, prefer it
+        decoder = cache->template getDecoder<dest_t>(slot, block.getDict(), block.getNDict(), md.min, md.max, md.probabilityBits);
+      } else if (block.getNDict()) {
         o2::rans::FrequencyTable frequencies;
         frequencies.addFrequencies(block.getDict(), block.getDict() + block.getNDict(), md.min, md.max);
         decoderLoc = std::make_unique<o2::rans::LiteralDecoder64<dest_t>>(frequencies, md.probabilityBits);
@@ -771,7 +814,24 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
         // to D-word array
         literals = std::vector<dest_t>{reinterpret_cast<const dest_t*>(block.getLiterals()), reinterpret_cast<const dest_t*>(block.getLiterals()) + md.nLiterals};
       }
-      decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      const auto* const encodedEnd = block.getData() + block.getNData();
+      switch (mANSHeader.getNInterleavedStreams()) {
+        case 0:
+          decoder->process(encodedEnd, dest, md.messageLength, literals);
+          break;
+        case 4:
+          decoder->template processInterleaved<4>(encodedEnd, dest, md.messageLength, literals);
+          break;
+        case 8:
+          decoder->template processInterleaved<8>(encodedEnd, dest, md.messageLength, literals);
+          break;
+        case 16:
+          decoder->template processInterleaved<16>(encodedEnd, dest, md.messageLength, literals);
+          break;
+        default:
+          LOG(ERROR) << "Unsupported ANS version " << int(mANSHeader.majorVersion) << "." << int(mANSHeader.minorVersion) << " for slot " << slot;
+          throw std::runtime_error("Unsupported ANS version");
+      }
     } else { // data was stored as is
       using destPtr_t = typename std::iterator_traits<D_IT>::pointer;
       destPtr_t srcBegin = reinterpret_cast<destPtr_t>(block.payload);
@@ -792,7 +852,8 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
                                     Metadata::OptStore opt,       // option for data compression
                                     buffer_T* buffer,             // optional buffer (vector) providing memory for encoded blocks
                                     const void* encoderExt,       // optional external encoder
-                                    float memfc)                  // memory allocation margin factor
+                                    float memfc,                  // memory allocation margin factor
+                                    CoderCache* cache)            // optional cache of encoders built from the data
 {
 
   using storageBuffer_t = W;
@@ -805,6 +866,9 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
   static_assert(std::is_same_v<storageBuffer_t, ransStream_t>);
   static_assert(std::is_same_v<storageBuffer_t, typename rans::FrequencyTable::count_t>);
 
+  // coder is selected by the ANS header, read it before "this" might get invalidated by a storage expansion
+  const size_t nInterleavedStreams = mANSHeader.getNInterleavedStreams();
+
   // fill a new block
   assert(slot == mRegistry.nFilledBlocks);
   mRegistry.nFilledBlocks++;
@@ -846,16 +910,21 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
     constexpr size_t SizeEstMarginAbs = 10 * 1024;
     const float SizeEstMarginRel = 1.5 * memfc;
 
-    const auto [inplaceEncoder, frequencyTable] = [&]() {
-      if (encoderExt) {
-        return std::make_tuple(ransEncoder_t{}, rans::FrequencyTable{});
+    // external encoder (no dictionary to store), cached one or one built from the message
+    rans::FrequencyTable messageFrequencies{};
+    const rans::FrequencyTable* dictionary = &messageFrequencies;
+    std::unique_ptr<ransEncoder_t> inplaceEncoder;
+    ransEncoder_t const* encoder = reinterpret_cast<ransEncoder_t const*>(encoderExt);
+    if (!encoder) {
+      messageFrequencies.addSamples(srcBegin, srcEnd);
+      if (cache) {
+        std::tie(encoder, dictionary) = cache->template getEncoder<input_t>(slot, messageFrequencies, symbolTablePrecision);
       } else {
-        rans::FrequencyTable frequencyTable{};
-        frequencyTable.addSamples(srcBegin, srcEnd);
-        return std::make_tuple(ransEncoder_t{frequencyTable, symbolTablePrecision}, frequencyTable);
+        inplaceEncoder = std::make_unique<ransEncoder_t>(messageFrequencies, symbolTablePrecision);
+        encoder = inplaceEncoder.get();
       }
-    }();
-    ransEncoder_t const* const encoder = encoderExt ? reinterpret_cast<ransEncoder_t const* const>(encoderExt) : &inplaceEncoder;
+    }
+    const rans::FrequencyTable& frequencyTable = *dictionary;
 
     // estimate size of encode buffer
     int dataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(input_t)); // size in bytes
@@ -872,7 +941,20 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
     // directly encode source message into block buffer.
     storageBuffer_t* const blockBufferBegin = thisBlock->getCreateData();
     const size_t maxBufferSize = thisBlock->registry->getFreeSize(); // note: "this" might be not valid after expandStorage call!!!
-    const auto encodedMessageEnd = encoder->process(srcBegin, srcEnd, blockBufferBegin, literals);
+    const auto encodedMessageEnd = [&]() {
+      switch (nInterleavedStreams) {
+        case 0:
+          return encoder->process(srcBegin, srcEnd, blockBufferBegin, literals);
+        case 4:
+          return encoder->template processInterleaved<4>(srcBegin, srcEnd, blockBufferBegin, literals);
+        case 8:
+          return encoder->template processInterleaved<8>(srcBegin, srcEnd, blockBufferBegin, literals);
+        case 16:
+          return encoder->template processInterleaved<16>(srcBegin, srcEnd, blockBufferBegin, literals);
+        default:
+          throw std::runtime_error("Unsupported number of interleaved rANS streams");
+      }
+    }();
     rans::utils::checkBounds(encodedMessageEnd, blockBufferBegin + maxBufferSize / sizeof(W));
     dataSize = encodedMessageEnd - thisBlock->getDataPointer();
     thisBlock->setNData(dataSize);
@@ -926,6 +1008,146 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
   }
 }
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename input_IT>
+void EncodedBlocks<H, N, W>::encodeToScratch(const input_IT srcBegin,      // iterator begin of source message
+                                             const input_IT srcEnd,        // iterator end of source message
+                                             int slot,                     // slot the image is made for
+                                             EncodedSlot<W>& dest,         // image of the slot to fill
+                                             uint8_t symbolTablePrecision, // encoding into
+                                             Metadata::OptStore opt,       // option for data compression
+                                             const void* encoderExt,       // optional external encoder
+                                             float memfc,                  // memory allocation margin factor
+                                             CoderCache* cache) const      // optional cache of encoders built from the data
+{
+  using storageBuffer_t = W;
+  using input_t = typename std::iterator_traits<input_IT>::value_type;
+  using ransEncoder_t = typename rans::LiteralEncoder64<input_t>;
+  using ransState_t = typename ransEncoder_t::coder_t;
+  using ransStream_t = typename ransEncoder_t::stream_t;
+
+  static_assert(std::is_same_v<storageBuffer_t, ransStream_t>);
+  static_assert(std::is_same_v<storageBuffer_t, typename rans::FrequencyTable::count_t>);
+
+  dest.dict.clear();
+  dest.data.clear();
+  dest.literals.clear();
+
+  const size_t messageLength = std::distance(srcBegin, srcEnd);
+  if (messageLength == 0) {
+    dest.metadata = Metadata{0, 0, sizeof(ransState_t), sizeof(ransStream_t), symbolTablePrecision, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
+    return;
+  }
+
+  if (opt == Metadata::OptStore::EENCODE) {
+    // external encoder (no dictionary to store), cached one or one built from the message
+    rans::FrequencyTable messageFrequencies{};
+    const rans::FrequencyTable* dictionary = &messageFrequencies;
+    std::unique_ptr<ransEncoder_t> inplaceEncoder;
+    ransEncoder_t const* encoder = reinterpret_cast<ransEncoder_t const*>(encoderExt);
+    if (!encoder) {
+      messageFrequencies.addSamples(srcBegin, srcEnd);
+      if (cache) {
+        std::tie(encoder, dictionary) = cache->template getEncoder<input_t>(slot, messageFrequencies, symbolTablePrecision);
+      } else {
+        inplaceEncoder = std::make_unique<ransEncoder_t>(messageFrequencies, symbolTablePrecision);
+        encoder = inplaceEncoder.get();
+      }
+    }
+    const rans::FrequencyTable& frequencyTable = *dictionary;
+
+    if (frequencyTable.size()) {
+      dest.dict.assign(frequencyTable.data(), frequencyTable.data() + frequencyTable.size());
+    }
+    // same margins as for the encoding directly to the flat buffer
+    constexpr size_t SizeEstMarginAbs = 10 * 1024;
+    const float SizeEstMarginRel = 1.5 * memfc;
+    const size_t maxDataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(input_t)); // size in bytes
+    dest.data.resize(SizeEstMarginAbs + size_t(SizeEstMarginRel * (maxDataSize / sizeof(storageBuffer_t))) + (sizeof(input_t) < sizeof(storageBuffer_t)));
+
+    std::vector<input_t> literals;
+    storageBuffer_t* const dataBegin = dest.data.data();
+    const auto encodedMessageEnd = [&]() {
+      switch (mANSHeader.getNInterleavedStreams()) {
+        case 0:
+          return encoder->process(srcBegin, srcEnd, dataBegin, literals);
+        case 4:
+          return encoder->template processInterleaved<4>(srcBegin, srcEnd, dataBegin, literals);
+        case 8:
+          return encoder->template processInterleaved<8>(srcBegin, srcEnd, dataBegin, literals);
+        case 16:
+          return encoder->template processInterleaved<16>(srcBegin, srcEnd, dataBegin, literals);
+        default:
+          throw std::runtime_error("Unsupported number of interleaved rANS streams");
+      }
+    }();
+    rans::utils::checkBounds(encodedMessageEnd, dataBegin + dest.data.size());
+    dest.data.resize(encodedMessageEnd - dataBegin);
+
+    const size_t nLiteralSymbols = literals.size();
+    if (nLiteralSymbols) {
+      // introduce padding in case literals don't align;
+      literals.resize(calculatePaddedSize<input_t, storageBuffer_t>(nLiteralSymbols), {});
+      const size_t nLiteralStorageElems = calculateNDestTElements<input_t, storageBuffer_t>(nLiteralSymbols);
+      const auto* literalsBegin = reinterpret_cast<const storageBuffer_t*>(literals.data());
+      dest.literals.assign(literalsBegin, literalsBegin + nLiteralStorageElems);
+    }
+
+    dest.metadata = Metadata{messageLength,
+                             nLiteralSymbols,
+                             sizeof(ransState_t),
+                             sizeof(ransStream_t),
+                             static_cast<uint8_t>(encoder->getSymbolTablePrecision()),
+                             opt,
+                             encoder->getMinSymbol(),
+                             encoder->getMaxSymbol(),
+                             static_cast<int32_t>(dest.dict.size()),
+                             static_cast<int32_t>(dest.data.size()),
+                             static_cast<int32_t>(dest.literals.size())};
+  } else { // store original data w/o EEncoding
+    const size_t nSourceElemsPadded = calculatePaddedSize<input_t, storageBuffer_t>(messageLength);
+    std::vector<input_t> tmp(nSourceElemsPadded, {});
+    std::copy(srcBegin, srcEnd, std::begin(tmp));
+
+    const size_t nBufferElems = calculateNDestTElements<input_t, storageBuffer_t>(messageLength);
+    const auto* tmpBegin = reinterpret_cast<const storageBuffer_t*>(tmp.data());
+    dest.data.assign(tmpBegin, tmpBegin + nBufferElems);
+
+    dest.metadata = Metadata{messageLength, 0, sizeof(ransState_t), sizeof(storageBuffer_t), symbolTablePrecision, opt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
+  }
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename buffer_T>
+void EncodedBlocks<H, N, W>::storeEncodedSlot(const EncodedSlot<W>& src, // image of the slot
+                                              int slot,                  // slot in encoded data to fill
+                                              buffer_T* buffer)          // optional buffer (vector) providing memory for encoded blocks
+{
+  assert(slot == mRegistry.nFilledBlocks);
+  mRegistry.nFilledBlocks++;
+
+  if (src.metadata.opt == Metadata::OptStore::NODATA) {
+    mMetadata[slot] = src.metadata;
+    return;
+  }
+
+  auto* thisBlocks = this;
+  const size_t requiredSize = estimateBlockSize(src.dict.size() + src.data.size() + src.literals.size()); // size in bytes!!!
+  if (requiredSize >= getFreeSize()) {
+    LOG(DEBUG) << "Slot " << slot << ": free size: " << getFreeSize() << ", need " << requiredSize;
+    if (!buffer) {
+      throw std::runtime_error("no room for encoded block in provided container");
+    }
+    expand(*buffer, size() + (requiredSize - getFreeSize()));
+    thisBlocks = get(buffer->data()); // in case of resizing this and any this.xxx becomes invalid
+  }
+  auto asPointer = [](const std::vector<W>& v) { return v.empty() ? nullptr : v.data(); };
+  thisBlocks->mBlocks[slot].store(src.dict.size(), src.data.size(), src.literals.size(), asPointer(src.dict), asPointer(src.data), asPointer(src.literals));
+  thisBlocks->mMetadata[slot] = src.metadata;
+}
+
 /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
 template <typename H, int N, typename W>
 std::vector<char> EncodedBlocks<H, N, W>::createDictionaryBlocks(const std::vector<o2::rans::FrequencyTable>& vfreq, const std::vector<Metadata>& vmd)
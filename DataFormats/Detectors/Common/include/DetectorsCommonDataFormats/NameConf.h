@@ -104,6 +104,9 @@ class NameConf : public o2::conf::ConfigurableParamHelper<NameConf>
   // CTF Filename
   static std::string getCTFFileName(uint32_t run, uint32_t orb, uint32_t id, const std::string_view prefix = "o2_ctf");
 
+  // default regex to select CTF files, both ROOT (.root) and flat (.ctf) ones
+  static constexpr std::string_view CTFFILEREGEX = ".*o2_ctf_run.+\\.(root|ctf)$";
+
   // CTF Dictionary
   static std::string getCTFDictFileName();
 
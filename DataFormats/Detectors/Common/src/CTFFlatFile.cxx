@@ -0,0 +1,251 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.cxx
+/// \brief Flat (non-ROOT) CTF file format, read via mmap w/o deserialization
+
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "Framework/Logger.h"
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+using Format = CTFFlatFileFormat;
+
+static_assert(sizeof(Format::FileHeader) % Alignment == 0, "flat CTF file header must respect the alignment");
+static_assert(sizeof(Format::RecordHeader) % Alignment == 0, "flat CTF record header must respect the alignment");
+
+//___________________________________________________________________
+void CTFFlatFileWriter::open(const std::string& fileName)
+{
+  close();
+  mFile = std::fopen(fileName.c_str(), "wb");
+  if (!mFile) {
+    throw std::runtime_error(fmt::format("failed to open flat CTF file {} for writing: {}", fileName, std::strerror(errno)));
+  }
+  mFileName = fileName;
+  Format::FileHeader header{};
+  std::memcpy(header.magic, Format::Magic, sizeof(header.magic));
+  header.version = Format::Version;
+  if (std::fwrite(&header, sizeof(header), 1, mFile) != 1) {
+    throw std::runtime_error(fmt::format("failed to write header of flat CTF file {}", fileName));
+  }
+  mFileSize = sizeof(header);
+  mNTFs = 0;
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::close()
+{
+  if (mFile) {
+    auto res = std::fclose(mFile); // flushes the buffered records
+    mFile = nullptr;
+    if (res != 0) {
+      throw std::runtime_error(fmt::format("failed to close flat CTF file {}: {}", mFileName, std::strerror(errno)));
+    }
+  }
+}
+
+//___________________________________________________________________
+CTFFlatFileWriter::~CTFFlatFileWriter()
+{
+  try {
+    close();
+  } catch (const std::exception& e) {
+    LOGP(ERROR, "{}", e.what());
+  }
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::beginTF()
+{
+  mEntries.clear();
+  mPayload.clear();
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::addDetector(DetID det, const void* data, size_t size)
+{
+  auto& entry = mEntries.emplace_back();
+  entry.detID = det;
+  entry.offset = mPayload.size(); // wrt the payload start for the moment
+  entry.size = size;
+  mPayload.resize(mPayload.size() + alignSize(size), 0);
+  std::memcpy(mPayload.data() + entry.offset, data, size);
+}
+
+//___________________________________________________________________
+size_t CTFFlatFileWriter::endTF(const CTFHeader& header)
+{
+  if (!mFile) {
+    throw std::runtime_error("flat CTF file is not open");
+  }
+  const size_t entriesSize = alignSize(mEntries.size() * sizeof(Format::DetEntry));
+  const size_t payloadOffset = sizeof(Format::RecordHeader) + entriesSize;
+  Format::RecordHeader record{};
+  record.recordSize = payloadOffset + mPayload.size();
+  record.run = header.run;
+  record.detectors = header.detectors.to_ulong();
+  record.firstTForbit = header.firstTForbit;
+  record.nDetectors = mEntries.size();
+  for (auto& entry : mEntries) {
+    entry.offset += payloadOffset;
+  }
+  std::vector<char> entries(entriesSize, 0);
+  std::memcpy(entries.data(), mEntries.data(), mEntries.size() * sizeof(Format::DetEntry));
+  if (std::fwrite(&record, sizeof(record), 1, mFile) != 1 ||
+      (entriesSize && std::fwrite(entries.data(), entriesSize, 1, mFile) != 1) ||
+      (mPayload.size() && std::fwrite(mPayload.data(), mPayload.size(), 1, mFile) != 1)) {
+    throw std::runtime_error(fmt::format("failed to write TF record to flat CTF file {}", mFileName));
+  }
+  mFileSize += record.recordSize;
+  mNTFs++;
+  mEntries.clear();
+  mPayload.clear();
+  return record.recordSize;
+}
+
+//___________________________________________________________________
+bool CTFFlatFileReader::isFlatFile(const std::string& fileName)
+{
+  Format::FileHeader header{};
+  FILE* fl = std::fopen(fileName.c_str(), "rb");
+  if (!fl) {
+    return false;
+  }
+  bool res = std::fread(&header, sizeof(header), 1, fl) == 1 && std::memcmp(header.magic, Format::Magic, sizeof(header.magic)) == 0;
+  std::fclose(fl);
+  return res;
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::open(const std::string& fileName)
+{
+  close();
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(fmt::format("failed to open flat CTF file {}: {}", fileName, std::strerror(errno)));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Format::FileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("flat CTF file {} is too short", fileName));
+  }
+  void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping keeps the file referenced
+  if (base == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("failed to map flat CTF file {}: {}", fileName, std::strerror(errno)));
+  }
+  madvise(base, st.st_size, MADV_SEQUENTIAL);
+  mBase = static_cast<const char*>(base);
+  mSize = st.st_size;
+  mFileName = fileName;
+
+  const auto* header = reinterpret_cast<const Format::FileHeader*>(mBase);
+  if (std::memcmp(header->magic, Format::Magic, sizeof(header->magic)) != 0 || header->version != Format::Version) {
+    close();
+    throw std::runtime_error(fmt::format("{} is not a flat CTF file of version {}", fileName, Format::Version));
+  }
+  // build the index of TF records
+  size_t offset = sizeof(Format::FileHeader);
+  while (offset + sizeof(Format::RecordHeader) <= mSize) {
+    const auto* record = reinterpret_cast<const Format::RecordHeader*>(mBase + offset);
+    if (record->recordSize < sizeof(Format::RecordHeader) || record->recordSize > mSize - offset) {
+      LOGP(ERROR, "Truncated TF record at offset {} of flat CTF file {}, ignoring the rest of the file", offset, fileName);
+      break;
+    }
+    if (!checkRecord(*record)) {
+      close();
+      throw std::runtime_error(fmt::format("corrupted detector table in TF record at offset {} of flat CTF file {}", offset, fileName));
+    }
+    mRecords.push_back(offset);
+    offset += record->recordSize;
+  }
+}
+
+//___________________________________________________________________
+bool CTFFlatFileReader::checkRecord(const Format::RecordHeader& record)
+{
+  // the detector table and the images must lie within the record, the sums are kept free of overflows
+  const uint64_t size = record.recordSize;
+  if (record.nDetectors > (size - sizeof(Format::RecordHeader)) / sizeof(Format::DetEntry)) {
+    return false;
+  }
+  const uint64_t entriesEnd = sizeof(Format::RecordHeader) + uint64_t(record.nDetectors) * sizeof(Format::DetEntry);
+  const auto* entries = reinterpret_cast<const Format::DetEntry*>(&record + 1);
+  for (uint32_t i = 0; i < record.nDetectors; i++) {
+    if (entries[i].offset < entriesEnd || entries[i].offset > size || entries[i].size > size - entries[i].offset) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::close()
+{
+  if (mBase) {
+    munmap(const_cast<char*>(mBase), mSize);
+    mBase = nullptr;
+  }
+  mSize = 0;
+  mRecords.clear();
+}
+
+//___________________________________________________________________
+const Format::RecordHeader* CTFFlatFileReader::getRecord(size_t tf) const
+{
+  if (tf >= mRecords.size()) {
+    throw std::out_of_range(fmt::format("TF {} requested from flat CTF file {} with {} TFs", tf, mFileName, mRecords.size()));
+  }
+  return reinterpret_cast<const Format::RecordHeader*>(mBase + mRecords[tf]);
+}
+
+//___________________________________________________________________
+CTFHeader CTFFlatFileReader::getHeader(size_t tf) const
+{
+  const auto* record = getRecord(tf);
+  CTFHeader header{};
+  header.run = record->run;
+  header.firstTForbit = record->firstTForbit;
+  header.detectors = DetID::mask_t(record->detectors);
+  return header;
+}
+
+//___________________________________________________________________
+CTFFlatFileReader::Image CTFFlatFileReader::getDetectorImage(size_t tf, DetID det) const
+{
+  const auto* record = getRecord(tf); // its detector table was validated by open()
+  const auto* entries = reinterpret_cast<const Format::DetEntry*>(record + 1);
+  for (uint32_t i = 0; i < record->nDetectors; i++) {
+    if (entries[i].detID == det) {
+      return Image{reinterpret_cast<const char*>(record) + entries[i].offset, entries[i].size};
+    }
+  }
+  return Image{};
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::prefetch(size_t tf) const
+{
+  if (tf < mRecords.size()) {
+    const auto* record = getRecord(tf);
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    const size_t start = mRecords[tf] / pageSize * pageSize;
+    madvise(const_cast<char*>(mBase) + start, mRecords[tf] + record->recordSize - start, MADV_WILLNEED);
+  }
+}
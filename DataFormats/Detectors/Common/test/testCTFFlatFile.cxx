@@ -0,0 +1,217 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFFlatFile
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "DetectorsCommonDataFormats/NameConf.h"
+#include "CommonUtils/FileFetcher.h"
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+struct DummyHeader {
+  int value = 0;
+};
+using DummyCTF = EncodedBlocks<DummyHeader, 2, uint32_t>;
+
+BOOST_AUTO_TEST_CASE(CTFFlatFile_test)
+{
+  const std::string fileName = "test_ctf_flat.ctf";
+  std::vector<std::vector<int16_t>> sources(3);
+  std::vector<std::vector<BufferType>> buffers(3);
+  for (int tf = 0; tf < 3; tf++) {
+    auto& src = sources[tf];
+    for (int i = 0; i < 1000 * (tf + 1); i++) {
+      src.push_back((i * 7 + tf) % 31 - 15);
+    }
+    auto& buff = buffers[tf];
+    DummyCTF::create(buff)->getHeader().value = tf;
+    DummyCTF::get(buff.data())->encode(src, 0, 14, Metadata::OptStore::EENCODE, &buff);
+    DummyCTF::get(buff.data())->encode(src, 1, 10, Metadata::OptStore::EENCODE, &buff);
+    auto* ctf = DummyCTF::get(buff.data());
+    ctf->compactify();
+    buff.resize(ctf->size());
+  }
+
+  {
+    CTFFlatFileWriter writer;
+    writer.open(fileName);
+    for (int tf = 0; tf < 3; tf++) {
+      CTFHeader header{123, uint32_t(256 * tf), DetID::getMask(DetID::ITS)};
+      writer.beginTF();
+      writer.addDetector(DetID::ITS, buffers[tf].data(), buffers[tf].size());
+      writer.endTF(header);
+    }
+    BOOST_CHECK(writer.getNTFs() == 3);
+  }
+
+  BOOST_CHECK(CTFFlatFileReader::isFlatFile(fileName));
+  CTFFlatFileReader reader(fileName);
+  BOOST_CHECK(reader.getNTFs() == 3);
+  for (int tf = 0; tf < 3; tf++) {
+    const auto header = reader.getHeader(tf);
+    BOOST_CHECK(header.run == 123 && header.firstTForbit == uint32_t(256 * tf) && header.detectors == DetID::getMask(DetID::ITS));
+    BOOST_CHECK(reader.getDetectorImage(tf, DetID::TPC).empty());
+    const auto image = reader.getDetectorImage(tf, DetID::ITS);
+    BOOST_CHECK(image.size == buffers[tf].size());
+    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(image.data) % Alignment == 0);
+    const auto ctf = DummyCTF::getImage(image.data); // decode directly from the mapped pages
+    BOOST_CHECK(ctf.getHeader().value == tf);
+    for (int slot = 0; slot < DummyCTF::getNBlocks(); slot++) {
+      std::vector<int16_t> decoded;
+      ctf.decode(decoded, slot);
+      BOOST_CHECK(decoded == sources[tf]);
+    }
+  }
+  reader.close();
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(CTFFlatFile_selection_test)
+{
+  // flat CTF files named as by the CTF writer must be selected by the default regex of the CTF reader,
+  // both when found in a directory and when given directly
+  namespace fs = std::filesystem;
+  const fs::path dir = fs::temp_directory_path() / "test_ctf_flat_selection";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  const auto flatName = (dir / fs::path(o2::base::NameConf::getCTFFileName(123, 0, 0)).replace_extension(CTFFlatFileFormat::FileExtension)).string();
+  const auto rootName = (dir / o2::base::NameConf::getCTFFileName(123, 256, 1)).string();
+  std::ofstream(rootName) << "not a flat file";
+  std::ofstream((dir / "o2_ctf_run123.log").string()) << "not a CTF";
+
+  std::vector<int16_t> source(1000);
+  for (size_t i = 0; i < source.size(); i++) {
+    source[i] = i % 17;
+  }
+  std::vector<BufferType> buff;
+  DummyCTF::create(buff)->getHeader().value = 7;
+  DummyCTF::get(buff.data())->encode(source, 0, 12, Metadata::OptStore::EENCODE, &buff);
+  DummyCTF::get(buff.data())->encode(source, 1, 12, Metadata::OptStore::EENCODE, &buff);
+  DummyCTF::get(buff.data())->compactify();
+  buff.resize(DummyCTF::get(buff.data())->size());
+  {
+    CTFFlatFileWriter writer;
+    writer.open(flatName);
+    writer.beginTF();
+    writer.addDetector(DetID::ITS, buff.data(), buff.size());
+    writer.endTF(CTFHeader{123, 0, DetID::getMask(DetID::ITS)});
+  }
+
+  const std::string regex{o2::base::NameConf::CTFFILEREGEX};
+  {
+    o2::utils::FileFetcher fetcher(dir.string(), regex);
+    BOOST_CHECK(fetcher.getNFiles() == 2);
+    std::vector<std::string> names;
+    for (size_t i = 0; i < fetcher.getNFiles(); i++) {
+      names.push_back(fetcher.getFileRef(i).getOrigName());
+    }
+    BOOST_CHECK(std::find(names.begin(), names.end(), flatName) != names.end());
+    BOOST_CHECK(std::find(names.begin(), names.end(), rootName) != names.end());
+  }
+
+  o2::utils::FileFetcher fetcher(flatName, regex); // must not be taken for a list of files
+  BOOST_REQUIRE(fetcher.getNFiles() == 1);
+  const auto& fetchedName = fetcher.getFileRef(0).getLocalName();
+  BOOST_CHECK(fetchedName == flatName);
+  BOOST_CHECK(CTFFlatFileReader::isFlatFile(fetchedName));
+  BOOST_CHECK(!CTFFlatFileReader::isFlatFile(rootName));
+  CTFFlatFileReader reader(fetchedName);
+  BOOST_REQUIRE(reader.getNTFs() == 1);
+  const auto ctf = DummyCTF::getImage(reader.getDetectorImage(0, DetID::ITS).data);
+  BOOST_CHECK(ctf.getHeader().value == 7);
+  std::vector<int16_t> decoded;
+  ctf.decode(decoded, 0);
+  BOOST_CHECK(decoded == source);
+  reader.close();
+  fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(CTFFlatFile_corruption_test)
+{
+  using Format = CTFFlatFileFormat;
+  const std::string fileName = "test_ctf_flat_corrupted.ctf";
+  std::vector<char> payload(1000, 7);
+  {
+    CTFFlatFileWriter writer;
+    writer.open(fileName);
+    for (int tf = 0; tf < 2; tf++) {
+      writer.beginTF();
+      writer.addDetector(DetID::ITS, payload.data(), payload.size());
+      writer.endTF(CTFHeader{123, uint32_t(256 * tf), DetID::getMask(DetID::ITS)});
+    }
+  }
+  const auto fileSize = std::filesystem::file_size(fileName);
+  const size_t recordOffset = sizeof(Format::FileHeader);
+  const size_t entryOffset = recordOffset + sizeof(Format::RecordHeader);
+  // overwrite a field of the first TF record, returns the original value
+  auto patch = [&](size_t offset, auto value) {
+    std::fstream fl(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    decltype(value) original;
+    fl.seekg(offset);
+    fl.read(reinterpret_cast<char*>(&original), sizeof(original));
+    fl.seekp(offset);
+    fl.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    return original;
+  };
+
+  // detector table larger than the record
+  auto nDetectors = patch(recordOffset + offsetof(Format::RecordHeader, nDetectors), uint32_t(0x10000000));
+  BOOST_CHECK_THROW(CTFFlatFileReader{fileName}, std::runtime_error);
+  patch(recordOffset + offsetof(Format::RecordHeader, nDetectors), nDetectors);
+
+  // image beyond the record, also when the sum of its offset and size overflows
+  auto imageSize = patch(entryOffset + offsetof(Format::DetEntry, size), uint64_t(payload.size() * 2));
+  BOOST_CHECK_THROW(CTFFlatFileReader{fileName}, std::runtime_error);
+  patch(entryOffset + offsetof(Format::DetEntry, size), ~uint64_t(0));
+  BOOST_CHECK_THROW(CTFFlatFileReader{fileName}, std::runtime_error);
+  patch(entryOffset + offsetof(Format::DetEntry, size), imageSize);
+
+  // image overlapping the detector table
+  auto imageOffset = patch(entryOffset + offsetof(Format::DetEntry, offset), uint64_t(0));
+  BOOST_CHECK_THROW(CTFFlatFileReader{fileName}, std::runtime_error);
+  patch(entryOffset + offsetof(Format::DetEntry, offset), imageOffset);
+
+  // record size overflowing the file size
+  auto recordSize = patch(recordOffset + offsetof(Format::RecordHeader, recordSize), ~uint64_t(0));
+  BOOST_CHECK(CTFFlatFileReader{fileName}.getNTFs() == 0);
+  patch(recordOffset + offsetof(Format::RecordHeader, recordSize), recordSize);
+
+  // a truncated last record is ignored
+  std::filesystem::resize_file(fileName, fileSize - 10);
+  {
+    CTFFlatFileReader reader(fileName);
+    BOOST_REQUIRE(reader.getNTFs() == 1);
+    BOOST_CHECK(reader.getDetectorImage(0, DetID::ITS).size == payload.size());
+  }
+  std::remove(fileName.c_str());
+
+  // a failure to flush the file is reported
+  if (std::filesystem::exists("/dev/full")) {
+    CTFFlatFileWriter writer;
+    writer.open("/dev/full");
+    writer.beginTF();
+    writer.addDetector(DetID::ITS, payload.data(), payload.size());
+    writer.endTF(CTFHeader{123, 0, DetID::getMask(DetID::ITS)});
+    BOOST_CHECK_THROW(writer.close(), std::runtime_error);
+    BOOST_CHECK(!writer.isOpen());
+  }
+}
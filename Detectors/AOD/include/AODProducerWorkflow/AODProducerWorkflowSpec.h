@@ -39,6 +39,7 @@
 #include <boost/functional/hash.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/unordered_map.hpp>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -204,6 +205,7 @@ class AODProducerWorkflowDPL : public Task
   int64_t mTFNumber{-1};
   int mTruncate{1};
   int mRecoOnly{0};
+  int mNThreads{1};
   TStopwatch mTimer;
 
   // unordered map connects global indices and table indices of barrel tracks
@@ -340,6 +342,9 @@ class AODProducerWorkflowDPL : public Task
                               gsl::span<const GIndex>& primVerGIs,
                               o2::globaltracking::RecoContainer& data);
 
+  // run the jobs filling independent tables, concurrently if mNThreads > 1
+  void runJobs(std::vector<std::function<void()>> const& jobs);
+
   // helper for tpc clusters
   void countTPCClusters(const o2::tpc::TrackTPC& track,
                         const gsl::span<const o2::tpc::TPCClRefElem>& tpcClusRefs,
@@ -53,12 +53,18 @@
 #include "SimulationDataFormat/MCTrack.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
 #include "TMath.h"
+#include "TROOT.h"
 #include "MathUtils/Utils.h"
 #include "Math/SMatrix.h"
 #include <TMatrixD.h>
+#include <exception>
+#include <functional>
 #include <map>
 #include <unordered_map>
 #include <vector>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::framework;
 using namespace o2::math_utils::detail;
@@ -85,6 +91,21 @@ uint64_t relativeTime_to_LocalBC(double relativeTimeStampInNS)
 {
   return std::round(relativeTimeStampInNS / o2::constants::lhc::LHCBunchSpacingNS);
 }
+
+// reserves space for nRows rows in all the columns of a builder
+// whose cursor was created for the table T
+template <typename T, size_t... Is>
+void reserveRows(TableBuilder& builder, int nRows, std::index_sequence<Is...>)
+{
+  using persistent_table_t = typename soa::PackToTable<typename T::table_t::persistent_columns_t>::table;
+  builder.reserve(framework::pack<typename pack_element_t<Is, typename persistent_table_t::columns>::type...>{}, nRows);
+}
+
+template <typename T>
+void reserveRows(TableBuilder& builder, int nRows)
+{
+  reserveRows<T>(builder, nRows, std::make_index_sequence<pack_size(typename T::table_t::persistent_columns_t{})>());
+}
 } // namespace
 
 void AODProducerWorkflowDPL::collectBCs(gsl::span<const o2::fdd::RecPoint>& fddRecPoints,
@@ -786,6 +807,28 @@ void AODProducerWorkflowDPL::fillMCTrackLabelsTable(const MCTrackLabelCursorType
   }
 }
 
+void AODProducerWorkflowDPL::runJobs(std::vector<std::function<void()>> const& jobs)
+{
+  // an exception can not leave an OpenMP thread, it is passed on instead
+  std::vector<std::exception_ptr> errors(jobs.size());
+#ifdef WITH_OPENMP
+  omp_set_num_threads(mNThreads);
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int i = 0; i < (int)jobs.size(); i++) {
+    try {
+      jobs[i]();
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  }
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 void AODProducerWorkflowDPL::countTPCClusters(const o2::tpc::TrackTPC& track,
                                               const gsl::span<const o2::tpc::TPCClRefElem>& tpcClusRefs,
                                               const gsl::span<const unsigned char>& tpcClusShMap,
@@ -849,6 +892,13 @@ void AODProducerWorkflowDPL::init(InitContext& ic)
   mTFNumber = ic.options().get<int64_t>("aod-timeframe-id");
   mRecoOnly = ic.options().get<int>("reco-mctracks-only");
   mTruncate = ic.options().get<int>("enable-truncation");
+#ifdef WITH_OPENMP
+  mNThreads = std::max(1, ic.options().get<int>("nthreads"));
+#endif
+  if (mNThreads > 1) {
+    ROOT::EnableThreadSafety();
+    LOG(INFO) << "Filling the tables with " << mNThreads << " threads";
+  }
 
   if (mTFNumber == -1L) {
     LOG(INFO) << "TFNumber will be obtained from CCDB";
@@ -993,315 +1043,372 @@ void AODProducerWorkflowDPL::run(ProcessingContext& pc)
   float dummyTime = 0.f;
   uint8_t dummyTriggerMask = 0;
 
-  int nFV0ChannelsAside = o2::fv0::Geometry::getNumberOfReadoutChannels();
-  std::vector<float> vFV0Amplitudes(nFV0ChannelsAside, 0.);
-  for (auto& fv0RecPoint : fv0RecPoints) {
-    const auto channelData = fv0RecPoint.getBunchChannelData(fv0ChData);
-    for (auto& channel : channelData) {
-      vFV0Amplitudes[channel.channel] = channel.charge; // amplitude, mV
-    }
-    float aAmplitudesA[nFV0ChannelsAside];
-    for (int i = 0; i < nFV0ChannelsAside; i++) {
-      aAmplitudesA[i] = truncateFloatFraction(vFV0Amplitudes[i], mV0Amplitude);
-    }
-    uint64_t bc = fv0RecPoint.getInteractionRecord().toLong();
-    auto item = bcsMap.find(bc);
-    int bcID = -1;
-    if (item != bcsMap.end()) {
-      bcID = item->second;
-    } else {
-      LOG(FATAL) << "Error: could not find a corresponding BC ID for a FV0 rec. point; BC = " << bc;
+  // pre-size the builders with the number of rows known from the inputs
+  int nBarrelTracks = 0;
+  int nMFTTracks = 0;
+  int nFwdTracks = 0;
+  for (auto& trackRef : primVer2TRefs) {
+    for (int src = GIndex::NSources; src--;) {
+      if (!GIndex::includesSource(src, mInputSources)) {
+        continue;
+      }
+      if (src == GIndex::Source::MFT) {
+        nMFTTracks += trackRef.getEntriesOfSource(src);
+      } else if (src == GIndex::Source::MCH || src == GIndex::Source::MFTMCH) {
+        nFwdTracks += trackRef.getEntriesOfSource(src);
+      } else {
+        nBarrelTracks += trackRef.getEntriesOfSource(src);
+      }
     }
-    fv0aCursor(0,
-               bcID,
-               aAmplitudesA,
-               truncateFloatFraction(fv0RecPoint.getCollisionGlobalMeanTime() * 1E-3, mV0Time), // ps to ns
-               fv0RecPoint.getTrigger().triggerSignals);
   }
-
-  float dummyFV0AmplC[32] = {0.};
-  fv0cCursor(0,
-             dummyBC,
-             dummyFV0AmplC,
-             dummyTime);
-
-  float dummyEnergyZEM1 = 0;
-  float dummyEnergyZEM2 = 0;
-  float dummyEnergyCommonZNA = 0;
-  float dummyEnergyCommonZNC = 0;
-  float dummyEnergyCommonZPA = 0;
-  float dummyEnergyCommonZPC = 0;
-  float dummyEnergySectorZNA[4] = {0.};
-  float dummyEnergySectorZNC[4] = {0.};
-  float dummyEnergySectorZPA[4] = {0.};
-  float dummyEnergySectorZPC[4] = {0.};
-  zdcCursor(0,
-            dummyBC,
-            dummyEnergyZEM1,
-            dummyEnergyZEM2,
-            dummyEnergyCommonZNA,
-            dummyEnergyCommonZNC,
-            dummyEnergyCommonZPA,
-            dummyEnergyCommonZPC,
-            dummyEnergySectorZNA,
-            dummyEnergySectorZNC,
-            dummyEnergySectorZPA,
-            dummyEnergySectorZPC,
-            dummyTime,
-            dummyTime,
-            dummyTime,
-            dummyTime,
-            dummyTime,
-            dummyTime);
-
-  // keep track event/source id for each mc-collision
-  // using map and not unordered_map to ensure
-  // correct ordering when iterating over container elements
-  std::map<std::pair<int, int>, int> mcColToEvSrc;
-
-  // TODO: figure out collision weight
-  float mcColWeight = 1.;
-  // filling mcCollision table
-  int nMCCollisions = mcContext->getNCollisions();
-  for (int iCol = 0; iCol < nMCCollisions; iCol++) {
-    auto time = mcRecords[iCol].getTimeNS();
-    auto globalBC = mcRecords[iCol].toLong();
-    auto item = bcsMap.find(globalBC);
-    int bcID = -1;
-    if (item != bcsMap.end()) {
-      bcID = item->second;
-    } else {
-      LOG(FATAL) << "Error: could not find a corresponding BC ID for MC collision; BC = " << globalBC << ", mc collision = " << iCol;
-    }
-    auto& colParts = mcParts[iCol];
-    for (auto colPart : colParts) {
-      auto eventID = colPart.entryID;
-      auto sourceID = colPart.sourceID;
-      if (sourceID == 0) { // embedding: using background event info
-        // FIXME:
-        // use generators' names for generatorIDs (?)
-        short generatorID = sourceID;
-        auto& header = mcReader.getMCEventHeader(sourceID, eventID);
-        mcCollisionsCursor(0,
-                           bcID,
-                           generatorID,
-                           truncateFloatFraction(header.GetX(), mCollisionPosition),
-                           truncateFloatFraction(header.GetY(), mCollisionPosition),
-                           truncateFloatFraction(header.GetZ(), mCollisionPosition),
-                           truncateFloatFraction(time, mCollisionPosition),
-                           truncateFloatFraction(mcColWeight, mCollisionPosition),
-                           header.GetB());
+  reserveRows<o2::aod::BCs>(bcBuilder, bcsMap.size());
+  reserveRows<o2::aod::StoredCascades>(cascadesBuilder, cascades.size());
+  reserveRows<o2::aod::Collisions>(collisionsBuilder, primVertices.size());
+  reserveRows<o2::aod::FDDs>(fddBuilder, fddRecPoints.size());
+  reserveRows<o2::aod::FT0s>(ft0Builder, ft0RecPoints.size());
+  reserveRows<o2::aod::FV0As>(fv0aBuilder, fv0RecPoints.size());
+  reserveRows<o2::aodproducer::FwdTracksTable>(fwdTracksBuilder, nFwdTracks);
+  reserveRows<o2::aodproducer::FwdTracksCovTable>(fwdTracksCovBuilder, nFwdTracks);
+  reserveRows<o2::aod::McCollisionLabels>(mcColLabelsBuilder, primVerLabels.size());
+  reserveRows<o2::aod::McCollisions>(mcCollisionsBuilder, mcContext->getNCollisions());
+  reserveRows<o2::aod::McMFTTrackLabels>(mcMFTTrackLabelBuilder, nMFTTracks);
+  reserveRows<o2::aod::McFwdTrackLabels>(mcFwdTrackLabelBuilder, nFwdTracks);
+  reserveRows<o2::aod::McTrackLabels>(mcTrackLabelBuilder, nBarrelTracks);
+  reserveRows<o2::aodproducer::MFTTracksTable>(mftTracksBuilder, nMFTTracks);
+  reserveRows<o2::aodproducer::TracksTable>(tracksBuilder, nBarrelTracks);
+  reserveRows<o2::aodproducer::TracksCovTable>(tracksCovBuilder, nBarrelTracks);
+  reserveRows<o2::aodproducer::TracksExtraTable>(tracksExtraBuilder, nBarrelTracks);
+  reserveRows<o2::aod::StoredV0s>(v0sBuilder, secVertices.size());
+
+  // The tables are filled by independent jobs, each one owning its
+  // builders, so that they can run concurrently. Within a job the rows are
+  // added in the same order as in a sequential filling.
+  std::vector<std::function<void()>> jobs;
+
+  // barrel and forward tracks, which define the table indices needed by the
+  // V0s and the cascades
+  jobs.emplace_back([&]() {
+    // filling unassigned tracks first
+    // so that all unassigned tracks are stored in the beginning of the table together
+    auto& trackRef = primVer2TRefs.back(); // references to unassigned tracks are at the end
+    // fixme: interaction time is undefined for unassigned tracks (?)
+    fillTrackTablesPerCollision(-1, -1, trackRef, primVerGIs, recoData, tracksCursor, tracksCovCursor, tracksExtraCursor, mftTracksCursor, fwdTracksCursor, fwdTracksCovCursor, dataformats::PrimaryVertex{});
+
+    // filling collisions and tracks into tables
+    int collisionID = 0;
+    for (auto& vertex : primVertices) {
+      auto& cov = vertex.getCov();
+      auto& timeStamp = vertex.getTimeStamp();                       // this is a relative time
+      const double interactionTime = timeStamp.getTimeStamp() * 1E3; // mus to ns
+      uint64_t globalBC = relativeTime_to_GlobalBC(interactionTime);
+      uint64_t localBC = relativeTime_to_LocalBC(interactionTime);
+      LOG(DEBUG) << "global BC " << globalBC << " local BC " << localBC << " relative interaction time " << interactionTime;
+      // collision timestamp in ns wrt the beginning of collision BC
+      const float relInteractionTime = static_cast<float>(localBC * o2::constants::lhc::LHCBunchSpacingNS - interactionTime);
+      auto item = bcsMap.find(globalBC);
+      int bcID = -1;
+      if (item != bcsMap.end()) {
+        bcID = item->second;
+      } else {
+        LOG(FATAL) << "Error: could not find a corresponding BC ID for a collision; BC = " << globalBC << ", collisionID = " << collisionID;
       }
-      mcColToEvSrc.emplace(std::pair<int, int>(eventID, sourceID), iCol); // point background and injected signal events to one collision
+      collisionsCursor(0,
+                       bcID,
+                       truncateFloatFraction(vertex.getX(), mCollisionPosition),
+                       truncateFloatFraction(vertex.getY(), mCollisionPosition),
+                       truncateFloatFraction(vertex.getZ(), mCollisionPosition),
+                       truncateFloatFraction(cov[0], mCollisionPositionCov),
+                       truncateFloatFraction(cov[1], mCollisionPositionCov),
+                       truncateFloatFraction(cov[2], mCollisionPositionCov),
+                       truncateFloatFraction(cov[3], mCollisionPositionCov),
+                       truncateFloatFraction(cov[4], mCollisionPositionCov),
+                       truncateFloatFraction(cov[5], mCollisionPositionCov),
+                       vertex.getFlags(),
+                       truncateFloatFraction(vertex.getChi2(), mCollisionPositionCov),
+                       vertex.getNContributors(),
+                       truncateFloatFraction(relInteractionTime, mCollisionPosition),
+                       truncateFloatFraction(timeStamp.getTimeStampError() * 1E3, mCollisionPositionCov));
+      auto& trackRef = primVer2TRefs[collisionID];
+      // passing interaction time in [ps]
+      fillTrackTablesPerCollision(collisionID, interactionTime * 1E3, trackRef, primVerGIs, recoData, tracksCursor, tracksCovCursor, tracksExtraCursor, mftTracksCursor, fwdTracksCursor, fwdTracksCovCursor, vertex);
+      collisionID++;
     }
-  }
 
-  // vector of FDD amplitudes
-  int nFDDChannels = o2::fdd::Nchannels;
-  std::vector<float> vFDDAmplitudes(nFDDChannels, 0.);
-  // filling FDD table
-  for (const auto& fddRecPoint : fddRecPoints) {
-    const auto channelData = fddRecPoint.getBunchChannelData(fddChData);
-    // TODO: switch to calibrated amplitude
-    for (const auto& channel : channelData) {
-      vFDDAmplitudes[channel.mPMNumber] = channel.mChargeADC; // amplitude, mV
-    }
-    float aFDDAmplitudesA[int(nFDDChannels * 0.5)];
-    float aFDDAmplitudesC[int(nFDDChannels * 0.5)];
-    for (int i = 0; i < nFDDChannels; i++) {
-      if (i < nFDDChannels * 0.5) {
-        aFDDAmplitudesC[i] = truncateFloatFraction(vFDDAmplitudes[i], mFDDAmplitude);
+    // filling v0s table
+    for (auto& svertex : secVertices) {
+      auto trPosID = svertex.getProngID(0);
+      auto trNegID = svertex.getProngID(1);
+      int posTableIdx = -1;
+      int negTableIdx = -1;
+      auto item = mGIDToTableID.find(trPosID);
+      if (item != mGIDToTableID.end()) {
+        posTableIdx = item->second;
       } else {
-        aFDDAmplitudesA[i - int(nFDDChannels * 0.5)] = truncateFloatFraction(vFDDAmplitudes[i], mFDDAmplitude);
+        LOG(WARN) << "Could not find a positive track index for prong ID " << trPosID;
+      }
+      item = mGIDToTableID.find(trNegID);
+      if (item != mGIDToTableID.end()) {
+        negTableIdx = item->second;
+      } else {
+        LOG(WARN) << "Could not find a negative track index for prong ID " << trNegID;
+      }
+      if (posTableIdx != -1 and negTableIdx != -1) {
+        v0sCursor(0, posTableIdx, negTableIdx);
       }
     }
-    uint64_t globalBC = fddRecPoint.getInteractionRecord().toLong();
-    uint64_t bc = globalBC;
-    auto item = bcsMap.find(bc);
-    int bcID = -1;
-    if (item != bcsMap.end()) {
-      bcID = item->second;
-    } else {
-      LOG(FATAL) << "Error: could not find a corresponding BC ID for a FDD rec. point; BC = " << bc;
-    }
-    fddCursor(0,
-              bcID,
-              aFDDAmplitudesA,
-              aFDDAmplitudesC,
-              truncateFloatFraction(fddRecPoint.getCollisionTimeA() * 1E-3, mFDDTime), // ps to ns
-              truncateFloatFraction(fddRecPoint.getCollisionTimeC() * 1E-3, mFDDTime), // ps to ns
-              fddRecPoint.getTrigger().triggersignals);
-  }
 
-  // vector of FT0 amplitudes
-  int nFT0Channels = o2::ft0::Geometry::Nsensors;
-  int nFT0ChannelsAside = o2::ft0::Geometry::NCellsA * 4;
-  std::vector<float> vAmplitudes(nFT0Channels, 0.);
-  // filling FT0 table
-  for (auto& ft0RecPoint : ft0RecPoints) {
-    const auto channelData = ft0RecPoint.getBunchChannelData(ft0ChData);
-    // TODO: switch to calibrated amplitude
-    for (auto& channel : channelData) {
-      vAmplitudes[channel.ChId] = channel.QTCAmpl; // amplitude, mV
+    // filling cascades table
+    for (auto& cascade : cascades) {
+      auto bachelorID = cascade.getBachelorID();
+      int bachTableIdx = -1;
+      auto item = mGIDToTableID.find(bachelorID);
+      if (item != mGIDToTableID.end()) {
+        bachTableIdx = item->second;
+      } else {
+        LOG(WARN) << "Could not find a bachelor track index";
+      }
+      cascadesCursor(0, cascade.getV0ID(), bachTableIdx);
     }
-    float aAmplitudesA[nFT0ChannelsAside];
-    float aAmplitudesC[nFT0Channels - nFT0ChannelsAside];
-    for (int i = 0; i < nFT0Channels; i++) {
-      if (i < nFT0ChannelsAside) {
-        aAmplitudesA[i] = truncateFloatFraction(vAmplitudes[i], mT0Amplitude);
+
+    mTableTrID = 0;
+    mGIDToTableID.clear();
+  });
+
+  // everything which needs the MC kinematics, read sequentially
+  jobs.emplace_back([&]() {
+    // keep track event/source id for each mc-collision
+    // using map and not unordered_map to ensure
+    // correct ordering when iterating over container elements
+    std::map<std::pair<int, int>, int> mcColToEvSrc;
+
+    // TODO: figure out collision weight
+    float mcColWeight = 1.;
+    // filling mcCollision table
+    int nMCCollisions = mcContext->getNCollisions();
+    for (int iCol = 0; iCol < nMCCollisions; iCol++) {
+      auto time = mcRecords[iCol].getTimeNS();
+      auto globalBC = mcRecords[iCol].toLong();
+      auto item = bcsMap.find(globalBC);
+      int bcID = -1;
+      if (item != bcsMap.end()) {
+        bcID = item->second;
       } else {
-        aAmplitudesC[i - nFT0ChannelsAside] = truncateFloatFraction(vAmplitudes[i], mT0Amplitude);
+        LOG(FATAL) << "Error: could not find a corresponding BC ID for MC collision; BC = " << globalBC << ", mc collision = " << iCol;
+      }
+      auto& colParts = mcParts[iCol];
+      for (auto colPart : colParts) {
+        auto eventID = colPart.entryID;
+        auto sourceID = colPart.sourceID;
+        if (sourceID == 0) { // embedding: using background event info
+          // FIXME:
+          // use generators' names for generatorIDs (?)
+          short generatorID = sourceID;
+          auto& header = mcReader.getMCEventHeader(sourceID, eventID);
+          mcCollisionsCursor(0,
+                             bcID,
+                             generatorID,
+                             truncateFloatFraction(header.GetX(), mCollisionPosition),
+                             truncateFloatFraction(header.GetY(), mCollisionPosition),
+                             truncateFloatFraction(header.GetZ(), mCollisionPosition),
+                             truncateFloatFraction(time, mCollisionPosition),
+                             truncateFloatFraction(mcColWeight, mCollisionPosition),
+                             header.GetB());
+        }
+        mcColToEvSrc.emplace(std::pair<int, int>(eventID, sourceID), iCol); // point background and injected signal events to one collision
       }
     }
-    uint64_t globalBC = ft0RecPoint.getInteractionRecord().toLong();
-    uint64_t bc = globalBC;
-    auto item = bcsMap.find(bc);
-    int bcID = -1;
-    if (item != bcsMap.end()) {
-      bcID = item->second;
-    } else {
-      LOG(FATAL) << "Error: could not find a corresponding BC ID for a FT0 rec. point; BC = " << bc;
+
+    // filling MC collision labels
+    for (auto& label : primVerLabels) {
+      auto it = mcColToEvSrc.find(std::pair<int, int>(label.getEventID(), label.getSourceID()));
+      int32_t mcCollisionID = it != mcColToEvSrc.end() ? it->second : -1;
+      uint16_t mcMask = 0; // todo: set mask using normalized weights?
+      mcColLabelsCursor(0, mcCollisionID, mcMask);
     }
-    ft0Cursor(0,
-              bcID,
-              aAmplitudesA,
-              aAmplitudesC,
-              truncateFloatFraction(ft0RecPoint.getCollisionTimeA() * 1E-3, mT0Time), // ps to ns
-              truncateFloatFraction(ft0RecPoint.getCollisionTimeC() * 1E-3, mT0Time), // ps to ns
-              ft0RecPoint.getTrigger().triggersignals);
-  }
 
-  // filling MC collision labels
-  for (auto& label : primVerLabels) {
-    auto it = mcColToEvSrc.find(std::pair<int, int>(label.getEventID(), label.getSourceID()));
-    int32_t mcCollisionID = it != mcColToEvSrc.end() ? it->second : -1;
-    uint16_t mcMask = 0; // todo: set mask using normalized weights?
-    mcColLabelsCursor(0, mcCollisionID, mcMask);
-  }
+    // filling mc particles table
+    fillMCParticlesTable(mcReader,
+                         mcParticlesCursor,
+                         primVer2TRefs,
+                         primVerGIs,
+                         recoData,
+                         mcColToEvSrc);
 
-  // hash map for track indices of secondary vertices
-  std::unordered_map<int, int> v0sIndices;
+    mcColToEvSrc.clear();
 
-  // filling unassigned tracks first
-  // so that all unassigned tracks are stored in the beginning of the table together
-  auto& trackRef = primVer2TRefs.back(); // references to unassigned tracks are at the end
-  // fixme: interaction time is undefined for unassigned tracks (?)
-  fillTrackTablesPerCollision(-1, -1, trackRef, primVerGIs, recoData, tracksCursor, tracksCovCursor, tracksExtraCursor, mftTracksCursor, fwdTracksCursor, fwdTracksCovCursor, dataformats::PrimaryVertex{});
+    // ------------------------------------------------------
+    // filling track labels
 
-  // filling collisions and tracks into tables
-  int collisionID = 0;
-  for (auto& vertex : primVertices) {
-    auto& cov = vertex.getCov();
-    auto& timeStamp = vertex.getTimeStamp();                       // this is a relative time
-    const double interactionTime = timeStamp.getTimeStamp() * 1E3; // mus to ns
-    uint64_t globalBC = relativeTime_to_GlobalBC(interactionTime);
-    uint64_t localBC = relativeTime_to_LocalBC(interactionTime);
-    LOG(DEBUG) << "global BC " << globalBC << " local BC " << localBC << " relative interaction time " << interactionTime;
-    // collision timestamp in ns wrt the beginning of collision BC
-    const float relInteractionTime = static_cast<float>(localBC * o2::constants::lhc::LHCBunchSpacingNS - interactionTime);
-    auto item = bcsMap.find(globalBC);
-    int bcID = -1;
-    if (item != bcsMap.end()) {
-      bcID = item->second;
-    } else {
-      LOG(FATAL) << "Error: could not find a corresponding BC ID for a collision; BC = " << globalBC << ", collisionID = " << collisionID;
+    // need to go through labels in the same order as for tracks
+    fillMCTrackLabelsTable(mcTrackLabelCursor, mcMFTTrackLabelCursor, mcFwdTrackLabelCursor, primVer2TRefs.back(), primVerGIs, recoData);
+    for (int iref = 0; iref < primVer2TRefs.size() - 1; iref++) {
+      auto& trackRef = primVer2TRefs[iref];
+      fillMCTrackLabelsTable(mcTrackLabelCursor, mcMFTTrackLabelCursor, mcFwdTrackLabelCursor, trackRef, primVerGIs, recoData);
     }
-    collisionsCursor(0,
-                     bcID,
-                     truncateFloatFraction(vertex.getX(), mCollisionPosition),
-                     truncateFloatFraction(vertex.getY(), mCollisionPosition),
-                     truncateFloatFraction(vertex.getZ(), mCollisionPosition),
-                     truncateFloatFraction(cov[0], mCollisionPositionCov),
-                     truncateFloatFraction(cov[1], mCollisionPositionCov),
-                     truncateFloatFraction(cov[2], mCollisionPositionCov),
-                     truncateFloatFraction(cov[3], mCollisionPositionCov),
-                     truncateFloatFraction(cov[4], mCollisionPositionCov),
-                     truncateFloatFraction(cov[5], mCollisionPositionCov),
-                     vertex.getFlags(),
-                     truncateFloatFraction(vertex.getChi2(), mCollisionPositionCov),
-                     vertex.getNContributors(),
-                     truncateFloatFraction(relInteractionTime, mCollisionPosition),
-                     truncateFloatFraction(timeStamp.getTimeStampError() * 1E3, mCollisionPositionCov));
-    auto& trackRef = primVer2TRefs[collisionID];
-    // passing interaction time in [ps]
-    fillTrackTablesPerCollision(collisionID, interactionTime * 1E3, trackRef, primVerGIs, recoData, tracksCursor, tracksCovCursor, tracksExtraCursor, mftTracksCursor, fwdTracksCursor, fwdTracksCovCursor, vertex);
-    collisionID++;
-  }
 
-  // filling v0s table
-  for (auto& svertex : secVertices) {
-    auto trPosID = svertex.getProngID(0);
-    auto trNegID = svertex.getProngID(1);
-    int posTableIdx = -1;
-    int negTableIdx = -1;
-    auto item = mGIDToTableID.find(trPosID);
-    if (item != mGIDToTableID.end()) {
-      posTableIdx = item->second;
-    } else {
-      LOG(WARN) << "Could not find a positive track index for prong ID " << trPosID;
+    mToStore.clear();
+  });
+
+  jobs.emplace_back([&]() {
+    int nFV0ChannelsAside = o2::fv0::Geometry::getNumberOfReadoutChannels();
+    std::vector<float> vFV0Amplitudes(nFV0ChannelsAside, 0.);
+    for (auto& fv0RecPoint : fv0RecPoints) {
+      const auto channelData = fv0RecPoint.getBunchChannelData(fv0ChData);
+      for (auto& channel : channelData) {
+        vFV0Amplitudes[channel.channel] = channel.charge; // amplitude, mV
+      }
+      float aAmplitudesA[nFV0ChannelsAside];
+      for (int i = 0; i < nFV0ChannelsAside; i++) {
+        aAmplitudesA[i] = truncateFloatFraction(vFV0Amplitudes[i], mV0Amplitude);
+      }
+      uint64_t bc = fv0RecPoint.getInteractionRecord().toLong();
+      auto item = bcsMap.find(bc);
+      int bcID = -1;
+      if (item != bcsMap.end()) {
+        bcID = item->second;
+      } else {
+        LOG(FATAL) << "Error: could not find a corresponding BC ID for a FV0 rec. point; BC = " << bc;
+      }
+      fv0aCursor(0,
+                 bcID,
+                 aAmplitudesA,
+                 truncateFloatFraction(fv0RecPoint.getCollisionGlobalMeanTime() * 1E-3, mV0Time), // ps to ns
+                 fv0RecPoint.getTrigger().triggerSignals);
     }
-    item = mGIDToTableID.find(trNegID);
-    if (item != mGIDToTableID.end()) {
-      negTableIdx = item->second;
-    } else {
-      LOG(WARN) << "Could not find a negative track index for prong ID " << trNegID;
+
+    float dummyFV0AmplC[32] = {0.};
+    fv0cCursor(0,
+               dummyBC,
+               dummyFV0AmplC,
+               dummyTime);
+  });
+
+  jobs.emplace_back([&]() {
+    float dummyEnergyZEM1 = 0;
+    float dummyEnergyZEM2 = 0;
+    float dummyEnergyCommonZNA = 0;
+    float dummyEnergyCommonZNC = 0;
+    float dummyEnergyCommonZPA = 0;
+    float dummyEnergyCommonZPC = 0;
+    float dummyEnergySectorZNA[4] = {0.};
+    float dummyEnergySectorZNC[4] = {0.};
+    float dummyEnergySectorZPA[4] = {0.};
+    float dummyEnergySectorZPC[4] = {0.};
+    zdcCursor(0,
+              dummyBC,
+              dummyEnergyZEM1,
+              dummyEnergyZEM2,
+              dummyEnergyCommonZNA,
+              dummyEnergyCommonZNC,
+              dummyEnergyCommonZPA,
+              dummyEnergyCommonZPC,
+              dummyEnergySectorZNA,
+              dummyEnergySectorZNC,
+              dummyEnergySectorZPA,
+              dummyEnergySectorZPC,
+              dummyTime,
+              dummyTime,
+              dummyTime,
+              dummyTime,
+              dummyTime,
+              dummyTime);
+  });
+
+  jobs.emplace_back([&]() {
+    // vector of FDD amplitudes
+    int nFDDChannels = o2::fdd::Nchannels;
+    std::vector<float> vFDDAmplitudes(nFDDChannels, 0.);
+    // filling FDD table
+    for (const auto& fddRecPoint : fddRecPoints) {
+      const auto channelData = fddRecPoint.getBunchChannelData(fddChData);
+      // TODO: switch to calibrated amplitude
+      for (const auto& channel : channelData) {
+        vFDDAmplitudes[channel.mPMNumber] = channel.mChargeADC; // amplitude, mV
+      }
+      float aFDDAmplitudesA[int(nFDDChannels * 0.5)];
+      float aFDDAmplitudesC[int(nFDDChannels * 0.5)];
+      for (int i = 0; i < nFDDChannels; i++) {
+        if (i < nFDDChannels * 0.5) {
+          aFDDAmplitudesC[i] = truncateFloatFraction(vFDDAmplitudes[i], mFDDAmplitude);
+        } else {
+          aFDDAmplitudesA[i - int(nFDDChannels * 0.5)] = truncateFloatFraction(vFDDAmplitudes[i], mFDDAmplitude);
+        }
+      }
+      uint64_t globalBC = fddRecPoint.getInteractionRecord().toLong();
+      uint64_t bc = globalBC;
+      auto item = bcsMap.find(bc);
+      int bcID = -1;
+      if (item != bcsMap.end()) {
+        bcID = item->second;
+      } else {
+        LOG(FATAL) << "Error: could not find a corresponding BC ID for a FDD rec. point; BC = " << bc;
+      }
+      fddCursor(0,
+                bcID,
+                aFDDAmplitudesA,
+                aFDDAmplitudesC,
+                truncateFloatFraction(fddRecPoint.getCollisionTimeA() * 1E-3, mFDDTime), // ps to ns
+                truncateFloatFraction(fddRecPoint.getCollisionTimeC() * 1E-3, mFDDTime), // ps to ns
+                fddRecPoint.getTrigger().triggersignals);
     }
-    if (posTableIdx != -1 and negTableIdx != -1) {
-      v0sCursor(0, posTableIdx, negTableIdx);
+  });
+
+  jobs.emplace_back([&]() {
+    // vector of FT0 amplitudes
+    int nFT0Channels = o2::ft0::Geometry::Nsensors;
+    int nFT0ChannelsAside = o2::ft0::Geometry::NCellsA * 4;
+    std::vector<float> vAmplitudes(nFT0Channels, 0.);
+    // filling FT0 table
+    for (auto& ft0RecPoint : ft0RecPoints) {
+      const auto channelData = ft0RecPoint.getBunchChannelData(ft0ChData);
+      // TODO: switch to calibrated amplitude
+      for (auto& channel : channelData) {
+        vAmplitudes[channel.ChId] = channel.QTCAmpl; // amplitude, mV
+      }
+      float aAmplitudesA[nFT0ChannelsAside];
+      float aAmplitudesC[nFT0Channels - nFT0ChannelsAside];
+      for (int i = 0; i < nFT0Channels; i++) {
+        if (i < nFT0ChannelsAside) {
+          aAmplitudesA[i] = truncateFloatFraction(vAmplitudes[i], mT0Amplitude);
+        } else {
+          aAmplitudesC[i - nFT0ChannelsAside] = truncateFloatFraction(vAmplitudes[i], mT0Amplitude);
+        }
+      }
+      uint64_t globalBC = ft0RecPoint.getInteractionRecord().toLong();
+      uint64_t bc = globalBC;
+      auto item = bcsMap.find(bc);
+      int bcID = -1;
+      if (item != bcsMap.end()) {
+        bcID = item->second;
+      } else {
+        LOG(FATAL) << "Error: could not find a corresponding BC ID for a FT0 rec. point; BC = " << bc;
+      }
+      ft0Cursor(0,
+                bcID,
+                aAmplitudesA,
+                aAmplitudesC,
+                truncateFloatFraction(ft0RecPoint.getCollisionTimeA() * 1E-3, mT0Time), // ps to ns
+                truncateFloatFraction(ft0RecPoint.getCollisionTimeC() * 1E-3, mT0Time), // ps to ns
+                ft0RecPoint.getTrigger().triggersignals);
     }
-  }
-
-  // filling cascades table
-  for (auto& cascade : cascades) {
-    auto bachelorID = cascade.getBachelorID();
-    int bachTableIdx = -1;
-    auto item = mGIDToTableID.find(bachelorID);
-    if (item != mGIDToTableID.end()) {
-      bachTableIdx = item->second;
-    } else {
-      LOG(WARN) << "Could not find a bachelor track index";
+  });
+
+  jobs.emplace_back([&]() {
+    // filling BC table
+    // TODO: get real triggerMask
+    uint64_t triggerMask = 1;
+    for (auto& item : bcsMap) {
+      uint64_t bc = item.first;
+      bcCursor(0,
+               runNumber,
+               bc,
+               triggerMask);
     }
-    cascadesCursor(0, cascade.getV0ID(), bachTableIdx);
-  }
-
-  mTableTrID = 0;
-  mGIDToTableID.clear();
-
-  // filling BC table
-  // TODO: get real triggerMask
-  uint64_t triggerMask = 1;
-  for (auto& item : bcsMap) {
-    uint64_t bc = item.first;
-    bcCursor(0,
-             runNumber,
-             bc,
-             triggerMask);
-  }
+  });
 
+  runJobs(jobs);
   bcsMap.clear();
 
-  // filling mc particles table
-  fillMCParticlesTable(mcReader,
-                       mcParticlesCursor,
-                       primVer2TRefs,
-                       primVerGIs,
-                       recoData,
-                       mcColToEvSrc);
-
-  mcColToEvSrc.clear();
-
-  // ------------------------------------------------------
-  // filling track labels
-
-  // need to go through labels in the same order as for tracks
-  fillMCTrackLabelsTable(mcTrackLabelCursor, mcMFTTrackLabelCursor, mcFwdTrackLabelCursor, primVer2TRefs.back(), primVerGIs, recoData);
-  for (int iref = 0; iref < primVer2TRefs.size() - 1; iref++) {
-    auto& trackRef = primVer2TRefs[iref];
-    fillMCTrackLabelsTable(mcTrackLabelCursor, mcMFTTrackLabelCursor, mcFwdTrackLabelCursor, trackRef, primVerGIs, recoData);
-  }
-
-  mToStore.clear();
-
   pc.outputs().snapshot(Output{"TFN", "TFNumber", 0, Lifetime::Timeframe}, tfNumber);
 
   mTimer.Stop();
@@ -1356,7 +1463,8 @@ DataProcessorSpec getAODProducerWorkflowSpec(GID::mask_t src, bool useMC)
     Options{
       ConfigParamSpec{"aod-timeframe-id", VariantType::Int64, -1L, {"Set timeframe number"}},
       ConfigParamSpec{"enable-truncation", VariantType::Int, 1, {"Truncation parameter: 1 -- on, != 1 -- off"}},
-      ConfigParamSpec{"reco-mctracks-only", VariantType::Int, 0, {"Store only reconstructed MC tracks and their mothers/daughters. 0 -- off, != 0 -- on"}}}};
+      ConfigParamSpec{"reco-mctracks-only", VariantType::Int, 0, {"Store only reconstructed MC tracks and their mothers/daughters. 0 -- off, != 0 -- on"}},
+      ConfigParamSpec{"nthreads", VariantType::Int, 1, {"Number of threads filling the tables concurrently"}}}};
 }
 
 } // namespace o2::aodproducer
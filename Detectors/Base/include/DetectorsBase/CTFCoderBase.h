@@ -16,12 +16,15 @@
 #ifndef _ALICEO2_CTFCODER_BASE_H_
 #define _ALICEO2_CTFCODER_BASE_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 #include <TFile.h>
 #include <TTree.h>
 #include "DetectorsCommonDataFormats/DetID.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFDictHeader.h"
+#include "DetectorsCommonDataFormats/CoderCache.h"
 #include "rANS/rans.h"
 
 namespace o2
@@ -89,6 +92,22 @@ class CTFCoderBase
   void setMemMarginFactor(float v) { mMemMarginFactor = v > 1.f ? v : 1.f; }
   float getMemMarginFactor() const { return mMemMarginFactor; }
 
+  /// number of threads used to encode/decode the blocks of a CTF concurrently, 1 = serial processing
+  void setNThreads(int n) { mNThreads = n > 1 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
+  /// reuse the coders built from the data of previous TFs for the slots w/o external dictionary, while the
+  /// statistics drift (bits/symbol) stays below maxDrift. Negative value disables the cache.
+  void setCoderCacheDrift(double maxDrift)
+  {
+    if (maxDrift < 0.) {
+      mCoderCache.reset();
+    } else {
+      mCoderCache = std::make_unique<CoderCache>(mCoders.size(), maxDrift);
+    }
+  }
+  CoderCache* getCoderCache() const { return mCoderCache.get(); }
+
  protected:
   std::string getPrefix() const { return o2::utils::Str::concat_string(mDet.getName(), "_CTF: "); }
   void assignDictVersion(CTFDictHeader& h) const
@@ -98,11 +117,16 @@ class CTFCoderBase
     }
   }
   void checkDictVersion(const CTFDictHeader& h) const;
+  /// execute each of the jobs exactly once on up to getNThreads() threads. The OpenMP threads are kept alive
+  /// between the calls, so that no thread is created per TF. The first exception thrown by a job is rethrown.
+  void runParallel(const std::vector<std::function<void()>>& jobs) const;
 
   std::vector<std::shared_ptr<void>> mCoders; // encoders/decoders
   DetID mDet;
   CTFDictHeader mExtHeader; // external dictionary header
   float mMemMarginFactor = 1.0f; // factor for memory allocation in EncodedBlocks
+  int mNThreads = 1;             // number of threads for concurrent processing of the blocks
+  std::unique_ptr<CoderCache> mCoderCache; //! coders built from the data of previous TFs
 
   ClassDefNV(CTFCoderBase, 1);
 };
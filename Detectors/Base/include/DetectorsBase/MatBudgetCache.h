@@ -0,0 +1,93 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MatBudgetCache.h
+/// \brief Memoization of the material budget queries to the MatLayerCylSet
+
+#ifndef ALICEO2_MATBUDGETCACHE_H
+#define ALICEO2_MATBUDGETCACHE_H
+
+#include "DetectorsBase/MatCell.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace o2
+{
+namespace base
+{
+
+class MatLayerCylSet;
+
+/**********************************************************************
+ *                                                                    *
+ * Direct mapped cache of the material budget of the rays, keyed on   *
+ * their end points rounded to a given quantum. The matching and      *
+ * refit loops query again and again nearly the same rays, which are  *
+ * then served without walking the layers.                            *
+ * On a hit, <rho> is the one of the cached ray while the length and  *
+ * X/X0 are rescaled to the actual length of the ray.                 *
+ * Not thread safe: use one per thread, e.g. with threadLocal().      *
+ * A LUT replaced at the same address or modified in place is not     *
+ * detected: invalidateAll() must then be called, it resets the       *
+ * threadLocal() caches of all the threads at their next use.         *
+ *                                                                    *
+ **********************************************************************/
+class MatBudgetCache
+{
+ public:
+  static constexpr float DefaultQuantum = 0.01f; ///< default rounding of the end points, in cm
+  static constexpr int DefaultSizeLog2 = 12;     ///< default log2 of the number of cached rays
+
+  MatBudgetCache(const MatLayerCylSet* lut = nullptr, float quantum = DefaultQuantum, int sizeLog2 = DefaultSizeLog2);
+
+  /// \return the cache of the current thread for the LUT, reset if the LUT, the quantum or the generation changed
+  static MatBudgetCache& threadLocal(const MatLayerCylSet* lut, float quantum = DefaultQuantum);
+
+  /// invalidate the threadLocal() caches of all the threads, to be called when the LUT content changes
+  static void invalidateAll() { sGeneration++; }
+  static std::uint32_t getGeneration() { return sGeneration.load(std::memory_order_relaxed); }
+
+  MatBudget getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1);
+
+  void setLUT(const MatLayerCylSet* lut, float quantum = DefaultQuantum);
+  const MatLayerCylSet* getLUT() const { return mLUT; }
+  float getQuantum() const { return mQuantum; }
+
+  void clear();
+  void resetStats() { mHits = mMisses = 0; }
+  std::uint64_t getHits() const { return mHits; }
+  std::uint64_t getMisses() const { return mMisses; }
+  float getHitRate() const { return mHits + mMisses ? float(mHits) / (mHits + mMisses) : 0.f; }
+
+ private:
+  struct Entry {
+    std::array<std::int32_t, 6> key;
+    MatBudget budget;
+    bool valid = false;
+  };
+
+  const MatLayerCylSet* mLUT = nullptr;
+  float mQuantum = DefaultQuantum;
+  float mInvQuantum = 1.f / DefaultQuantum;
+  std::vector<Entry> mEntries;
+  std::uint64_t mHits = 0;
+  std::uint64_t mMisses = 0;
+  std::uint32_t mGeneration = 0; ///< value of sGeneration when the entries were last cleared
+
+  static std::atomic<std::uint32_t> sGeneration;
+};
+
+} // namespace base
+} // namespace o2
+
+#endif
@@ -26,6 +26,8 @@
 
 #ifndef GPUCA_GPUCODE
 #include <string>
+#include <vector>
+#include <gsl/span>
 #endif
 
 namespace o2
@@ -94,6 +96,20 @@ class PropagatorImpl
     return bzOnly ? propagateToX(track, x, getNominalBz(), maxSnp, maxStep, matCorr, tofInfo, signCorr) : PropagateToXBxByBz(track, x, maxSnp, maxStep, matCorr, tofInfo, signCorr);
   }
 
+#ifndef GPUCA_GPUCODE
+  // Propagates each track to its own X, as PropagateToXBxByBz (or propagateToX with the nominal Bz if bzOnly)
+  // would do one by one. The tracks are advanced together step by step: at each step the positions of all the
+  // tracks still propagating are unpacked to arrays, then the field and the material budget are queried for
+  // all of them in a row. The results do not depend on the batching.
+  // The tracks are still processed one after the other, there is no vectorisation: this is not faster than calling
+  // the single track methods in a loop, but gives the field and material queries a single place to be batched.
+  // status[i] is set to the success of the propagation of tracks[i], returns the number of successes.
+  template <typename track_T>
+  int propagateBatchToX(gsl::span<track_T> tracks, gsl::span<const value_type> xToGo, std::vector<bool>& status, bool bzOnly = false,
+                        value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                        gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0) const;
+#endif
+
   GPUd() bool propagateToDCA(const o2::dataformats::VertexBase& vtx, o2::track::TrackParametrizationWithError<value_type>& track, value_type bZ,
                              value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
                              o2::dataformats::DCA* dcaInfo = nullptr, track::TrackLTIntegral* tofInfo = nullptr,
@@ -122,8 +138,17 @@ class PropagatorImpl
   // Bz at the origin
   GPUd() value_type getNominalBz() const { return mBz; }
 
-  GPUd() void setMatLUT(const o2::base::MatLayerCylSet* lut) { mMatLUT = lut; }
+  GPUd() void setMatLUT(const o2::base::MatLayerCylSet* lut)
+  {
+    mMatLUT = lut;
+#ifndef GPUCA_GPUCODE
+    invalidateMatLUTCache(); // the new LUT may live at the address of the previous one
+#endif
+  }
   GPUd() const o2::base::MatLayerCylSet* getMatLUT() const { return mMatLUT; }
+  // LUT queries of the host code go through a per thread cache keyed on the end points rounded to quantum (cm), 0 disables it
+  void setMatLUTCacheQuantum(float quantum) { mMatLUTCacheQuantum = quantum; }
+  GPUd() float getMatLUTCacheQuantum() const { return mMatLUTCacheQuantum; }
   GPUd() void setGPUField(const o2::gpu::GPUTPCGMPolynomialField* field) { mGPUField = field; }
   GPUd() const o2::gpu::GPUTPCGMPolynomialField* getGPUField() const { return mGPUField; }
   GPUd() void setBz(value_type bz) { mBz = bz; }
@@ -151,6 +176,7 @@ class PropagatorImpl
 #ifndef GPUCA_GPUCODE
   PropagatorImpl(bool uninitialized = false);
   ~PropagatorImpl() = default;
+  static void invalidateMatLUTCache();
 #endif
 
   template <typename T>
@@ -161,6 +187,7 @@ class PropagatorImpl
   value_type mBz = 0;                                  ///< nominal field
 
   const o2::base::MatLayerCylSet* mMatLUT = nullptr;           // externally set LUT
+  float mMatLUTCacheQuantum = 0;                               // rounding of the cached LUT queries, no cache if 0
   const o2::gpu::GPUTPCGMPolynomialField* mGPUField = nullptr; // externally set GPU Field
 
   ClassDefNV(PropagatorImpl, 0);
@@ -15,6 +15,8 @@
 
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "DetectorsBase/CTFCoderBase.h"
+#include <algorithm>
+#include <exception>
 #include <filesystem>
 
 using namespace o2::ctf;
@@ -73,3 +75,34 @@ void CTFCoderBase::checkDictVersion(const CTFDictHeader& h) const
     }
   }
 }
+
+void CTFCoderBase::runParallel(const std::vector<std::function<void()>>& jobs) const
+{
+  const int nJobs = jobs.size();
+  const int nThreads = std::min(mNThreads, nJobs);
+  if (nThreads < 2) {
+    for (const auto& job : jobs) {
+      job();
+    }
+    return;
+  }
+  std::exception_ptr error;
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int i = 0; i < nJobs; i++) {
+    try { // exceptions must not escape the OpenMP region
+      jobs[i]();
+    } catch (...) {
+#ifdef WITH_OPENMP
+#pragma omp critical(ctf_run_parallel_error)
+#endif
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
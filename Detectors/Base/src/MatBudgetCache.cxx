@@ -0,0 +1,87 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MatBudgetCache.cxx
+/// \brief Implementation of the memoization of the material budget queries
+
+#include "DetectorsBase/MatBudgetCache.h"
+#include "DetectorsBase/MatLayerCylSet.h"
+#include <cmath>
+
+using namespace o2::base;
+
+std::atomic<std::uint32_t> MatBudgetCache::sGeneration{0};
+
+//________________________________________________________________________________
+MatBudgetCache::MatBudgetCache(const MatLayerCylSet* lut, float quantum, int sizeLog2) : mEntries(size_t(1) << sizeLog2)
+{
+  setLUT(lut, quantum);
+}
+
+//________________________________________________________________________________
+MatBudgetCache& MatBudgetCache::threadLocal(const MatLayerCylSet* lut, float quantum)
+{
+  thread_local MatBudgetCache cache;
+  if (cache.mLUT != lut || cache.mQuantum != quantum || cache.mGeneration != getGeneration()) {
+    cache.setLUT(lut, quantum);
+  }
+  return cache;
+}
+
+//________________________________________________________________________________
+void MatBudgetCache::setLUT(const MatLayerCylSet* lut, float quantum)
+{
+  mLUT = lut;
+  mQuantum = quantum > 0.f ? quantum : DefaultQuantum;
+  mInvQuantum = 1.f / mQuantum;
+  clear();
+}
+
+//________________________________________________________________________________
+void MatBudgetCache::clear()
+{
+  for (auto& entry : mEntries) {
+    entry.valid = false;
+  }
+  mGeneration = getGeneration();
+  resetStats();
+}
+
+//________________________________________________________________________________
+MatBudget MatBudgetCache::getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1)
+{
+  // get material budget traversed on the line between point0 and point1, from the cache if possible
+  const float coordinates[6] = {x0, y0, z0, x1, y1, z1};
+  std::array<std::int32_t, 6> key;
+  std::uint64_t hash = 0;
+  for (int i = 0; i < 6; i++) {
+    key[i] = std::int32_t(std::lround(coordinates[i] * mInvQuantum));
+    hash = (hash ^ std::uint32_t(key[i])) * 0x9E3779B97F4A7C15ULL;
+  }
+  auto& entry = mEntries[(hash >> 32) & (mEntries.size() - 1)];
+  const float dx = x1 - x0, dy = y1 - y0, dz = z1 - z0;
+  const float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+  if (entry.valid && entry.key == key) {
+    mHits++;
+    MatBudget rval = entry.budget;
+    if (rval.length > 0.f) { // X/X0 is integrated along the ray, <rho> is not
+      rval.meanX2X0 *= length / rval.length;
+    }
+    rval.length = length;
+    return rval;
+  }
+  mMisses++;
+  entry.key = key;
+  entry.budget = mLUT->getMatBudget(x0, y0, z0, x1, y1, z1);
+  entry.valid = true;
+  return entry.budget;
+}
@@ -21,12 +21,14 @@ using namespace o2::gpu;
 
 #if !defined(GPUCA_GPUCODE)
 #include "Field/MagFieldFast.h" // Don't use this on the GPU
+#include <type_traits>
 #endif
 
 #if !defined(GPUCA_STANDALONE) && !defined(GPUCA_GPUCODE)
 #include "Field/MagneticField.h"
 #include "DataFormatsParameters/GRPObject.h"
 #include "DetectorsBase/GeometryManager.h"
+#include "DetectorsBase/MatBudgetCache.h"
 #include <FairRunAna.h> // eventually will get rid of it
 #include <TGeoGlobalMagField.h>
 
@@ -585,6 +587,146 @@ GPUd() void PropagatorImpl<value_T>::estimateLTFast(o2::track::TrackLTIntegral&
   lt.addStep(length, trc.getP2Inv());
 }
 
+#ifndef GPUCA_GPUCODE
+//_______________________________________________________________________
+template <typename value_T>
+template <typename track_T>
+int PropagatorImpl<value_T>::propagateBatchToX(gsl::span<track_T> tracks, gsl::span<const value_type> xToGo, std::vector<bool>& status, bool bzOnly,
+                                               value_type maxSnp, value_type maxStep, PropagatorImpl<value_T>::MatCorrType matCorr,
+                                               gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const
+{
+  //----------------------------------------------------------------
+  //
+  // Propagates the tracks to the planes X=xToGo[i] (cm), step by step for all the tracks together.
+  // Each track goes through exactly the same operations as with PropagateToXBxByBz or propagateToX,
+  // only the order in which the tracks are processed changes.
+  //
+  // tofInfo  - optional containers for track length and PID-dependent TOF integration, one per track
+  //
+  // matCorr  - material correction type, it is up to the user to make sure the pointer is attached (if LUT is requested)
+  //----------------------------------------------------------------
+  constexpr bool withCov = std::is_same_v<track_T, TrackParCov_t>;
+  const value_type Epsilon = 0.00001;
+  const size_t nTracks = tracks.size();
+  status.assign(nTracks, false);
+  if (xToGo.size() != nTracks || (!tofInfo.empty() && tofInfo.size() != nTracks)) {
+    LOG(ERROR) << "Batch propagation of " << nTracks << " tracks requires as many X values and TOF integrals";
+    return 0;
+  }
+
+  // the lanes of the tracks still propagating, with their positions and fields of the current step
+  std::vector<int> active, dirs(nTracks), signs(nTracks);
+  std::vector<value_type> x0(nTracks), y0(nTracks), z0(nTracks), bx(nTracks), by(nTracks), bz(nTracks);
+  std::vector<MatBudget> budgets(matCorr != MatCorrType::USEMatCorrNONE ? nTracks : 0);
+  active.reserve(nTracks);
+  int nDone = 0;
+  for (size_t i = 0; i < nTracks; i++) {
+    auto dx = xToGo[i] - tracks[i].getX();
+    dirs[i] = dx > 0.f ? 1 : -1;
+    signs[i] = signCorr ? signCorr : -dirs[i]; // sign of eloss correction is not imposed
+    if (math_utils::detail::abs<value_type>(dx) > Epsilon) {
+      active.push_back(i);
+    } else {
+      tracks[i].setX(xToGo[i]);
+      status[i] = true;
+      nDone++;
+    }
+  }
+
+  while (!active.empty()) {
+    for (auto i : active) {
+      auto xyz0 = tracks[i].getXYZGlo();
+      x0[i] = xyz0.X();
+      y0[i] = xyz0.Y();
+      z0[i] = xyz0.Z();
+    }
+    if (!bzOnly) {
+      value_type b[3];
+      for (auto i : active) {
+        getFieldXYZ(math_utils::Point3D<value_type>(x0[i], y0[i], z0[i]), b);
+        bx[i] = b[0];
+        by[i] = b[1];
+        bz[i] = b[2];
+      }
+    }
+
+    // propagation of the parameters, the failed tracks are dropped from the lanes
+    size_t nActive = 0;
+    for (auto i : active) {
+      auto& track = tracks[i];
+      auto dx = xToGo[i] - track.getX();
+      auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
+      if (dirs[i] < 0) {
+        step = -step;
+      }
+      auto x = track.getX() + step;
+      bool ok;
+      if (bzOnly) {
+        if constexpr (withCov) {
+          ok = track.propagateTo(x, getNominalBz());
+        } else {
+          ok = track.propagateParamTo(x, getNominalBz());
+        }
+      } else {
+        gpu::gpustd::array<value_type, 3> b{bx[i], by[i], bz[i]};
+        if constexpr (withCov) {
+          ok = track.propagateTo(x, b);
+        } else {
+          ok = track.propagateParamTo(x, b);
+        }
+      }
+      if (ok && (maxSnp <= 0 || math_utils::detail::abs<value_type>(track.getSnp()) < maxSnp)) {
+        active[nActive++] = i;
+      }
+    }
+    active.resize(nActive);
+
+    if (matCorr != MatCorrType::USEMatCorrNONE) {
+      for (auto i : active) {
+        budgets[i] = getMatBudget(matCorr, math_utils::Point3D<value_type>(x0[i], y0[i], z0[i]), tracks[i].getXYZGlo());
+      }
+    }
+
+    nActive = 0;
+    for (auto i : active) {
+      auto& track = tracks[i];
+      if (matCorr != MatCorrType::USEMatCorrNONE) {
+        const auto& mb = budgets[i];
+        bool ok;
+        if constexpr (withCov) {
+          ok = track.correctForMaterial(mb.meanX2X0, mb.getXRho(signs[i]));
+        } else {
+          ok = track.correctForELoss(bzOnly ? mb.getXRho(signs[i]) : ((signs[i] < 0) ? -mb.length : mb.length) * mb.meanRho);
+        }
+        if (!ok) {
+          continue;
+        }
+        if (!tofInfo.empty()) {
+          tofInfo[i].addStep(mb.length, track.getP2Inv()); // fill L,ToF info using already calculated step length
+          tofInfo[i].addX2X0(mb.meanX2X0);
+          if (withCov && !bzOnly) {
+            tofInfo[i].addXRho(mb.getXRho(signs[i]));
+          }
+        }
+      } else if (!tofInfo.empty()) { // if tofInfo filling was requested w/o material correction, we need to calculate the step lenght
+        auto xyz1 = track.getXYZGlo();
+        math_utils::Vector3D<value_type> stepV(xyz1.X() - x0[i], xyz1.Y() - y0[i], xyz1.Z() - z0[i]);
+        tofInfo[i].addStep(stepV.R(), track.getP2Inv());
+      }
+      if (math_utils::detail::abs<value_type>(xToGo[i] - track.getX()) > Epsilon) {
+        active[nActive++] = i;
+      } else {
+        track.setX(xToGo[i]);
+        status[i] = true;
+        nDone++;
+      }
+    }
+    active.resize(nActive);
+  }
+  return nDone;
+}
+#endif
+
 //____________________________________________________________
 template <typename value_T>
 GPUd() MatBudget PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type>::MatCorrType corrType, const math_utils::Point3D<value_type>& p0, const math_utils::Point3D<value_type>& p1) const
@@ -593,10 +735,24 @@ GPUd() MatBudget PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type
   if (corrType == MatCorrType::USEMatCorrTGeo || !mMatLUT) {
     return GeometryManager::meanMaterialBudget(p0, p1);
   }
+  if (mMatLUTCacheQuantum > 0.f) {
+    return MatBudgetCache::threadLocal(mMatLUT, mMatLUTCacheQuantum).getMatBudget(p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z());
+  }
 #endif
   return mMatLUT->getMatBudget(p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z());
 }
 
+#ifndef GPUCA_GPUCODE
+//____________________________________________________________
+template <typename value_T>
+void PropagatorImpl<value_T>::invalidateMatLUTCache()
+{
+#ifndef GPUCA_STANDALONE
+  MatBudgetCache::invalidateAll();
+#endif
+}
+#endif
+
 template <typename value_T>
 template <typename T>
 GPUd() void PropagatorImpl<value_T>::getFieldXYZImpl(const math_utils::Point3D<T> xyz, T* bxyz) const
@@ -647,4 +803,14 @@ template class PropagatorImpl<float>;
 #ifndef GPUCA_GPUCODE_DEVICE
 template class PropagatorImpl<double>;
 #endif
+#ifndef GPUCA_GPUCODE
+template int PropagatorImpl<float>::propagateBatchToX<PropagatorImpl<float>::TrackParCov_t>(gsl::span<PropagatorImpl<float>::TrackParCov_t>, gsl::span<const float>, std::vector<bool>&, bool,
+                                                                                           float, float, PropagatorImpl<float>::MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+template int PropagatorImpl<float>::propagateBatchToX<PropagatorImpl<float>::TrackPar_t>(gsl::span<PropagatorImpl<float>::TrackPar_t>, gsl::span<const float>, std::vector<bool>&, bool,
+                                                                                        float, float, PropagatorImpl<float>::MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+template int PropagatorImpl<double>::propagateBatchToX<PropagatorImpl<double>::TrackParCov_t>(gsl::span<PropagatorImpl<double>::TrackParCov_t>, gsl::span<const double>, std::vector<bool>&, bool,
+                                                                                             double, double, PropagatorImpl<double>::MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+template int PropagatorImpl<double>::propagateBatchToX<PropagatorImpl<double>::TrackPar_t>(gsl::span<PropagatorImpl<double>::TrackPar_t>, gsl::span<const double>, std::vector<bool>&, bool,
+                                                                                          double, double, PropagatorImpl<double>::MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+#endif
 } // namespace o2::base
@@ -0,0 +1,108 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_MatBudgetCache.cxx
+/// \brief Hit rate and speed up of the MatBudgetCache over the direct MatLayerCylSet queries
+///
+/// The material LUT is read from the file given by the MATBUD_FILE environment variable (matbud.root by default),
+/// as produced by test/buildMatBudLUT.C. The queries mimic a matching loop: each track segment is queried
+/// several times, with end points differing by less than the cache quantum.
+
+#include "benchmark/benchmark.h"
+#include "DetectorsBase/MatBudgetCache.h"
+#include "DetectorsBase/MatLayerCylSet.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace o2::base;
+
+namespace
+{
+using RayPoints = std::array<float, 6>;
+
+const MatLayerCylSet* getLUT()
+{
+  static std::unique_ptr<MatLayerCylSet> lut = []() {
+    const char* fileName = std::getenv("MATBUD_FILE");
+    return std::unique_ptr<MatLayerCylSet>(MatLayerCylSet::loadFromFile(fileName ? fileName : "matbud.root"));
+  }();
+  return lut.get();
+}
+
+/// nSegments radial segments of 2 cm in the ITS-TPC region, each queried nRepeat times with a jitter
+std::vector<RayPoints> generateQueries(int nSegments, int nRepeat, float jitter)
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> phiDist(0.f, 2.f * M_PI), rDist(2.f, 70.f), tglDist(-1.f, 1.f), jitterDist(-jitter, jitter);
+  std::vector<RayPoints> queries;
+  queries.reserve(nSegments * nRepeat);
+  for (int iSeg = 0; iSeg < nSegments; iSeg++) {
+    float phi = phiDist(gen), r = rDist(gen), tgl = tglDist(gen);
+    RayPoints ray{r * std::cos(phi), r * std::sin(phi), r * tgl, (r + 2.f) * std::cos(phi), (r + 2.f) * std::sin(phi), (r + 2.f) * tgl};
+    for (int iRep = 0; iRep < nRepeat; iRep++) {
+      auto query = ray;
+      for (auto& coordinate : query) {
+        coordinate += jitterDist(gen);
+      }
+      queries.push_back(query);
+    }
+  }
+  std::shuffle(queries.begin(), queries.begin() + queries.size() / 2, gen); // the repetitions are not always consecutive
+  return queries;
+}
+} // namespace
+
+static void BM_MatBudgetDirect(benchmark::State& state)
+{
+  auto lut = getLUT();
+  if (!lut) {
+    state.SkipWithError("no material LUT, set MATBUD_FILE");
+    return;
+  }
+  auto queries = generateQueries(1000, state.range(0), 1.e-3);
+  for (auto _ : state) {
+    for (auto& q : queries) {
+      benchmark::DoNotOptimize(lut->getMatBudget(q[0], q[1], q[2], q[3], q[4], q[5]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_MatBudgetCached(benchmark::State& state)
+{
+  auto lut = getLUT();
+  if (!lut) {
+    state.SkipWithError("no material LUT, set MATBUD_FILE");
+    return;
+  }
+  auto queries = generateQueries(1000, state.range(0), 1.e-3);
+  MatBudgetCache cache(lut);
+  double hitRate = 0;
+  for (auto _ : state) {
+    cache.clear();
+    for (auto& q : queries) {
+      benchmark::DoNotOptimize(cache.getMatBudget(q[0], q[1], q[2], q[3], q[4], q[5]));
+    }
+    hitRate += cache.getHitRate();
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.counters["hitRate"] = hitRate / state.iterations();
+}
+
+BENCHMARK(BM_MatBudgetDirect)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_MatBudgetCached)->Arg(1)->Arg(4)->Arg(16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_PropagatorBatch.cxx
+/// \brief Propagation of a set of tracks one by one and with propagateBatchToX, on the toy material geometry
+
+#include "benchmark/benchmark.h"
+#include "buildToyMatBudLUT.h"
+#include "ReconstructionDataFormats/Track.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace o2::base;
+using MatCorrType = Propagator::MatCorrType;
+
+namespace
+{
+Propagator* getPropagator()
+{
+  static auto lut = test::buildToyMatBudLUT();
+  auto prop = test::getToyPropagator();
+  prop->setMatLUT(lut.get());
+  return prop;
+}
+
+std::vector<o2::track::TrackParCov> generateTracks(int nTracks)
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> alphaDist(-M_PI, M_PI), snpDist(-0.3, 0.3), tglDist(-0.5, 0.5), q2ptDist(-2., 2.);
+  const std::array<float, 15> cov{1e-4, 0, 1e-4, 0, 0, 1e-5, 0, 0, 0, 1e-5, 0, 0, 0, 0, 1e-4};
+  std::vector<o2::track::TrackParCov> tracks;
+  tracks.reserve(nTracks);
+  for (int i = 0; i < nTracks; i++) {
+    tracks.emplace_back(5.f, alphaDist(gen), std::array<float, 5>{0.f, 0.f, snpDist(gen), tglDist(gen), q2ptDist(gen)}, cov);
+  }
+  return tracks;
+}
+} // namespace
+
+static void BM_PropagateSingle(benchmark::State& state)
+{
+  auto prop = getPropagator();
+  const auto tracks = generateTracks(state.range(0));
+  const auto matCorr = static_cast<MatCorrType>(state.range(1));
+  for (auto _ : state) {
+    auto work = tracks;
+    for (auto& track : work) {
+      benchmark::DoNotOptimize(prop->PropagateToXBxByBz(track, 40.f, Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+static void BM_PropagateBatch(benchmark::State& state)
+{
+  auto prop = getPropagator();
+  const auto tracks = generateTracks(state.range(0));
+  const auto matCorr = static_cast<MatCorrType>(state.range(1));
+  const std::vector<float> xToGo(tracks.size(), 40.f);
+  std::vector<bool> status;
+  for (auto _ : state) {
+    auto work = tracks;
+    benchmark::DoNotOptimize(prop->propagateBatchToX(gsl::span<o2::track::TrackParCov>(work), gsl::span<const float>(xToGo), status, false,
+                                                     Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr));
+  }
+  state.SetItemsProcessed(state.iterations() * tracks.size());
+}
+
+BENCHMARK(BM_PropagateSingle)->Args({64, int(MatCorrType::USEMatCorrNONE)})->Args({1024, int(MatCorrType::USEMatCorrNONE)})->Args({1024, int(MatCorrType::USEMatCorrLUT)});
+BENCHMARK(BM_PropagateBatch)->Args({64, int(MatCorrType::USEMatCorrNONE)})->Args({1024, int(MatCorrType::USEMatCorrNONE)})->Args({1024, int(MatCorrType::USEMatCorrLUT)});
+
+BENCHMARK_MAIN();
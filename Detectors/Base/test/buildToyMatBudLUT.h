@@ -0,0 +1,77 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file buildToyMatBudLUT.h
+/// \brief A small TGeo geometry and its material LUT, for the tests which cannot load the full ALICE geometry
+///
+/// Two cylinders in vacuum: a full silicon one at r = 10 cm and an aluminium half cylinder (0 < phi < pi) at
+/// r = 30 cm, so that the material budget depends on both the radius and the azimuth.
+
+#ifndef ALICEO2_BUILDTOYMATBUDLUT_H
+#define ALICEO2_BUILDTOYMATBUDLUT_H
+
+#include "DetectorsBase/MatLayerCylSet.h"
+#include "DetectorsBase/Propagator.h"
+#include "Field/MagneticField.h"
+
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+
+#include <memory>
+
+namespace o2::base::test
+{
+
+inline void buildToyGeometry()
+{
+  if (gGeoManager) {
+    return;
+  }
+  auto geom = new TGeoManager("toy", "toy geometry for the material budget");
+  auto vacuum = new TGeoMedium("Vacuum", 1, new TGeoMaterial("Vacuum", 0, 0, 0));
+  auto silicon = new TGeoMedium("Si", 2, new TGeoMaterial("Si", 28.09, 14, 2.33));
+  auto aluminium = new TGeoMedium("Al", 3, new TGeoMaterial("Al", 26.98, 13, 2.7));
+  auto world = geom->MakeBox("World", vacuum, 200, 200, 200);
+  geom->SetTopVolume(world);
+  world->AddNode(geom->MakeTube("Inner", silicon, 10., 10.5, 50.), 1);
+  world->AddNode(geom->MakeTubs("Outer", aluminium, 30., 31., 50., 0., 180.), 1);
+  geom->CloseGeometry();
+}
+
+/// \return the LUT of the toy geometry, built if needed
+inline std::unique_ptr<MatLayerCylSet> buildToyMatBudLUT()
+{
+  buildToyGeometry();
+  auto lut = std::make_unique<MatLayerCylSet>();
+  lut->addLayer(9.5, 11., 55., 5., 1.);
+  lut->addLayer(29.5, 31.5, 55., 5., 2.);
+  lut->populateFromTGeo(3);
+  lut->optimizePhiSlices();
+  lut->flatten();
+  return lut;
+}
+
+/// \return the propagator on the toy geometry in a uniform 5 kG field
+inline Propagator* getToyPropagator()
+{
+  buildToyGeometry();
+  if (!TGeoGlobalMagField::Instance()->GetField()) {
+    TGeoGlobalMagField::Instance()->SetField(o2::field::MagneticField::createNominalField(5, true));
+    TGeoGlobalMagField::Instance()->Lock();
+  }
+  return Propagator::Instance();
+}
+
+} // namespace o2::base::test
+
+#endif
@@ -0,0 +1,112 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testMatBudgetCache.cxx
+/// \brief Unit test of the MatBudgetCache on the toy material LUT
+
+#define BOOST_TEST_MODULE Test MatBudgetCache
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "buildToyMatBudLUT.h"
+#include "DetectorsBase/MatBudgetCache.h"
+
+#include <cmath>
+
+using namespace o2::base;
+
+namespace
+{
+
+// Exactly representable, so that the end points below are far from the rounding boundaries
+constexpr float Quantum = 0.25f;
+
+// A ray crossing both cylinders of the toy geometry
+constexpr float X0 = 8.f, Y0 = 4.f, Z0 = 1.f, X1 = 33.f, Y1 = 16.5f, Z1 = 5.f;
+
+void checkEqual(const MatBudget& expected, const MatBudget& result)
+{
+  BOOST_CHECK_EQUAL(expected.meanRho, result.meanRho);
+  BOOST_CHECK_EQUAL(expected.meanX2X0, result.meanX2X0);
+  BOOST_CHECK_EQUAL(expected.length, result.length);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(MatBudgetCache_test)
+{
+  auto lut = test::buildToyMatBudLUT();
+  MatBudgetCache cache(lut.get(), Quantum);
+
+  // A miss gives the LUT answer
+  const auto direct = lut->getMatBudget(X0, Y0, Z0, X1, Y1, Z1);
+  BOOST_REQUIRE(direct.meanX2X0 > 0.f);
+  checkEqual(direct, cache.getMatBudget(X0, Y0, Z0, X1, Y1, Z1));
+  BOOST_CHECK_EQUAL(cache.getMisses(), 1);
+  BOOST_CHECK_EQUAL(cache.getHits(), 0);
+
+  // An end point moved by less than half a quantum hits, with the length and X/X0 rescaled to the actual ray
+  const float shift = 0.2f * Quantum;
+  const auto hit = cache.getMatBudget(X0, Y0, Z0, X1 + shift, Y1, Z1);
+  BOOST_CHECK_EQUAL(cache.getHits(), 1);
+  const float length = std::sqrt((X1 + shift - X0) * (X1 + shift - X0) + (Y1 - Y0) * (Y1 - Y0) + (Z1 - Z0) * (Z1 - Z0));
+  BOOST_CHECK_CLOSE(hit.length, length, 1e-4);
+  BOOST_CHECK_CLOSE(hit.meanX2X0, direct.meanX2X0 * length / direct.length, 1e-4);
+  BOOST_CHECK_EQUAL(hit.meanRho, direct.meanRho);
+
+  // End points more than one quantum away miss and give the LUT answer
+  for (float distance : {1.5f * Quantum, -1.5f * Quantum, 4.f * Quantum}) {
+    const auto misses = cache.getMisses();
+    checkEqual(lut->getMatBudget(X0 + distance, Y0, Z0, X1, Y1, Z1), cache.getMatBudget(X0 + distance, Y0, Z0, X1, Y1, Z1));
+    checkEqual(lut->getMatBudget(X0, Y0, Z0, X1, Y1, Z1 + distance), cache.getMatBudget(X0, Y0, Z0, X1, Y1, Z1 + distance));
+    BOOST_CHECK_EQUAL(cache.getMisses(), misses + 2);
+  }
+  BOOST_CHECK_EQUAL(cache.getHits(), 1);
+
+  // setLUT drops the cached rays, also for the same LUT
+  cache.setLUT(lut.get(), Quantum);
+  BOOST_CHECK_EQUAL(cache.getMisses(), 0);
+  checkEqual(direct, cache.getMatBudget(X0, Y0, Z0, X1, Y1, Z1));
+  BOOST_CHECK_EQUAL(cache.getMisses(), 1);
+  BOOST_CHECK_EQUAL(cache.getHits(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MatBudgetCacheThreadLocal_test)
+{
+  auto lut = test::buildToyMatBudLUT();
+  auto& cache = MatBudgetCache::threadLocal(lut.get(), Quantum);
+  cache.getMatBudget(X0, Y0, Z0, X1, Y1, Z1);
+  BOOST_CHECK_EQUAL(cache.getMisses(), 1);
+
+  // Same LUT and quantum: the cached rays are kept
+  BOOST_CHECK_EQUAL(&MatBudgetCache::threadLocal(lut.get(), Quantum), &cache);
+  cache.getMatBudget(X0, Y0, Z0, X1, Y1, Z1);
+  BOOST_CHECK_EQUAL(cache.getHits(), 1);
+
+  // A LUT replaced at the same address is only seen through the generation
+  MatBudgetCache::invalidateAll();
+  MatBudgetCache::threadLocal(lut.get(), Quantum);
+  BOOST_CHECK_EQUAL(cache.getHits(), 0);
+  BOOST_CHECK_EQUAL(cache.getMisses(), 0);
+  cache.getMatBudget(X0, Y0, Z0, X1, Y1, Z1);
+  BOOST_CHECK_EQUAL(cache.getMisses(), 1);
+
+  // which the propagator bumps when its LUT is set
+  auto prop = test::getToyPropagator();
+  const auto generation = MatBudgetCache::getGeneration();
+  prop->setMatLUT(lut.get());
+  BOOST_CHECK_NE(MatBudgetCache::getGeneration(), generation);
+  MatBudgetCache::threadLocal(lut.get(), Quantum);
+  BOOST_CHECK_EQUAL(cache.getMisses(), 0);
+  prop->setMatLUT(nullptr);
+}
@@ -0,0 +1,148 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testPropagatorBatch.cxx
+/// \brief Checks that the batch propagation gives exactly the results of the propagation track by track
+
+#define BOOST_TEST_MODULE Test Propagator batch
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "buildToyMatBudLUT.h"
+#include "ReconstructionDataFormats/Track.h"
+#include "ReconstructionDataFormats/TrackLTIntegral.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace o2::base;
+using MatCorrType = Propagator::MatCorrType;
+
+namespace
+{
+
+/// Random tracks at x = 5 cm, plus some which cannot reach their X within the sin(phi) limit and one already there
+std::vector<o2::track::TrackParCov> generateTracks(std::vector<float>& xToGo)
+{
+  std::mt19937 gen(4321);
+  std::uniform_real_distribution<float> alphaDist(-M_PI, M_PI), snpDist(-0.3, 0.3), tglDist(-0.5, 0.5), q2ptDist(-2., 2.), xDist(20., 40.);
+  const std::array<float, 15> cov{1e-4, 0, 1e-4, 0, 0, 1e-5, 0, 0, 0, 1e-5, 0, 0, 0, 0, 1e-4};
+  std::vector<o2::track::TrackParCov> tracks;
+  for (int i = 0; i < 100; i++) {
+    tracks.emplace_back(5.f, alphaDist(gen), std::array<float, 5>{0.1f, 0.2f, snpDist(gen), tglDist(gen), q2ptDist(gen)}, cov);
+    xToGo.push_back(i % 10 ? xDist(gen) : 2.f); // some are propagated inwards
+  }
+  for (float q2pt : {-10.f, 10.f}) {
+    tracks.emplace_back(5.f, 0.f, std::array<float, 5>{0.f, 0.f, 0.8f, 0.f, q2pt}, cov);
+    xToGo.push_back(40.f);
+  }
+  tracks.emplace_back(5.f, 0.f, std::array<float, 5>{0.f, 0.f, 0.1f, 0.1f, 1.f}, cov);
+  xToGo.push_back(5.f);
+  return tracks;
+}
+
+template <typename track_T>
+void checkEqual(const track_T& expected, const track_T& result)
+{
+  BOOST_CHECK_EQUAL(expected.getX(), result.getX());
+  BOOST_CHECK_EQUAL(expected.getAlpha(), result.getAlpha());
+  for (int i = 0; i < 5; i++) {
+    BOOST_CHECK_EQUAL(expected.getParams()[i], result.getParams()[i]);
+  }
+  if constexpr (std::is_same_v<track_T, o2::track::TrackParCov>) {
+    for (int i = 0; i < 15; i++) {
+      BOOST_CHECK_EQUAL(expected.getCov()[i], result.getCov()[i]);
+    }
+  }
+}
+
+void checkEqual(const o2::track::TrackLTIntegral& expected, const o2::track::TrackLTIntegral& result)
+{
+  BOOST_CHECK_EQUAL(expected.getL(), result.getL());
+  BOOST_CHECK_EQUAL(expected.getX2X0(), result.getX2X0());
+  BOOST_CHECK_EQUAL(expected.getXRho(), result.getXRho());
+  for (int i = 0; i < o2::track::TrackLTIntegral::getNTOFs(); i++) {
+    BOOST_CHECK_EQUAL(expected.getTOF(i), result.getTOF(i));
+  }
+}
+
+template <typename track_T>
+void compareBatch(const std::vector<track_T>& tracks, const std::vector<float>& xToGo, bool bzOnly, bool withTOF, MatCorrType matCorr)
+{
+  BOOST_TEST_MESSAGE("bzOnly " << bzOnly << ", tofInfo " << withTOF << ", material " << int(matCorr));
+  auto prop = Propagator::Instance();
+  const size_t nTracks = tracks.size();
+
+  auto single = tracks;
+  std::vector<o2::track::TrackLTIntegral> singleTOF(nTracks);
+  std::vector<bool> singleStatus(nTracks);
+  int nSingle = 0;
+  for (size_t i = 0; i < nTracks; i++) {
+    auto* tof = withTOF ? &singleTOF[i] : nullptr;
+    if (bzOnly) {
+      singleStatus[i] = prop->propagateToX(single[i], xToGo[i], prop->getNominalBz(), Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr, tof);
+    } else {
+      singleStatus[i] = prop->PropagateToXBxByBz(single[i], xToGo[i], Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr, tof);
+    }
+    nSingle += singleStatus[i];
+  }
+
+  auto batch = tracks;
+  std::vector<o2::track::TrackLTIntegral> batchTOF(withTOF ? nTracks : 0);
+  std::vector<bool> batchStatus;
+  int nBatch = prop->propagateBatchToX(gsl::span<track_T>(batch), gsl::span<const float>(xToGo), batchStatus, bzOnly,
+                                       Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr, gsl::span<o2::track::TrackLTIntegral>(batchTOF));
+
+  BOOST_CHECK_EQUAL(nBatch, nSingle);
+  BOOST_CHECK(nSingle < int(nTracks)); // the failing tracks are covered
+  BOOST_CHECK(nSingle > int(nTracks) / 2);
+  BOOST_REQUIRE_EQUAL(batchStatus.size(), nTracks);
+  for (size_t i = 0; i < nTracks; i++) {
+    BOOST_CHECK_EQUAL(bool(batchStatus[i]), bool(singleStatus[i]));
+    checkEqual(single[i], batch[i]);
+    if (withTOF) {
+      checkEqual(singleTOF[i], batchTOF[i]);
+    }
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PropagatorBatch_test)
+{
+  auto prop = test::getToyPropagator();
+  auto lut = test::buildToyMatBudLUT();
+  prop->setMatLUT(lut.get());
+
+  std::vector<float> xToGo;
+  auto tracksCov = generateTracks(xToGo);
+  std::vector<o2::track::TrackPar> tracks(tracksCov.begin(), tracksCov.end());
+
+  for (auto matCorr : {MatCorrType::USEMatCorrNONE, MatCorrType::USEMatCorrLUT}) {
+    for (bool bzOnly : {false, true}) {
+      for (bool withTOF : {false, true}) {
+        compareBatch(tracksCov, xToGo, bzOnly, withTOF, matCorr);
+        compareBatch(tracks, xToGo, bzOnly, withTOF, matCorr);
+      }
+    }
+  }
+
+  // A mismatch of the sizes is refused
+  std::vector<bool> status;
+  std::vector<float> tooFew(xToGo.begin(), xToGo.end() - 1);
+  BOOST_CHECK_EQUAL(prop->propagateBatchToX(gsl::span<o2::track::TrackParCov>(tracksCov), gsl::span<const float>(tooFew), status), 0);
+  prop->setMatLUT(nullptr);
+}
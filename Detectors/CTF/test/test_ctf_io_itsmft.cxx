@@ -22,10 +22,79 @@
 #include <TFile.h>
 #include <TRandom.h>
 #include <TStopwatch.h>
+#include <algorithm>
 #include <cstring>
 
 using namespace o2::itsmft;
 
+namespace
+{
+struct ClustersTF {
+  std::vector<ROFRecord> rofRecVec;
+  std::vector<CompClusterExt> cclusVec;
+  std::vector<unsigned char> pattVec;
+};
+
+// generate a TF with nROFs ROFs, with cluster rows in [0, maxRow) and pattern IDs in [0, maxPattID)
+ClustersTF generateTF(int nROFs, int maxRow, int maxPattID)
+{
+  ClustersTF tf;
+  std::vector<int> row, col;
+  for (int irof = 0; irof < nROFs; irof++) {
+    auto& rofr = tf.rofRecVec.emplace_back();
+    rofr.getBCData().orbit = irof / 10;
+    rofr.getBCData().bc = irof % 10;
+    int nChips = 5 * irof;
+    int chipID = irof / 2;
+    rofr.setFirstEntry(tf.cclusVec.size());
+    for (int i = 0; i < nChips; i++) {
+      int nhits = gRandom->Poisson(50);
+      row.resize(nhits);
+      col.resize(nhits);
+      for (int i = 0; i < nhits; i++) {
+        row[i] = gRandom->Integer(maxRow);
+        col[i] = gRandom->Integer(1024);
+      }
+      std::sort(col.begin(), col.end());
+      for (int i = 0; i < nhits; i++) {
+        auto& cl = tf.cclusVec.emplace_back(row[i], col[i], gRandom->Integer(maxPattID), chipID);
+        if (cl.getPatternID() > 900) {
+          int nbpatt = 1 + gRandom->Poisson(3.);
+          for (int i = nbpatt; i--;) {
+            tf.pattVec.push_back(char(gRandom->Integer(256)));
+          }
+        }
+      }
+      chipID += 1 + gRandom->Poisson(10);
+    }
+    rofr.setNEntries(int(tf.cclusVec.size()) - rofr.getFirstEntry());
+  }
+  return tf;
+}
+
+// decode the CTF in the buffer with the coder and compare it with the TF it was encoded from
+void checkDecoded(CTFCoder& coder, const std::vector<o2::ctf::BufferType>& vec, const ClustersTF& tf)
+{
+  ClustersTF tfD;
+  LookUp clPattLookup;
+  coder.decode(o2::itsmft::CTF::getImage(vec.data()), tfD.rofRecVec, tfD.cclusVec, tfD.pattVec, nullptr, clPattLookup);
+  BOOST_REQUIRE(tfD.rofRecVec.size() == tf.rofRecVec.size());
+  BOOST_REQUIRE(tfD.cclusVec.size() == tf.cclusVec.size());
+  BOOST_CHECK(tfD.pattVec == tf.pattVec);
+  for (size_t i = 0; i < tf.rofRecVec.size(); i++) {
+    BOOST_CHECK(tfD.rofRecVec[i].getBCData() == tf.rofRecVec[i].getBCData());
+    BOOST_CHECK(tfD.rofRecVec[i].getFirstEntry() == tf.rofRecVec[i].getFirstEntry());
+    BOOST_CHECK(tfD.rofRecVec[i].getNEntries() == tf.rofRecVec[i].getNEntries());
+  }
+  size_t nBad = 0;
+  for (size_t i = 0; i < tf.cclusVec.size(); i++) {
+    const auto &cl = tf.cclusVec[i], &clD = tfD.cclusVec[i];
+    nBad += clD.getChipID() != cl.getChipID() || clD.getRow() != cl.getRow() || clD.getCol() != cl.getCol() || clD.getPatternID() != cl.getPatternID();
+  }
+  BOOST_CHECK(nBad == 0);
+}
+} // namespace
+
 BOOST_AUTO_TEST_CASE(CompressedClustersTest)
 {
 
@@ -77,6 +146,23 @@ BOOST_AUTO_TEST_CASE(CompressedClustersTest)
   sw.Stop();
   LOG(INFO) << "Compressed in " << sw.CpuTime() << " s";
 
+  // concurrent encoding of the blocks must give the same result as the serial one
+  {
+    std::vector<o2::ctf::BufferType> vecMT;
+    CTFCoder coder(o2::detectors::DetID::ITS);
+    coder.setNThreads(4);
+    coder.encode(vecMT, rofRecVec, cclusVec, pattVec);
+    const auto* ctfST = o2::itsmft::CTF::get(vec.data());
+    const auto* ctfMT = o2::itsmft::CTF::get(vecMT.data());
+    for (int ib = 0; ib < o2::itsmft::CTF::getNBlocks(); ib++) {
+      const auto& blcST = ctfST->getBlock(ib);
+      const auto& blcMT = ctfMT->getBlock(ib);
+      BOOST_CHECK(ctfST->getMetadata(ib).nDataWords == ctfMT->getMetadata(ib).nDataWords);
+      BOOST_CHECK(blcST.getNStored() == blcMT.getNStored());
+      BOOST_CHECK(blcST.getNStored() == 0 || std::memcmp(blcST.payload, blcMT.payload, blcST.getNStored() * sizeof(*blcST.payload)) == 0);
+    }
+  }
+
   // writing
   {
     sw.Start();
@@ -141,3 +227,48 @@ BOOST_AUTO_TEST_CASE(CompressedClustersTest)
     BOOST_CHECK(pattVecD[i] == pattVec[i]);
   }
 }
+
+BOOST_AUTO_TEST_CASE(CoderCacheTest)
+{
+  gRandom->SetSeed(1234);
+  const auto tf0 = generateTF(50, 512, 1000);
+  const auto tf1 = generateTF(50, 512, 1000);  // same statistics as tf0
+  const auto tfWide = generateTF(50, 512, 2000); // pattern IDs beyond the range of the tf0 table
+  const auto tfNarrow = generateTF(50, 16, 100); // very different statistics
+
+  CTFCoder encoder(o2::detectors::DetID::ITS), decoder(o2::detectors::DetID::ITS);
+  encoder.setCoderCacheDrift(0.05);
+  decoder.setCoderCacheDrift(0.05);
+  std::vector<o2::ctf::BufferType> vec;
+
+  encoder.encode(vec, tf0.rofRecVec, tf0.cclusVec, tf0.pattVec);
+  const auto nEncBuilds = encoder.getCoderCache()->getNEncoderBuilds();
+  BOOST_CHECK(nEncBuilds > 0);
+  checkDecoded(decoder, vec, tf0);
+  const auto nDecBuilds = decoder.getCoderCache()->getNDecoderBuilds();
+  BOOST_CHECK(nDecBuilds > 0);
+
+  // same statistics: the cached encoders are reused and so are the decoders, as the stored dictionaries did not change
+  encoder.encode(vec, tf1.rofRecVec, tf1.cclusVec, tf1.pattVec);
+  BOOST_CHECK(encoder.getCoderCache()->getNEncoderBuilds() == nEncBuilds);
+  checkDecoded(decoder, vec, tf1);
+  BOOST_CHECK(decoder.getCoderCache()->getNDecoderBuilds() == nDecBuilds);
+
+  // drifted statistics: the encoders are rebuilt, so are the decoders for the changed dictionaries
+  encoder.encode(vec, tfNarrow.rofRecVec, tfNarrow.cclusVec, tfNarrow.pattVec);
+  BOOST_CHECK(encoder.getCoderCache()->getNEncoderBuilds() > nEncBuilds);
+  checkDecoded(decoder, vec, tfNarrow);
+  BOOST_CHECK(decoder.getCoderCache()->getNDecoderBuilds() > nDecBuilds);
+
+  // with a drift threshold which is never reached, the cached tables are reused for symbols they do not cover,
+  // which must then go through the literals
+  encoder.getCoderCache()->clear();
+  encoder.getCoderCache()->setMaxDrift(1.e9);
+  encoder.encode(vec, tf0.rofRecVec, tf0.cclusVec, tf0.pattVec);
+  const auto nEncBuildsWide = encoder.getCoderCache()->getNEncoderBuilds();
+  encoder.encode(vec, tfWide.rofRecVec, tfWide.cclusVec, tfWide.pattVec);
+  BOOST_CHECK(encoder.getCoderCache()->getNEncoderBuilds() == nEncBuildsWide);
+  const auto* ctf = o2::itsmft::CTF::get(vec.data());
+  BOOST_CHECK(ctf->getMetadata(int(CTF::BLCpattID)).nLiterals > 0);
+  checkDecoded(decoder, vec, tfWide);
+}
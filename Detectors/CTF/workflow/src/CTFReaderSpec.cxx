@@ -11,6 +11,7 @@
 
 /// @file   CTFReaderSpec.cxx
 
+#include <cstring>
 #include <vector>
 #include <TFile.h>
 #include <TTree.h>
@@ -25,6 +26,7 @@
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "DataFormatsITSMFT/CTF.h"
 #include "DataFormatsTPC/CTF.h"
 #include "DataFormatsTRD/CTF.h"
@@ -78,11 +80,14 @@ class CTFReaderSpec : public o2::framework::Task
   void openCTFFile(const std::string& flname);
   void processTF(ProcessingContext& pc);
   void checkTreeEntries();
+  long getNTreeEntries() const { return mCTFFlatFile ? long(mCTFFlatFile->getNTFs()) : mCTFTree->GetEntries(); }
+  std::string getCTFFileName() const { return mCTFFlatFile ? mCTFFlatFile->getFileName() : mCTFFile->GetName(); }
   void stopReader();
   CTFReaderInp mInput{};
   std::unique_ptr<o2::utils::FileFetcher> mFileFetcher;
   std::unique_ptr<TFile> mCTFFile;
   std::unique_ptr<TTree> mCTFTree;
+  std::unique_ptr<CTFFlatFileReader> mCTFFlatFile; // memory-mapped flat CTF file, alternative to mCTFFile/mCTFTree
   bool mRunning = false;
   int mCTFCounter = 0;
   int mNFailedFiles = 0;
@@ -123,6 +128,7 @@ void CTFReaderSpec::stopReader()
     mCTFFile->Close();
   }
   mCTFFile.reset();
+  mCTFFlatFile.reset();
 }
 
 ///_______________________________________
@@ -141,6 +147,14 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
 {
   try {
     mFilesRead++;
+    if (CTFFlatFileReader::isFlatFile(flname)) { // detector images are served directly from the mapped file
+      mCTFFlatFile = std::make_unique<CTFFlatFileReader>(flname);
+      if (!mCTFFlatFile->getNTFs()) {
+        throw std::runtime_error("no CTFs in flat CTF file");
+      }
+      mCurrTreeEntry = 0;
+      return;
+    }
     mCTFFile.reset(TFile::Open(flname.c_str()));
     if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
       throw std::runtime_error("failed to open CTF file");
@@ -153,6 +167,7 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
     LOG(ERROR) << "Cannot process " << flname << ", reason: " << e.what();
     mCTFTree.reset();
     mCTFFile.reset();
+    mCTFFlatFile.reset();
     mNFailedFiles++;
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
@@ -171,14 +186,14 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   }
 
   while (mRunning) {
-    if (mCTFTree) { // there is a tree open with multiple CTF
+    if (mCTFTree || mCTFFlatFile) { // there is a tree (or flat file) open with multiple CTF
       if (mInput.ctfIDs.empty() || mInput.ctfIDs[mSelIDEntry] == mCTFCounter) { // no selection requested or matching CTF ID is found
         LOG(DEBUG) << "TF " << mCTFCounter << " of " << mInput.maxTFs << " loop " << mFileFetcher->getNLoops();
         mSelIDEntry++;
         processTF(pc);
         break;
       } else { // explict CTF ID selection list was provided and current entry is not selected
-        LOGP(INFO, "Skipping CTF${} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
+        LOGP(INFO, "Skipping CTF${} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, getNTreeEntries(), getCTFFileName());
         checkTreeEntries();
         mCTFCounter++;
         continue;
@@ -212,7 +227,10 @@ void CTFReaderSpec::processTF(ProcessingContext& pc)
   mTimer.Start(false);
 
   CTFHeader ctfHeader;
-  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
+  if (mCTFFlatFile) {
+    ctfHeader = mCTFFlatFile->getHeader(mCurrTreeEntry);
+    mCTFFlatFile->prefetch(mCurrTreeEntry + 1);
+  } else if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
     throw std::runtime_error("did not find CTFHeader");
   }
   LOG(INFO) << ctfHeader;
@@ -233,119 +251,135 @@ void CTFReaderSpec::processTF(ProcessingContext& pc)
   DetID::mask_t detsTF = mInput.detMask & ctfHeader.detectors;
   DetID det;
 
-  det = DetID::ITS;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
-    o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+  if (mCTFFlatFile) { // the flat image is copied from the mapped pages to the output w/o deserialization
+    for (auto id = DetID::First; id <= DetID::Last; id++) {
+      if (!detsTF[id]) {
+        continue;
+      }
+      det = DetID(id);
+      const auto image = mCTFFlatFile->getDetectorImage(mCurrTreeEntry, det);
+      if (image.empty()) {
+        throw std::runtime_error(o2::utils::Str::concat_string("did not find CTF image for ", det.getName()));
+      }
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, image.size);
+      std::memcpy(bufVec.data(), image.data, image.size);
+      setFirstTFOrbit(det.getName());
+    }
+  } else {
+    det = DetID::ITS;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
+      o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::MFT;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
-    o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::MFT;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
+      o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::TPC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tpc::CTF));
-    o2::tpc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::TPC;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tpc::CTF));
+      o2::tpc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::TRD;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::trd::CTF));
-    o2::trd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::TRD;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::trd::CTF));
+      o2::trd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::FT0;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::ft0::CTF));
-    o2::ft0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::FT0;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::ft0::CTF));
+      o2::ft0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::FV0;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fv0::CTF));
-    o2::fv0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::FV0;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fv0::CTF));
+      o2::fv0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::FDD;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fdd::CTF));
-    o2::fdd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::FDD;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fdd::CTF));
+      o2::fdd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::TOF;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tof::CTF));
-    o2::tof::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::TOF;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tof::CTF));
+      o2::tof::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::MID;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mid::CTF));
-    o2::mid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::MID;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mid::CTF));
+      o2::mid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::MCH;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mch::CTF));
-    o2::mch::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::MCH;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mch::CTF));
+      o2::mch::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::EMC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::emcal::CTF));
-    o2::emcal::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::EMC;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::emcal::CTF));
+      o2::emcal::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::PHS;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::phos::CTF));
-    o2::phos::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::PHS;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::phos::CTF));
+      o2::phos::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::CPV;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::cpv::CTF));
-    o2::cpv::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::CPV;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::cpv::CTF));
+      o2::cpv::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::ZDC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::zdc::CTF));
-    o2::zdc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::ZDC;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::zdc::CTF));
+      o2::zdc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::HMP;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::hmpid::CTF));
-    o2::hmpid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
-  }
+    det = DetID::HMP;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::hmpid::CTF));
+      o2::hmpid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
 
-  det = DetID::CTP;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::ctp::CTF));
-    o2::ctp::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
-    setFirstTFOrbit(det.getName());
+    det = DetID::CTP;
+    if (detsTF[det]) {
+      auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::ctp::CTF));
+      o2::ctp::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrTreeEntry);
+      setFirstTFOrbit(det.getName());
+    }
   }
 
-  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
+  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, getNTreeEntries(), getCTFFileName());
   checkTreeEntries();
   mTimer.Stop();
   // do we need to way to respect the delay ?
@@ -368,10 +402,14 @@ void CTFReaderSpec::processTF(ProcessingContext& pc)
 void CTFReaderSpec::checkTreeEntries()
 {
   // check if the tree has entries left, if needed, close current tree/file
-  if (++mCurrTreeEntry >= mCTFTree->GetEntries()) { // this file is done, check if there are other files
-    mCTFTree.reset();
-    mCTFFile->Close();
-    mCTFFile.reset();
+  if (++mCurrTreeEntry >= getNTreeEntries()) { // this file is done, check if there are other files
+    if (mCTFFlatFile) {
+      mCTFFlatFile.reset();
+    } else {
+      mCTFTree.reset();
+      mCTFFile->Close();
+      mCTFFile.reset();
+    }
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
     }
@@ -21,6 +21,7 @@
 
 #include "CTFWorkflow/CTFWriterSpec.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "DetectorsCommonDataFormats/FileMetaData.h"
@@ -120,6 +121,7 @@ class CTFWriterSpec : public o2::framework::Task
   bool mDictPerDetector = false;
   bool mCreateRunEnvDir = true;
   bool mStoreMetaFile = false;
+  bool mFlatOutput = false; // write CTFs to flat file (CTFFlatFileWriter) instead of the ROOT tree
   int mSaveDictAfter = 0; // if positive and mWriteCTF==true, save dictionary after each mSaveDictAfter TFs processed
   int mFlagMinDet = 1;    // append list of detectors to LHC period if their number is <= mFlagMinDet
   uint64_t mRun = 0;
@@ -149,6 +151,7 @@ class CTFWriterSpec : public o2::framework::Task
   int mLockFD = -1;
   std::unique_ptr<TFile> mCTFFileOut;
   std::unique_ptr<TTree> mCTFTreeOut;
+  std::unique_ptr<CTFFlatFileWriter> mCTFFlatOut;
   std::unique_ptr<o2::dataformats::FileMetaData> mCTFFileMetaData;
 
   std::unique_ptr<TFile> mDictFileOut; // file to store dictionary
@@ -216,6 +219,7 @@ void CTFWriterSpec::init(InitContext& ic)
   mMinSize = ic.options().get<int64_t>("min-file-size");
   mMaxSize = ic.options().get<int64_t>("max-file-size");
   mMaxCTFPerFile = ic.options().get<int>("max-ctf-per-file");
+  mFlatOutput = ic.options().get<bool>("flat-output");
   if (mWriteCTF) {
     if (mMinSize > 0) {
       LOG(INFO) << "Multiple CTFs will be accumulated in the tree/file until its size exceeds " << mMinSize << " bytes";
@@ -263,7 +267,12 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
   const auto ctfImage = C::getImage(ctfBuffer.data());
   ctfImage.print(o2::utils::Str::concat_string(det.getName(), ": "));
   if (mWriteCTF) {
-    sz += ctfImage.appendToTree(*tree, det.getName());
+    if (mCTFFlatOut) { // flat image is stored as is
+      mCTFFlatOut->addDetector(det, ctfBuffer.data(), ctfImage.size());
+      sz += ctfImage.size();
+    } else {
+      sz += ctfImage.appendToTree(*tree, det.getName());
+    }
     header.detectors.set(det);
   }
   if (mCreateDict) {
@@ -393,6 +402,9 @@ void CTFWriterSpec::run(ProcessingContext& pc)
   mCurrCTFSize = estimateCTFSize(pc);
   if (mWriteCTF) {
     prepareTFTreeAndFile(dh);
+    if (mCTFFlatOut) {
+      mCTFFlatOut->beginTF();
+    }
   }
 
   // create header
@@ -418,9 +430,14 @@ void CTFWriterSpec::run(ProcessingContext& pc)
   mTimer.Stop();
 
   if (mWriteCTF) {
-    szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
+    if (mCTFFlatOut) {
+      szCTF = mCTFFlatOut->endTF(header);
+      ++mNAccCTF;
+    } else {
+      szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
+      mCTFTreeOut->SetEntries(++mNAccCTF);
+    }
     mAccCTFSize += szCTF;
-    mCTFTreeOut->SetEntries(++mNAccCTF);
     mTFOrbits.push_back(dh->firstTForbit);
     LOG(INFO) << "TF#" << mNCTF << ": wrote CTF{" << header << "} of size " << szCTF << " to " << mCurrentCTFFileNameFull << " in " << mTimer.CpuTime() - cput << " s";
     if (mNAccCTF > 1) {
@@ -436,7 +453,7 @@ void CTFWriterSpec::run(ProcessingContext& pc)
 
     if (mAccCTFSize >= mMinSize || (mMaxCTFPerFile > 0 && mNAccCTF >= mMaxCTFPerFile)) {
       closeTFTreeAndFile();
-    } else if (mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0) {
+    } else if (mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0 && mCTFTreeOut) {
       mCTFTreeOut->AutoSave("override");
     }
   } else {
@@ -473,7 +490,7 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
     return;
   }
   bool needToOpen = false;
-  if (!mCTFTreeOut) {
+  if (!mCTFTreeOut && !mCTFFlatOut) {
     needToOpen = true;
   } else {
     if ((mAccCTFSize >= mMinSize) ||                                                         // min size exceeded, may close the file.
@@ -507,9 +524,17 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
       }
     }
     mCurrentCTFFileName = o2::base::NameConf::getCTFFileName(mRun, dh->firstTForbit, dh->tfCounter);
+    if (mFlatOutput) {
+      mCurrentCTFFileName = std::filesystem::path(mCurrentCTFFileName).replace_extension(CTFFlatFileFormat::FileExtension).string();
+    }
     mCurrentCTFFileNameFull = fmt::format("{}{}", ctfDir, mCurrentCTFFileName);
-    mCTFFileOut.reset(TFile::Open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding).c_str(), "recreate")); // to prevent premature external usage, use temporary name
-    mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    if (mFlatOutput) {
+      mCTFFlatOut = std::make_unique<CTFFlatFileWriter>();
+      mCTFFlatOut->open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding)); // to prevent premature external usage, use temporary name
+    } else {
+      mCTFFileOut.reset(TFile::Open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding).c_str(), "recreate")); // to prevent premature external usage, use temporary name
+      mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    }
     if (mStoreMetaFile) {
       mCTFFileMetaData = std::make_unique<o2::dataformats::FileMetaData>();
     }
@@ -521,13 +546,18 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
 //___________________________________________________________________
 void CTFWriterSpec::closeTFTreeAndFile()
 {
-  if (mCTFTreeOut) {
+  if (mCTFTreeOut || mCTFFlatOut) {
     try {
-      mCTFFileOut->cd();
-      mCTFTreeOut->Write();
-      mCTFTreeOut.reset();
-      mCTFFileOut->Close();
-      mCTFFileOut.reset();
+      if (mCTFFlatOut) {
+        mCTFFlatOut->close();
+        mCTFFlatOut.reset();
+      } else {
+        mCTFFileOut->cd();
+        mCTFTreeOut->Write();
+        mCTFTreeOut.reset();
+        mCTFFileOut->Close();
+        mCTFFileOut.reset();
+      }
       if (!TMPFileEnding.empty()) {
         std::filesystem::rename(o2::utils::Str::concat_string(mCurrentCTFFileNameFull, TMPFileEnding), mCurrentCTFFileNameFull);
       }
@@ -743,6 +773,7 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, uint64_t run, const std::
             {"min-file-size", VariantType::Int64, 0l, {"accumulate CTFs until given file size reached"}},
             {"max-file-size", VariantType::Int64, 0l, {"if > 0, try to avoid exceeding given file size, also used for space check"}},
             {"max-ctf-per-file", VariantType::Int, 0, {"if > 0, avoid storing more than requested CTFs per file"}},
+            {"flat-output", VariantType::Bool, false, {"write CTFs to flat .ctf file (memory-mapped by the reader) instead of ROOT tree"}},
             {"ignore-partition-run-dir", VariantType::Bool, false, {"Do not creare partition-run directory in output-dir"}}}};
 }
 
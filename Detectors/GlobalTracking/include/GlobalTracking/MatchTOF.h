@@ -114,6 +114,11 @@ class MatchTOF
   ///< get number of sigma used to do the matching
   float getSigmaTimeCut() const { return mSigmaTimeCut; }
 
+  ///< set number of threads used to match the sectors
+  void setNThreads(int n);
+  ///< get number of threads used to match the sectors
+  int getNThreads() const { return mNThreads; }
+
   enum DebugFlagTypes : UInt_t {
     MatchTreeAll = 0x1 << 1, ///< produce matching candidates tree for all candidates
   };
@@ -225,6 +230,7 @@ class MatchTOF
   float mTimeTolerance = 1e3; ///< tolerance in ns for track-TOF time bracket matching
   float mSpaceTolerance = 10; ///< tolerance in cm for track-TOF time bracket matching
   int mSigmaTimeCut = 30.;    ///< number of sigmas to cut on time when matching the track to the TOF cluster
+  int mNThreads = 1;          ///< number of OMP threads
 
   bool mIsFIT = false;
   bool mIsITSTPCused = false;
@@ -273,6 +279,8 @@ class MatchTOF
 
   ///<array of track-TOFCluster pairs from the matching
   std::vector<o2::dataformats::MatchInfoTOFReco> mMatchedTracksPairs;
+  ///<per sector arrays of track-TOFCluster pairs, filled independently by each sector
+  std::array<std::vector<o2::dataformats::MatchInfoTOFReco>, o2::constants::math::NSectors> mMatchedTracksPairsSec;
 
   ///<array of TOFChannel calibration info
   std::vector<o2::dataformats::CalibInfoTOF> mCalibInfoTOF;
@@ -44,6 +44,10 @@
 #include "DataFormatsGlobalTracking/RecoContainer.h"
 #include "DataFormatsGlobalTracking/RecoContainerCreateTracksVariadic.h"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::globaltracking;
 using evGIdx = o2::dataformats::EvIndex<int, o2::dataformats::GlobalTrackID>;
 using trkType = o2::dataformats::MatchInfoTOFReco::TrackType;
@@ -111,21 +115,50 @@ void MatchTOF::run(const o2::globaltracking::RecoContainer& inp)
   mTimerTot.Stop();
   LOGF(INFO, "Timing prepare FIT data: Cpu: %.3e s Real: %.3e s in %d slots", mTimerTot.CpuTime(), mTimerTot.RealTime(), mTimerTot.Counter() - 1);
 
+  // the TGeo navigation is not thread safe, the material budget has to come from the LUT
+  int nThreads = mNThreads;
+  if (nThreads > 1 && !o2::base::Propagator::Instance()->getMatLUT()) {
+    LOG(WARNING) << "No material LUT available, matching the sectors with a single thread";
+    nThreads = 1;
+  }
+  // the TOF geometry is initialised lazily by its first user, which must not be a parallel sector
+  o2::tof::Geo::Init();
+  o2::tof::Geo::InitIndices();
+
+  // the candidates of each sector are found independently, possibly in parallel, each track and TOF
+  // cluster belonging to a single sector
   mTimerTot.Start();
-  for (int sec = o2::constants::math::NSectors; sec--;) {
-    mMatchedTracksPairs.clear(); // new sector
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int sec = o2::constants::math::NSectors - 1; sec >= 0; sec--) {
+    mMatchedTracksPairsSec[sec].clear(); // new sector
     LOG(INFO) << "Doing matching for sector " << sec << "...";
     if (mIsITSTPCused || mIsTPCTRDused || mIsITSTPCTRDused) {
-      mTimerMatchITSTPC.Start(sec == o2::constants::math::NSectors - 1);
+      if (nThreads == 1) {
+        mTimerMatchITSTPC.Start(sec == o2::constants::math::NSectors - 1);
+      }
       doMatching(sec);
-      mTimerMatchITSTPC.Stop();
+      if (nThreads == 1) {
+        mTimerMatchITSTPC.Stop();
+      }
     }
     if (mIsTPCused) {
-      mTimerMatchTPC.Start(sec == o2::constants::math::NSectors - 1);
+      if (nThreads == 1) {
+        mTimerMatchTPC.Start(sec == o2::constants::math::NSectors - 1);
+      }
       doMatchingForTPC(sec);
-      mTimerMatchTPC.Stop();
+      if (nThreads == 1) {
+        mTimerMatchTPC.Stop();
+      }
     }
-    LOG(INFO) << "...done. Now check the best matches";
+  }
+
+  // the best matches are selected sector by sector, in the same order as with a single thread
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    mMatchedTracksPairs.swap(mMatchedTracksPairsSec[sec]);
+    mMatchedTracksPairsSec[sec].clear();
+    LOG(INFO) << "Check the best matches of sector " << sec;
     selectBestMatches();
   }
 
@@ -674,7 +707,7 @@ void MatchTOF::doMatching(int sec)
           foundCluster = true;
           // set event indexes (to be checked)
           int eventIndexTOFCluster = mTOFClusSectIndexCache[indices[0]][itof];
-          mMatchedTracksPairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[iPropagation], mTrackGid[type][cacheTrk[itrk]], type); // TODO: check if this is correct!
+          mMatchedTracksPairsSec[sec].emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[iPropagation], mTrackGid[type][cacheTrk[itrk]], type); // TODO: check if this is correct!
         }
       }
     }
@@ -1002,7 +1035,7 @@ void MatchTOF::doMatchingForTPC(int sec)
             foundCluster = true;
             // set event indexes (to be checked)
             int eventIndexTOFCluster = mTOFClusSectIndexCache[indices[0]][itof];
-            mMatchedTracksPairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[ibc][iPropagation], mTrackGid[trkType::UNCONS][cacheTrk[itrk]], trkType::UNCONS, resZ / vdrift * side, trefTOF.getZ()); // TODO: check if this is correct!
+            mMatchedTracksPairsSec[sec].emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[ibc][iPropagation], mTrackGid[trkType::UNCONS][cacheTrk[itrk]], trkType::UNCONS, resZ / vdrift * side, trefTOF.getZ()); // TODO: check if this is correct!
           }
         }
       }
@@ -1288,6 +1321,17 @@ bool MatchTOF::propagateToRefXWithoutCov(o2::track::TrackParCov& trc, float xRef
   return refReached && std::abs(trcNoCov.getSnp()) < 0.95 && TMath::Abs(trcNoCov.getZ()) < Geo::MAXHZTOF; // Here we need to put MAXSNP
 }
 
+//______________________________________________
+void MatchTOF::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  LOG(WARNING) << "Multithreading is not supported, imposing single thread";
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________
 void MatchTOF::setDebugFlag(UInt_t flag, bool on)
 {
@@ -11,6 +11,7 @@
 
 /// @file   TOFMatcherSpec.cxx
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include "TStopwatch.h"
@@ -93,6 +94,7 @@ void TOFMatcherSpec::init(InitContext& ic)
   if (mStrict) {
     mMatcher.setHighPurity();
   }
+  mMatcher.setNThreads(std::max(1, ic.options().get<int>("nthreads")));
 }
 
 void TOFMatcherSpec::run(ProcessingContext& pc)
@@ -212,7 +214,8 @@ DataProcessorSpec getTOFMatcherSpec(GID::mask_t src, bool useMC, bool useFIT, bo
     outputs,
     AlgorithmSpec{adaptFromTask<TOFMatcherSpec>(dataRequest, useMC, useFIT, tpcRefit, strict)},
     Options{
-      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}}}};
+      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads matching the sectors"}}}};
 }
 
 } // namespace globaltracking
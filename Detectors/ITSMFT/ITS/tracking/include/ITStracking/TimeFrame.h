@@ -17,6 +17,8 @@
 #define TRACKINGITSU_INCLUDE_TIMEFRAME_H_
 
 #include <array>
+#include <cstddef>
+#include <new>
 #include <vector>
 #include <utility>
 #include <cassert>
@@ -52,6 +54,77 @@ class ROFRecord;
 namespace its
 {
 
+/// Allocator for the cluster columns, aligned to the cache line to ease the vectorisation
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+  using value_type = T;
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+  {
+  }
+
+  T* allocate(std::size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment})); }
+  void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t{Alignment}); }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const
+  {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment>&) const
+  {
+    return false;
+  }
+};
+
+template <typename T>
+using aligned_vector = std::vector<T, AlignedAllocator<T>>;
+
+/// Structure of arrays copy of the sorted clusters of a layer, indexed like TimeFrame::getClusters().
+/// The candidate loops of the tracklet finding read only a few members of many clusters, which are contiguous here.
+struct ClusterColumns {
+  void clear();
+  void resize(size_t size);
+  void set(int index, const Cluster& cluster);
+  size_t size() const { return phi.size(); }
+
+  aligned_vector<float> phi;
+  aligned_vector<float> radius;
+  aligned_vector<float> zCoordinate;
+  aligned_vector<int> clusterId;
+};
+
+inline void ClusterColumns::clear()
+{
+  phi.clear();
+  radius.clear();
+  zCoordinate.clear();
+  clusterId.clear();
+}
+
+inline void ClusterColumns::resize(size_t size)
+{
+  phi.resize(size);
+  radius.resize(size);
+  zCoordinate.resize(size);
+  clusterId.resize(size);
+}
+
+inline void ClusterColumns::set(int index, const Cluster& cluster)
+{
+  phi[index] = cluster.phi;
+  radius[index] = cluster.radius;
+  zCoordinate[index] = cluster.zCoordinate;
+  clusterId[index] = cluster.clusterId;
+}
+
 using Vertex = o2::dataformats::Vertex<o2::dataformats::TimeStamp<int>>;
 
 class TimeFrame final
@@ -68,6 +141,11 @@ class TimeFrame final
 
   int loadROFrameData(gsl::span<o2::itsmft::ROFRecord> rofs, gsl::span<const itsmft::CompClusterExt> clusters, gsl::span<const unsigned char>::iterator& pattIt,
                       const itsmft::TopologyDictionary& dict, const dataformats::MCTruthContainer<MCCompLabel>* mcLabels = nullptr);
+  /// Adds a cluster to the readout frame being loaded, given in the global and in the tracking frame
+  void addClusterToROFrame(int layer, float x, float y, float z, float xTF, float alpha, const std::array<float, 2>& posTF,
+                           const std::array<float, 3>& covTF, int externalIndex);
+  /// Closes the readout frame being loaded, the clusters added afterwards go to the next one
+  void closeROFrame();
   int getTotalClusters() const;
   bool empty() const;
 
@@ -104,6 +182,7 @@ class TimeFrame final
 
   std::vector<std::vector<Cluster>>& getClusters();
   std::vector<std::vector<Cluster>>& getUnsortedClusters();
+  const ClusterColumns& getClusterColumns(int layerId) const { return mClusterColumns[layerId]; }
   int getClusterROF(int iLayer, int iCluster);
   std::vector<std::vector<Cell>>& getCells();
   std::vector<std::vector<int>>& getCellsLookupTable();
@@ -148,6 +227,7 @@ class TimeFrame final
   std::vector<Vertex> mPrimaryVertices;
   std::vector<std::vector<Cluster>> mClusters;
   std::vector<std::vector<Cluster>> mUnsortedClusters;
+  std::vector<ClusterColumns> mClusterColumns;
   std::vector<std::vector<bool>> mUsedClusters;
   std::vector<std::vector<TrackingFrameInfo>> mTrackingFrameInfo;
   const dataformats::MCTruthContainer<MCCompLabel>* mClusterLabels = nullptr;
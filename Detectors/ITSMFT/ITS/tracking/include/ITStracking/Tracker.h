@@ -72,6 +72,9 @@ class Tracker
 
   void clustersToTracks(std::function<void(std::string s)> = [](std::string s) { std::cout << s << std::endl; });
   void setSmoothing(bool v) { mApplySmoothing = v; }
+  /// Number of threads used by the CPU tracker, the results do not depend on it
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
   bool getSmoothing() const { return mApplySmoothing; }
 
   std::vector<TrackITSExt>& getTracks();
@@ -93,7 +96,7 @@ class Tracker
   void findTracks();
   void extendTracks();
   bool fitTrack(TrackITSExt& track, int start, int end, int step, const float chi2cut = o2::constants::math::VeryBig, const float maxQoverPt = o2::constants::math::VeryBig);
-  void traverseCellsTree(const int, const int);
+  void traverseCellsTree(const int, const int, std::vector<Road>& roads);
   void computeRoadsMClabels();
   void computeTracksMClabels();
   void rectifyClusterIndices();
@@ -109,6 +112,7 @@ class Tracker
 
   bool mCUDA = false;
   bool mApplySmoothing = false;
+  int mNThreads = 1;
   o2::base::PropagatorImpl<float>::MatCorrType mCorrType = o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrLUT;
   float mBz = 5.f;
   std::uint32_t mTimeFrameCounter = 0;
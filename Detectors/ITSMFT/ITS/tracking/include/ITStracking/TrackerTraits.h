@@ -66,9 +66,13 @@ class TrackerTraits
   TimeFrame* getTimeFrame() { return mTimeFrame; }
   void adoptTimeFrame(TimeFrame* tf) { mTimeFrame = tf; }
 
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
  protected:
   TimeFrame* mTimeFrame;
   TrackingParameters mTrkParams;
+  int mNThreads = 1;
 
   o2::gpu::GPUChainITS* mChain = nullptr;
   FuncRunITSTrackFit_t mChainRunITSTrackFit;
@@ -49,6 +49,7 @@ TimeFrame::TimeFrame(int nLayers)
   mMaxR.resize(nLayers, -1.);
   mClusters.resize(nLayers);
   mUnsortedClusters.resize(nLayers);
+  mClusterColumns.resize(nLayers);
   mTrackingFrameInfo.resize(nLayers);
   mClusterExternalIndices.resize(nLayers);
   mUsedClusters.resize(nLayers);
@@ -79,28 +80,37 @@ int TimeFrame::loadROFrameData(const o2::itsmft::ROFRecord& rof, gsl::span<const
   for (auto& c : clusters_in_frame) {
     int layer = geom->getLayer(c.getSensorID());
 
-    /// Clusters are stored in the tracking frame
+    /// Clusters are stored in the tracking frame, rotated to the global frame
     auto xyz = c.getXYZGloRot(*geom);
-    addTrackingFrameInfoToLayer(layer, xyz.x(), xyz.y(), xyz.z(), c.getX(), geom->getSensorRefAlpha(c.getSensorID()),
-                                std::array<float, 2>{c.getY(), c.getZ()},
-                                std::array<float, 3>{c.getSigmaY2(), c.getSigmaYZ(), c.getSigmaZ2()});
-
-    /// Rotate to the global frame
-    addClusterToLayer(layer, xyz.x(), xyz.y(), xyz.z(), mUnsortedClusters[layer].size());
-    addClusterExternalIndexToLayer(layer, first + clusterId);
+    addClusterToROFrame(layer, xyz.x(), xyz.y(), xyz.z(), c.getX(), geom->getSensorRefAlpha(c.getSensorID()),
+                        std::array<float, 2>{c.getY(), c.getZ()},
+                        std::array<float, 3>{c.getSigmaY2(), c.getSigmaYZ(), c.getSigmaZ2()}, first + clusterId);
     clusterId++;
   }
 
-  for (unsigned int iL{0}; iL < mUnsortedClusters.size(); ++iL) {
-    mROframesClusters[iL].push_back(mUnsortedClusters[iL].size());
-  }
+  closeROFrame();
   if (mcLabels) {
     mClusterLabels = mcLabels;
   }
-  mNrof++;
   return clusters_in_frame.size();
 }
 
+void TimeFrame::addClusterToROFrame(int layer, float x, float y, float z, float xTF, float alpha, const std::array<float, 2>& posTF,
+                                    const std::array<float, 3>& covTF, int externalIndex)
+{
+  addTrackingFrameInfoToLayer(layer, x, y, z, xTF, alpha, std::array<float, 2>{posTF}, std::array<float, 3>{covTF});
+  addClusterToLayer(layer, x, y, z, mUnsortedClusters[layer].size());
+  addClusterExternalIndexToLayer(layer, externalIndex);
+}
+
+void TimeFrame::closeROFrame()
+{
+  for (unsigned int iL{0}; iL < mUnsortedClusters.size(); ++iL) {
+    mROframesClusters[iL].push_back(mUnsortedClusters[iL].size());
+  }
+  mNrof++;
+}
+
 int TimeFrame::loadROFrameData(gsl::span<o2::itsmft::ROFRecord> rofs, gsl::span<const itsmft::CompClusterExt> clusters, gsl::span<const unsigned char>::iterator& pattIt, const itsmft::TopologyDictionary& dict, const dataformats::MCTruthContainer<MCCompLabel>* mcLabels)
 {
   GeometryTGeo* geom = GeometryTGeo::Instance();
@@ -187,6 +197,8 @@ void TimeFrame::initialise(const int iteration, const MemoryParameters& memParam
       }
       mClusters[iLayer].clear();
       mClusters[iLayer].resize(mUnsortedClusters[iLayer].size());
+      mClusterColumns[iLayer].clear();
+      mClusterColumns[iLayer].resize(mUnsortedClusters[iLayer].size());
       mUsedClusters[iLayer].clear();
       mUsedClusters[iLayer].resize(mUnsortedClusters[iLayer].size(), false);
     }
@@ -229,6 +241,7 @@ void TimeFrame::initialise(const int iteration, const MemoryParameters& memParam
         }
 
         auto clusters2beSorted{getClustersOnLayer(rof, iLayer)};
+        const int firstSortedIndex{getSortedIndex(rof, iLayer, 0)};
         for (int iCluster{0}; iCluster < clustersNum; ++iCluster) {
           const ClusterHelper& h = cHelper[iCluster];
 
@@ -237,6 +250,7 @@ void TimeFrame::initialise(const int iteration, const MemoryParameters& memParam
           c.phi = h.phi;
           c.radius = h.r;
           c.indexTableBinIndex = h.bin;
+          mClusterColumns[iLayer].set(firstSortedIndex + lutPerBin[h.bin] + h.ind, c);
         }
 
         if (iLayer > 0) {
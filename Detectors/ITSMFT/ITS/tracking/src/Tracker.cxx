@@ -31,12 +31,26 @@
 #include <cstdlib>
 #include <string>
 #include <climits>
+#include <algorithm>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 namespace o2
 {
 namespace its
 {
 
+namespace
+{
+/// Number of contiguous chunks the work is split in, a few per thread to even out the load
+int getNChunks(int nElements, int nThreads)
+{
+  return std::max(1, std::min(nElements, nThreads * 4));
+}
+} // namespace
+
 Tracker::Tracker(o2::its::TrackerTraits* traits)
 {
   /// Initialise standard configuration with 1 iteration
@@ -56,6 +70,12 @@ Tracker::~Tracker()
 Tracker::~Tracker() = default;
 #endif
 
+void Tracker::setNThreads(int n)
+{
+  mNThreads = n > 0 ? n : 1;
+  mTraits->setNThreads(mNThreads);
+}
+
 void Tracker::clustersToTracks(std::function<void(std::string s)> logger)
 {
   double total{0};
@@ -108,40 +128,56 @@ void Tracker::findCellsNeighbours(int& iteration)
     const int nextLayerCellsNum{static_cast<int>(mTimeFrame->getCells()[iLayer + 1].size())};
     mTimeFrame->getCellsNeighbours()[iLayer].resize(nextLayerCellsNum);
 
-    for (int iCell{0}; iCell < layerCellsNum; ++iCell) {
-
-      const Cell& currentCell{mTimeFrame->getCells()[iLayer][iCell]};
-      const int nextLayerTrackletIndex{currentCell.getSecondTrackletIndex()};
-      const int nextLayerFirstCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex]};
-      const int nextLayerLastCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex + 1]};
-      for (int iNextLayerCell{nextLayerFirstCellIndex}; iNextLayerCell < nextLayerLastCellIndex; ++iNextLayerCell) {
-
-        Cell& nextCell{mTimeFrame->getCells()[iLayer + 1][iNextLayerCell]};
-        if (nextCell.getFirstTrackletIndex() != nextLayerTrackletIndex) {
-          break;
-        }
-
-        const float3 currentCellNormalVector{currentCell.getNormalVectorCoordinates()};
-        const float3 nextCellNormalVector{nextCell.getNormalVectorCoordinates()};
-        const float3 normalVectorsDeltaVector{currentCellNormalVector.x - nextCellNormalVector.x,
-                                              currentCellNormalVector.y - nextCellNormalVector.y,
-                                              currentCellNormalVector.z - nextCellNormalVector.z};
+    /// The compatible pairs of cells are found in parallel, then the neighbours and levels are set in the order of
+    /// the current cells, as with a single thread. The levels of the current layer are not changed meanwhile.
+    const int nChunks{getNChunks(layerCellsNum, mNThreads)};
+    std::vector<std::vector<std::pair<int, int>>> chunkNeighbours(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+      const int firstCell{static_cast<int>(static_cast<long>(iChunk) * layerCellsNum / nChunks)};
+      const int lastCell{static_cast<int>(static_cast<long>(iChunk + 1) * layerCellsNum / nChunks)};
+      for (int iCell{firstCell}; iCell < lastCell; ++iCell) {
+
+        const Cell& currentCell{mTimeFrame->getCells()[iLayer][iCell]};
+        const int nextLayerTrackletIndex{currentCell.getSecondTrackletIndex()};
+        const int nextLayerFirstCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex]};
+        const int nextLayerLastCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex + 1]};
+        for (int iNextLayerCell{nextLayerFirstCellIndex}; iNextLayerCell < nextLayerLastCellIndex; ++iNextLayerCell) {
+
+          const Cell& nextCell{mTimeFrame->getCells()[iLayer + 1][iNextLayerCell]};
+          if (nextCell.getFirstTrackletIndex() != nextLayerTrackletIndex) {
+            break;
+          }
 
-        const float deltaNormalVectorsModulus{(normalVectorsDeltaVector.x * normalVectorsDeltaVector.x) +
-                                              (normalVectorsDeltaVector.y * normalVectorsDeltaVector.y) +
-                                              (normalVectorsDeltaVector.z * normalVectorsDeltaVector.z)};
-        const float deltaCurvature{std::abs(currentCell.getCurvature() - nextCell.getCurvature())};
+          const float3 currentCellNormalVector{currentCell.getNormalVectorCoordinates()};
+          const float3 nextCellNormalVector{nextCell.getNormalVectorCoordinates()};
+          const float3 normalVectorsDeltaVector{currentCellNormalVector.x - nextCellNormalVector.x,
+                                                currentCellNormalVector.y - nextCellNormalVector.y,
+                                                currentCellNormalVector.z - nextCellNormalVector.z};
 
-        if (deltaNormalVectorsModulus < mTrkParams[iteration].NeighbourMaxDeltaN[iLayer] &&
-            deltaCurvature < mTrkParams[iteration].NeighbourMaxDeltaCurvature[iLayer]) {
+          const float deltaNormalVectorsModulus{(normalVectorsDeltaVector.x * normalVectorsDeltaVector.x) +
+                                                (normalVectorsDeltaVector.y * normalVectorsDeltaVector.y) +
+                                                (normalVectorsDeltaVector.z * normalVectorsDeltaVector.z)};
+          const float deltaCurvature{std::abs(currentCell.getCurvature() - nextCell.getCurvature())};
 
-          mTimeFrame->getCellsNeighbours()[iLayer][iNextLayerCell].push_back(iCell);
+          if (deltaNormalVectorsModulus < mTrkParams[iteration].NeighbourMaxDeltaN[iLayer] &&
+              deltaCurvature < mTrkParams[iteration].NeighbourMaxDeltaCurvature[iLayer]) {
+            chunkNeighbours[iChunk].emplace_back(iCell, iNextLayerCell);
+          }
+        }
+      }
+    }
 
-          const int currentCellLevel{currentCell.getLevel()};
+    for (auto& neighbours : chunkNeighbours) {
+      for (auto& [iCell, iNextLayerCell] : neighbours) {
+        mTimeFrame->getCellsNeighbours()[iLayer][iNextLayerCell].push_back(iCell);
 
-          if (currentCellLevel >= nextCell.getLevel()) {
-            nextCell.setLevel(currentCellLevel + 1);
-          }
+        const int currentCellLevel{mTimeFrame->getCells()[iLayer][iCell].getLevel()};
+        Cell& nextCell{mTimeFrame->getCells()[iLayer + 1][iNextLayerCell]};
+        if (currentCellLevel >= nextCell.getLevel()) {
+          nextCell.setLevel(currentCellLevel + 1);
         }
       }
     }
@@ -158,49 +194,65 @@ void Tracker::findRoads(int& iteration)
 
       const int levelCellsNum{static_cast<int>(mTimeFrame->getCells()[iLayer].size())};
 
-      for (int iCell{0}; iCell < levelCellsNum; ++iCell) {
+      /// The cells are split in contiguous chunks, each one filling its own roads
+      const int nChunks{getNChunks(levelCellsNum, mNThreads)};
+      std::vector<std::vector<Road>> chunkRoads(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+      for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+        auto& roads{chunkRoads[iChunk]};
+        const int firstCell{static_cast<int>(static_cast<long>(iChunk) * levelCellsNum / nChunks)};
+        const int lastCell{static_cast<int>(static_cast<long>(iChunk + 1) * levelCellsNum / nChunks)};
+        for (int iCell{firstCell}; iCell < lastCell; ++iCell) {
 
-        Cell& currentCell{mTimeFrame->getCells()[iLayer][iCell]};
+          const Cell& currentCell{mTimeFrame->getCells()[iLayer][iCell]};
 
-        if (currentCell.getLevel() != iLevel) {
-          continue;
-        }
+          if (currentCell.getLevel() != iLevel) {
+            continue;
+          }
 
-        mTimeFrame->getRoads().emplace_back(iLayer, iCell);
+          roads.emplace_back(iLayer, iCell);
 
-        /// For 3 clusters roads (useful for cascades and hypertriton) we just store the single cell
-        /// and we do not do the candidate tree traversal
-        if (iLevel == 1) {
-          continue;
-        }
+          /// For 3 clusters roads (useful for cascades and hypertriton) we just store the single cell
+          /// and we do not do the candidate tree traversal
+          if (iLevel == 1) {
+            continue;
+          }
 
-        const int cellNeighboursNum{static_cast<int>(
-          mTimeFrame->getCellsNeighbours()[iLayer - 1][iCell].size())};
-        bool isFirstValidNeighbour = true;
+          const int cellNeighboursNum{static_cast<int>(
+            mTimeFrame->getCellsNeighbours()[iLayer - 1][iCell].size())};
+          bool isFirstValidNeighbour = true;
 
-        for (int iNeighbourCell{0}; iNeighbourCell < cellNeighboursNum; ++iNeighbourCell) {
+          for (int iNeighbourCell{0}; iNeighbourCell < cellNeighboursNum; ++iNeighbourCell) {
 
-          const int neighbourCellId = mTimeFrame->getCellsNeighbours()[iLayer - 1][iCell][iNeighbourCell];
-          const Cell& neighbourCell = mTimeFrame->getCells()[iLayer - 1][neighbourCellId];
+            const int neighbourCellId = mTimeFrame->getCellsNeighbours()[iLayer - 1][iCell][iNeighbourCell];
+            const Cell& neighbourCell = mTimeFrame->getCells()[iLayer - 1][neighbourCellId];
 
-          if (iLevel - 1 != neighbourCell.getLevel()) {
-            continue;
-          }
+            if (iLevel - 1 != neighbourCell.getLevel()) {
+              continue;
+            }
 
-          if (isFirstValidNeighbour) {
+            if (isFirstValidNeighbour) {
 
-            isFirstValidNeighbour = false;
+              isFirstValidNeighbour = false;
 
-          } else {
+            } else {
+
+              roads.emplace_back(iLayer, iCell);
+            }
 
-            mTimeFrame->getRoads().emplace_back(iLayer, iCell);
+            traverseCellsTree(neighbourCellId, iLayer - 1, roads);
           }
 
-          traverseCellsTree(neighbourCellId, iLayer - 1);
+          // TODO: crosscheck for short track iterations
+          // currentCell.setLevel(0);
         }
+      }
 
-        // TODO: crosscheck for short track iterations
-        // currentCell.setLevel(0);
+      /// The roads are merged in the order of the cells, i.e. in the order of a single thread
+      for (auto& roads : chunkRoads) {
+        mTimeFrame->getRoads().insert(mTimeFrame->getRoads().end(), roads.begin(), roads.end());
       }
     }
 #ifdef CA_DEBUG
@@ -212,101 +264,135 @@ void Tracker::findRoads(int& iteration)
 
 void Tracker::findTracks()
 {
-  std::vector<TrackITSExt> tracks;
-  tracks.reserve(mTimeFrame->getRoads().size());
-
-  for (auto& road : mTimeFrame->getRoads()) {
-    std::vector<int> clusters(mTrkParams[0].NLayers, constants::its::UnusedIndex);
-    int lastCellLevel = constants::its::UnusedIndex;
-    CA_DEBUGGER(int nClusters = 2);
-    int firstTracklet{constants::its::UnusedIndex};
-    std::vector<int> tracklets(mTrkParams[0].TrackletsPerRoad(), constants::its::UnusedIndex);
-
-    for (int iCell{0}; iCell < mTrkParams[0].CellsPerRoad(); ++iCell) {
-      const int cellIndex = road[iCell];
-      if (cellIndex == constants::its::UnusedIndex) {
-        continue;
-      } else {
-        if (firstTracklet == constants::its::UnusedIndex) {
-          firstTracklet = iCell;
+  /// The navigation in the TGeo geometry is not thread safe, so that the material budget has to come from the LUT.
+  const int nThreads{mCorrType == o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrTGeo ? 1 : mNThreads};
+  const int roadsNum{static_cast<int>(mTimeFrame->getRoads().size())};
+  const int nChunks{getNChunks(roadsNum, nThreads)};
+  std::vector<std::vector<TrackITSExt>> chunkTracks(nChunks);
+#ifdef CA_DEBUG
+  /// Counted per chunk, so that the threads do not share them
+  std::vector<std::array<int, 4>> roadCounters(nChunks), fitCounters(nChunks), backpropagatedCounters(nChunks);
+#endif
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+    auto& tracks{chunkTracks[iChunk]};
+    const int firstRoad{static_cast<int>(static_cast<long>(iChunk) * roadsNum / nChunks)};
+    const int lastRoad{static_cast<int>(static_cast<long>(iChunk + 1) * roadsNum / nChunks)};
+    for (int iRoad{firstRoad}; iRoad < lastRoad; ++iRoad) {
+      auto& road{mTimeFrame->getRoads()[iRoad]};
+      std::vector<int> clusters(mTrkParams[0].NLayers, constants::its::UnusedIndex);
+      int lastCellLevel = constants::its::UnusedIndex;
+      CA_DEBUGGER(int nClusters = 2);
+      int firstTracklet{constants::its::UnusedIndex};
+      std::vector<int> tracklets(mTrkParams[0].TrackletsPerRoad(), constants::its::UnusedIndex);
+
+      for (int iCell{0}; iCell < mTrkParams[0].CellsPerRoad(); ++iCell) {
+        const int cellIndex = road[iCell];
+        if (cellIndex == constants::its::UnusedIndex) {
+          continue;
+        } else {
+          if (firstTracklet == constants::its::UnusedIndex) {
+            firstTracklet = iCell;
+          }
+          tracklets[iCell] = mTimeFrame->getCells()[iCell][cellIndex].getFirstTrackletIndex();
+          tracklets[iCell + 1] = mTimeFrame->getCells()[iCell][cellIndex].getSecondTrackletIndex();
+          clusters[iCell] = mTimeFrame->getCells()[iCell][cellIndex].getFirstClusterIndex();
+          clusters[iCell + 1] = mTimeFrame->getCells()[iCell][cellIndex].getSecondClusterIndex();
+          clusters[iCell + 2] = mTimeFrame->getCells()[iCell][cellIndex].getThirdClusterIndex();
+          assert(clusters[iCell] != constants::its::UnusedIndex &&
+                 clusters[iCell + 1] != constants::its::UnusedIndex &&
+                 clusters[iCell + 2] != constants::its::UnusedIndex);
+          lastCellLevel = iCell;
+          CA_DEBUGGER(nClusters++);
         }
-        tracklets[iCell] = mTimeFrame->getCells()[iCell][cellIndex].getFirstTrackletIndex();
-        tracklets[iCell + 1] = mTimeFrame->getCells()[iCell][cellIndex].getSecondTrackletIndex();
-        clusters[iCell] = mTimeFrame->getCells()[iCell][cellIndex].getFirstClusterIndex();
-        clusters[iCell + 1] = mTimeFrame->getCells()[iCell][cellIndex].getSecondClusterIndex();
-        clusters[iCell + 2] = mTimeFrame->getCells()[iCell][cellIndex].getThirdClusterIndex();
-        assert(clusters[iCell] != constants::its::UnusedIndex &&
-               clusters[iCell + 1] != constants::its::UnusedIndex &&
-               clusters[iCell + 2] != constants::its::UnusedIndex);
-        lastCellLevel = iCell;
-        CA_DEBUGGER(nClusters++);
       }
-    }
 
-    CA_DEBUGGER(assert(nClusters >= mTrkParams[0].MinTrackLength));
-    int count{1};
-    unsigned short rof{mTimeFrame->getTracklets()[firstTracklet][tracklets[firstTracklet]].rof[0]};
-    for (int iT = firstTracklet; iT < 6; ++iT) {
-      if (tracklets[iT] == constants::its::UnusedIndex) {
-        continue;
-      }
-      if (rof == mTimeFrame->getTracklets()[iT][tracklets[iT]].rof[1]) {
-        count++;
-      } else {
-        if (count == 1) {
-          rof = mTimeFrame->getTracklets()[iT][tracklets[iT]].rof[1];
+      CA_DEBUGGER(assert(nClusters >= mTrkParams[0].MinTrackLength));
+      int count{1};
+      unsigned short rof{mTimeFrame->getTracklets()[firstTracklet][tracklets[firstTracklet]].rof[0]};
+      for (int iT = firstTracklet; iT < 6; ++iT) {
+        if (tracklets[iT] == constants::its::UnusedIndex) {
+          continue;
+        }
+        if (rof == mTimeFrame->getTracklets()[iT][tracklets[iT]].rof[1]) {
+          count++;
         } else {
-          count--;
+          if (count == 1) {
+            rof = mTimeFrame->getTracklets()[iT][tracklets[iT]].rof[1];
+          } else {
+            count--;
+          }
         }
       }
-    }
 
-    CA_DEBUGGER(assert(nClusters >= mTrkParams[0].MinTrackLength));
-    CA_DEBUGGER(roadCounters[nClusters - 4]++);
+      CA_DEBUGGER(assert(nClusters >= mTrkParams[0].MinTrackLength));
+      CA_DEBUGGER(roadCounters[iChunk][nClusters - 4]++);
 
-    if (lastCellLevel == constants::its::UnusedIndex) {
-      continue;
-    }
+      if (lastCellLevel == constants::its::UnusedIndex) {
+        continue;
+      }
 
-    /// From primary vertex context index to event index (== the one used as input of the tracking code)
-    for (int iC{0}; iC < clusters.size(); iC++) {
-      if (clusters[iC] != constants::its::UnusedIndex) {
-        clusters[iC] = mTimeFrame->getClusters()[iC][clusters[iC]].clusterId;
+      /// From primary vertex context index to event index (== the one used as input of the tracking code)
+      for (int iC{0}; iC < clusters.size(); iC++) {
+        if (clusters[iC] != constants::its::UnusedIndex) {
+          clusters[iC] = mTimeFrame->getClusters()[iC][clusters[iC]].clusterId;
+        }
       }
-    }
 
-    /// Track seed preparation. Clusters are numbered progressively from the outermost to the innermost.
-    const auto& cluster1_glo = mTimeFrame->getUnsortedClusters()[lastCellLevel + 2].at(clusters[lastCellLevel + 2]);
-    const auto& cluster2_glo = mTimeFrame->getUnsortedClusters()[lastCellLevel + 1].at(clusters[lastCellLevel + 1]);
-    const auto& cluster3_glo = mTimeFrame->getUnsortedClusters()[lastCellLevel].at(clusters[lastCellLevel]);
+      /// Track seed preparation. Clusters are numbered progressively from the outermost to the innermost.
+      const auto& cluster1_glo = mTimeFrame->getUnsortedClusters()[lastCellLevel + 2].at(clusters[lastCellLevel + 2]);
+      const auto& cluster2_glo = mTimeFrame->getUnsortedClusters()[lastCellLevel + 1].at(clusters[lastCellLevel + 1]);
+      const auto& cluster3_glo = mTimeFrame->getUnsortedClusters()[lastCellLevel].at(clusters[lastCellLevel]);
 
-    const auto& cluster3_tf = mTimeFrame->getTrackingFrameInfoOnLayer(lastCellLevel).at(clusters[lastCellLevel]);
+      const auto& cluster3_tf = mTimeFrame->getTrackingFrameInfoOnLayer(lastCellLevel).at(clusters[lastCellLevel]);
 
-    /// FIXME!
-    TrackITSExt temporaryTrack{buildTrackSeed(cluster1_glo, cluster2_glo, cluster3_glo, cluster3_tf)};
-    for (size_t iC = 0; iC < clusters.size(); ++iC) {
-      temporaryTrack.setExternalClusterIndex(iC, clusters[iC], clusters[iC] != constants::its::UnusedIndex);
-    }
-    bool fitSuccess = fitTrack(temporaryTrack, mTrkParams[0].NLayers - 4, -1, -1);
-    if (!fitSuccess) {
-      continue;
-    }
-    CA_DEBUGGER(fitCounters[nClusters - 4]++);
-    temporaryTrack.resetCovariance();
-    fitSuccess = fitTrack(temporaryTrack, 0, mTrkParams[0].NLayers, 1, mTrkParams[0].FitIterationMaxChi2[0]);
-    if (!fitSuccess) {
-      continue;
+      /// FIXME!
+      TrackITSExt temporaryTrack{buildTrackSeed(cluster1_glo, cluster2_glo, cluster3_glo, cluster3_tf)};
+      for (size_t iC = 0; iC < clusters.size(); ++iC) {
+        temporaryTrack.setExternalClusterIndex(iC, clusters[iC], clusters[iC] != constants::its::UnusedIndex);
+      }
+      bool fitSuccess = fitTrack(temporaryTrack, mTrkParams[0].NLayers - 4, -1, -1);
+      if (!fitSuccess) {
+        continue;
+      }
+      CA_DEBUGGER(fitCounters[iChunk][nClusters - 4]++);
+      temporaryTrack.resetCovariance();
+      fitSuccess = fitTrack(temporaryTrack, 0, mTrkParams[0].NLayers, 1, mTrkParams[0].FitIterationMaxChi2[0]);
+      if (!fitSuccess) {
+        continue;
+      }
+      CA_DEBUGGER(backpropagatedCounters[iChunk][nClusters - 4]++);
+      temporaryTrack.getParamOut() = temporaryTrack;
+      temporaryTrack.resetCovariance();
+      fitSuccess = fitTrack(temporaryTrack, mTrkParams[0].NLayers - 1, -1, -1, mTrkParams[0].FitIterationMaxChi2[1], 50.);
+      if (!fitSuccess) {
+        continue;
+      }
+      // temporaryTrack.setROFrame(rof);
+      tracks.emplace_back(temporaryTrack);
     }
-    CA_DEBUGGER(backpropagatedCounters[nClusters - 4]++);
-    temporaryTrack.getParamOut() = temporaryTrack;
-    temporaryTrack.resetCovariance();
-    fitSuccess = fitTrack(temporaryTrack, mTrkParams[0].NLayers - 1, -1, -1, mTrkParams[0].FitIterationMaxChi2[1], 50.);
-    if (!fitSuccess) {
-      continue;
+  }
+
+  std::vector<TrackITSExt> tracks;
+  tracks.reserve(roadsNum);
+  for (auto& trackChunk : chunkTracks) {
+    tracks.insert(tracks.end(), trackChunk.begin(), trackChunk.end());
+  }
+#ifdef CA_DEBUG
+  for (int iChunk{1}; iChunk < nChunks; ++iChunk) {
+    for (size_t iC{0}; iC < roadCounters[0].size(); ++iC) {
+      roadCounters[0][iC] += roadCounters[iChunk][iC];
+      fitCounters[0][iC] += fitCounters[iChunk][iC];
+      backpropagatedCounters[0][iC] += backpropagatedCounters[iChunk][iC];
     }
-    // temporaryTrack.setROFrame(rof);
-    tracks.emplace_back(temporaryTrack);
   }
+  for (size_t iC{0}; iC < roadCounters[0].size(); ++iC) {
+    std::cout << "+++ Roads with " << iC + 4 << " clusters: " << roadCounters[0][iC] << ", fitted: " << fitCounters[0][iC]
+              << ", back-propagated: " << backpropagatedCounters[0][iC] << std::endl;
+  }
+#endif
 
   if (mApplySmoothing) {
     // Smoothing tracks
@@ -389,12 +475,12 @@ bool Tracker::fitTrack(TrackITSExt& track, int start, int end, int step, const f
   return std::abs(track.getQ2Pt()) < maxQoverPt;
 }
 
-void Tracker::traverseCellsTree(const int currentCellId, const int currentLayerId)
+void Tracker::traverseCellsTree(const int currentCellId, const int currentLayerId, std::vector<Road>& roads)
 {
-  Cell& currentCell{mTimeFrame->getCells()[currentLayerId][currentCellId]};
+  const Cell& currentCell{mTimeFrame->getCells()[currentLayerId][currentCellId]};
   const int currentCellLevel = currentCell.getLevel();
 
-  mTimeFrame->getRoads().back().addCell(currentLayerId, currentCellId);
+  roads.back().addCell(currentLayerId, currentCellId);
 
   if (currentLayerId > 0 && currentCellLevel > 1) {
     const int cellNeighboursNum{static_cast<int>(
@@ -414,10 +500,10 @@ void Tracker::traverseCellsTree(const int currentCellId, const int currentLayerI
       if (isFirstValidNeighbour) {
         isFirstValidNeighbour = false;
       } else {
-        mTimeFrame->getRoads().push_back(mTimeFrame->getRoads().back());
+        roads.push_back(roads.back());
       }
 
-      traverseCellsTree(neighbourCellId, currentLayerId - 1);
+      traverseCellsTree(neighbourCellId, currentLayerId - 1, roads);
     }
   }
 
@@ -22,8 +22,14 @@
 #include "ITStracking/Tracklet.h"
 #include <fmt/format.h>
 #include "ReconstructionDataFormats/Track.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <numeric>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 #include "GPUCommonMath.h"
 
@@ -38,7 +44,15 @@ void TrackerTraitsCPU::computeLayerTracklets()
 {
   TimeFrame* tf = mTimeFrame;
 
-  for (int rof0{0}; rof0 < tf->getNrof(); ++rof0) {
+  /// The ROFs are processed in parallel, each one filling its own tracklets. Only the lookup table entries of the
+  /// clusters of the ROF are updated, so that the threads never write the same element.
+  const int nRof{tf->getNrof()};
+  std::vector<std::vector<std::vector<Tracklet>>> rofTracklets(nRof, std::vector<std::vector<Tracklet>>(mTrkParams.TrackletsPerRoad()));
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int rof0 = 0; rof0 < nRof; ++rof0) {
+    auto& tracklets{rofTracklets[rof0]};
     gsl::span<const Vertex> primaryVertices = tf->getPrimaryVertices(rof0);
     int minRof = (rof0 >= mTrkParams.DeltaROF) ? rof0 - mTrkParams.DeltaROF : 0;
     int maxRof = (rof0 == tf->getNrof() - mTrkParams.DeltaROF) ? rof0 : rof0 + mTrkParams.DeltaROF;
@@ -81,6 +95,13 @@ void TrackerTraitsCPU::computeLayerTracklets()
             if (layer1.empty()) {
               continue;
             }
+            /// The candidates are selected on the cluster columns, the clusters are only read for the accepted ones
+            const ClusterColumns& columns1{tf->getClusterColumns(iLayer + 1)};
+            const int offset1{tf->getSortedIndex(rof1, iLayer + 1, 0)};
+            const float* const radius1{columns1.radius.data() + offset1};
+            const float* const z1{columns1.zCoordinate.data() + offset1};
+            const float* const phi1{columns1.phi.data() + offset1};
+            const int* const clusterId1{columns1.clusterId.data() + offset1};
 
             for (int iPhiCount{0}; iPhiCount < phiBinsNum; iPhiCount++) {
               int iPhiBin = (selectedBinsRect.y + iPhiCount) % mTrkParams.PhiBins;
@@ -103,15 +124,13 @@ void TrackerTraitsCPU::computeLayerTracklets()
                 if (iNextCluster >= (int)layer1.size()) {
                   break;
                 }
-                const Cluster& nextCluster{layer1[iNextCluster]};
-
-                if (tf->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
+                if (tf->isClusterUsed(iLayer + 1, clusterId1[iNextCluster])) {
                   continue;
                 }
 
-                const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.radius - currentCluster.radius) +
-                                                           currentCluster.zCoordinate - nextCluster.zCoordinate)};
-                const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phi - nextCluster.phi)};
+                const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (radius1[iNextCluster] - currentCluster.radius) +
+                                                           currentCluster.zCoordinate - z1[iNextCluster])};
+                const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phi - phi1[iNextCluster])};
 
                 if (deltaZ < mTrkParams.TrackletMaxDeltaZ[iLayer] &&
                     (deltaPhi < mTrkParams.TrackletMaxDeltaPhi ||
@@ -119,8 +138,8 @@ void TrackerTraitsCPU::computeLayerTracklets()
                   if (iLayer > 0) {
                     tf->getTrackletsLookupTable()[iLayer - 1][currentSortedIndex]++;
                   }
-                  tf->getTracklets()[iLayer].emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), currentCluster,
-                                                          nextCluster, rof0, rof1);
+                  tracklets[iLayer].emplace_back(currentSortedIndex, offset1 + iNextCluster, currentCluster,
+                                                 layer1[iNextCluster], rof0, rof1);
                 }
               }
             }
@@ -129,9 +148,25 @@ void TrackerTraitsCPU::computeLayerTracklets()
       }
     }
   }
-  /// Cold code, fixups
+  /// The tracklets are merged in the ROF order, i.e. in the order of a single thread
+  for (int iLayer{0}; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
+    size_t nTracklets{0};
+    for (auto& tracklets : rofTracklets) {
+      nTracklets += tracklets[iLayer].size();
+    }
+    auto& layerTracklets{tf->getTracklets()[iLayer]};
+    layerTracklets.reserve(layerTracklets.size() + nTracklets);
+    for (auto& tracklets : rofTracklets) {
+      layerTracklets.insert(layerTracklets.end(), tracklets[iLayer].begin(), tracklets[iLayer].end());
+    }
+  }
+  rofTracklets.clear();
 
-  for (int iLayer{0}; iLayer < mTrkParams.CellsPerRoad(); ++iLayer) {
+  /// Cold code, fixups. Each layer only touches its own tracklets and lookup table.
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads)
+#endif
+  for (int iLayer = 0; iLayer < mTrkParams.CellsPerRoad(); ++iLayer) {
     /// Sort tracklets
     auto& trkl{tf->getTracklets()[iLayer + 1]};
     std::sort(trkl.begin(), trkl.end(), [](const Tracklet& a, const Tracklet& b) {
@@ -175,7 +210,10 @@ void TrackerTraitsCPU::computeLayerTracklets()
 
   /// Create tracklets labels
   if (tf->hasMCinformation()) {
-    for (int iLayer{0}; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads)
+#endif
+    for (int iLayer = 0; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
       for (auto& trk : tf->getTracklets()[iLayer]) {
         MCCompLabel label;
         int currentId{tf->getClusters()[iLayer][trk.firstClusterIndex].clusterId};
@@ -209,110 +247,131 @@ void TrackerTraitsCPU::computeLayerCells()
 
     const int currentLayerTrackletsNum{static_cast<int>(tf->getTracklets()[iLayer].size())};
 
-    for (int iTracklet{0}; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
-
-      const Tracklet& currentTracklet{tf->getTracklets()[iLayer][iTracklet]};
-      const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
-      const int nextLayerFirstTrackletIndex{
-        tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex]};
-      const int nextLayerLastTrackletIndex{
-        tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex + 1]};
-
-      if (nextLayerFirstTrackletIndex == nextLayerLastTrackletIndex) {
-        continue;
-      }
-
-      const Cluster& cellClus0{tf->getClusters()[iLayer][currentTracklet.firstClusterIndex]};
-      const Cluster& cellClus1{
-        tf->getClusters()[iLayer + 1][currentTracklet.secondClusterIndex]};
-      const float cellClus0R2{cellClus0.radius * cellClus0.radius};
-      const float cellClus1R2{cellClus1.radius * cellClus1.radius};
-      const float3 firstDeltaVector{cellClus1.xCoordinate - cellClus0.xCoordinate,
-                                    cellClus1.yCoordinate - cellClus0.yCoordinate,
-                                    cellClus1R2 - cellClus0R2};
-
-      for (int iNextTracklet{nextLayerFirstTrackletIndex}; iNextTracklet < nextLayerLastTrackletIndex; ++iNextTracklet) {
-        if (tf->getTracklets()[iLayer + 1][iNextTracklet].firstClusterIndex != nextLayerClusterIndex) {
-          break;
+    /// The tracklets are split in contiguous chunks, each one filling its own cells
+    const int nChunks{std::max(1, std::min(currentLayerTrackletsNum, mNThreads * 4))};
+    std::vector<std::vector<Cell>> chunkCells(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+      auto& cells{chunkCells[iChunk]};
+      const int firstTracklet{static_cast<int>(static_cast<long>(iChunk) * currentLayerTrackletsNum / nChunks)};
+      const int lastTracklet{static_cast<int>(static_cast<long>(iChunk + 1) * currentLayerTrackletsNum / nChunks)};
+      for (int iTracklet{firstTracklet}; iTracklet < lastTracklet; ++iTracklet) {
+        const Tracklet& currentTracklet{tf->getTracklets()[iLayer][iTracklet]};
+        const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
+        const int nextLayerFirstTrackletIndex{
+          tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex]};
+        const int nextLayerLastTrackletIndex{
+          tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex + 1]};
+
+        if (nextLayerFirstTrackletIndex == nextLayerLastTrackletIndex) {
+          continue;
         }
-        const Tracklet& nextTracklet{tf->getTracklets()[iLayer + 1][iNextTracklet]};
-        const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
-        const float deltaPhi{std::abs(currentTracklet.phi - nextTracklet.phi)};
-
-        if (deltaTanLambda < mTrkParams.CellMaxDeltaTanLambda &&
-            (deltaPhi < mTrkParams.CellMaxDeltaPhi ||
-             std::abs(deltaPhi - constants::math::TwoPi) < mTrkParams.CellMaxDeltaPhi)) {
-
-          const float averageTanLambda{0.5f * (currentTracklet.tanLambda + nextTracklet.tanLambda)};
-          const float directionZIntersection{-averageTanLambda * cellClus0.radius +
-                                             cellClus0.zCoordinate};
-
-          unsigned short romin = std::min(std::min(currentTracklet.rof[0], currentTracklet.rof[1]), nextTracklet.rof[1]);
-          unsigned short romax = std::max(std::max(currentTracklet.rof[0], currentTracklet.rof[1]), nextTracklet.rof[1]);
-          bool deltaZflag{false};
-          gsl::span<const Vertex> primaryVertices{tf->getPrimaryVertices(romin, romax)};
-          for (const auto& primaryVertex : primaryVertices) {
-            deltaZflag |= std::abs(directionZIntersection - primaryVertex.getZ()) < mTrkParams.CellMaxDeltaZ[iLayer];
+
+        const Cluster& cellClus0{tf->getClusters()[iLayer][currentTracklet.firstClusterIndex]};
+        const Cluster& cellClus1{
+          tf->getClusters()[iLayer + 1][currentTracklet.secondClusterIndex]};
+        const float cellClus0R2{cellClus0.radius * cellClus0.radius};
+        const float cellClus1R2{cellClus1.radius * cellClus1.radius};
+        const float3 firstDeltaVector{cellClus1.xCoordinate - cellClus0.xCoordinate,
+                                      cellClus1.yCoordinate - cellClus0.yCoordinate,
+                                      cellClus1R2 - cellClus0R2};
+
+        for (int iNextTracklet{nextLayerFirstTrackletIndex}; iNextTracklet < nextLayerLastTrackletIndex; ++iNextTracklet) {
+          if (tf->getTracklets()[iLayer + 1][iNextTracklet].firstClusterIndex != nextLayerClusterIndex) {
+            break;
           }
+          const Tracklet& nextTracklet{tf->getTracklets()[iLayer + 1][iNextTracklet]};
+          const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
+          const float deltaPhi{std::abs(currentTracklet.phi - nextTracklet.phi)};
+
+          if (deltaTanLambda < mTrkParams.CellMaxDeltaTanLambda &&
+              (deltaPhi < mTrkParams.CellMaxDeltaPhi ||
+               std::abs(deltaPhi - constants::math::TwoPi) < mTrkParams.CellMaxDeltaPhi)) {
+
+            const float averageTanLambda{0.5f * (currentTracklet.tanLambda + nextTracklet.tanLambda)};
+            const float directionZIntersection{-averageTanLambda * cellClus0.radius +
+                                               cellClus0.zCoordinate};
+
+            unsigned short romin = std::min(std::min(currentTracklet.rof[0], currentTracklet.rof[1]), nextTracklet.rof[1]);
+            unsigned short romax = std::max(std::max(currentTracklet.rof[0], currentTracklet.rof[1]), nextTracklet.rof[1]);
+            bool deltaZflag{false};
+            gsl::span<const Vertex> primaryVertices{tf->getPrimaryVertices(romin, romax)};
+            for (const auto& primaryVertex : primaryVertices) {
+              deltaZflag |= std::abs(directionZIntersection - primaryVertex.getZ()) < mTrkParams.CellMaxDeltaZ[iLayer];
+            }
 
-          if (deltaZflag) {
+            if (deltaZflag) {
 
-            const Cluster& thirdCellCluster{
-              tf->getClusters()[iLayer + 2][nextTracklet.secondClusterIndex]};
+              const Cluster& thirdCellCluster{
+                tf->getClusters()[iLayer + 2][nextTracklet.secondClusterIndex]};
 
-            const float thirdCellClusterR2{thirdCellCluster.radius *
-                                           thirdCellCluster.radius};
+              const float thirdCellClusterR2{thirdCellCluster.radius *
+                                             thirdCellCluster.radius};
 
-            const float3 secondDeltaVector{thirdCellCluster.xCoordinate - cellClus0.xCoordinate,
-                                           thirdCellCluster.yCoordinate - cellClus0.yCoordinate,
-                                           thirdCellClusterR2 - cellClus0R2};
+              const float3 secondDeltaVector{thirdCellCluster.xCoordinate - cellClus0.xCoordinate,
+                                             thirdCellCluster.yCoordinate - cellClus0.yCoordinate,
+                                             thirdCellClusterR2 - cellClus0R2};
 
-            float3 cellPlaneNormalVector{math_utils::crossProduct(firstDeltaVector, secondDeltaVector)};
+              float3 cellPlaneNormalVector{math_utils::crossProduct(firstDeltaVector, secondDeltaVector)};
 
-            const float vectorNorm{std::hypot(cellPlaneNormalVector.x, cellPlaneNormalVector.y, cellPlaneNormalVector.z)};
+              const float vectorNorm{std::hypot(cellPlaneNormalVector.x, cellPlaneNormalVector.y, cellPlaneNormalVector.z)};
 
-            if (vectorNorm < constants::math::FloatMinThreshold ||
-                std::abs(cellPlaneNormalVector.z) < constants::math::FloatMinThreshold) {
-              continue;
-            }
+              if (vectorNorm < constants::math::FloatMinThreshold ||
+                  std::abs(cellPlaneNormalVector.z) < constants::math::FloatMinThreshold) {
+                continue;
+              }
 
-            const float inverseVectorNorm{1.0f / vectorNorm};
-            const float3 normVect{cellPlaneNormalVector.x * inverseVectorNorm,
-                                  cellPlaneNormalVector.y * inverseVectorNorm,
-                                  cellPlaneNormalVector.z * inverseVectorNorm};
-            const float planeDistance{-normVect.x * (cellClus1.xCoordinate - tf->getBeamX()) - normVect.y * (cellClus1.yCoordinate - tf->getBeamY()) - normVect.z * cellClus1R2};
-            const float normVectZsquare{normVect.z * normVect.z};
-            const float cellRadius{std::sqrt(
-              (1.0f - normVectZsquare - 4.0f * planeDistance * normVect.z) /
-              (4.0f * normVectZsquare))};
-            const float2 circleCenter{-0.5f * normVect.x / normVect.z,
-                                      -0.5f * normVect.y / normVect.z};
-            const float dca{std::abs(cellRadius - std::hypot(circleCenter.x, circleCenter.y))};
-
-            if (dca > mTrkParams.CellMaxDCA[iLayer]) {
-              continue;
-            }
+              const float inverseVectorNorm{1.0f / vectorNorm};
+              const float3 normVect{cellPlaneNormalVector.x * inverseVectorNorm,
+                                    cellPlaneNormalVector.y * inverseVectorNorm,
+                                    cellPlaneNormalVector.z * inverseVectorNorm};
+              const float planeDistance{-normVect.x * (cellClus1.xCoordinate - tf->getBeamX()) - normVect.y * (cellClus1.yCoordinate - tf->getBeamY()) - normVect.z * cellClus1R2};
+              const float normVectZsquare{normVect.z * normVect.z};
+              const float cellRadius{std::sqrt(
+                (1.0f - normVectZsquare - 4.0f * planeDistance * normVect.z) /
+                (4.0f * normVectZsquare))};
+              const float2 circleCenter{-0.5f * normVect.x / normVect.z,
+                                        -0.5f * normVect.y / normVect.z};
+              const float dca{std::abs(cellRadius - std::hypot(circleCenter.x, circleCenter.y))};
+
+              if (dca > mTrkParams.CellMaxDCA[iLayer]) {
+                continue;
+              }
 
-            const float cellTrajectoryCurvature{1.0f / cellRadius};
-            if (iLayer > 0 && tf->getCellsLookupTable()[iLayer - 1].size() <= iTracklet) {
-              tf->getCellsLookupTable()[iLayer - 1].resize(iTracklet + 1, tf->getCells()[iLayer].size());
+              const float cellTrajectoryCurvature{1.0f / cellRadius};
+              cells.emplace_back(
+                currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
+                iTracklet, iNextTracklet, normVect, cellTrajectoryCurvature);
             }
-
-            tf->getCells()[iLayer].emplace_back(
-              currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
-              iTracklet, iNextTracklet, normVect, cellTrajectoryCurvature);
           }
         }
       }
     }
+
+    /// The cells are merged in the order of the tracklets, i.e. in the order of a single thread
+    auto& layerCells{tf->getCells()[iLayer]};
+    for (auto& cells : chunkCells) {
+      layerCells.insert(layerCells.end(), cells.begin(), cells.end());
+    }
     if (iLayer > 0) {
-      tf->getCellsLookupTable()[iLayer - 1].resize(currentLayerTrackletsNum + 1, tf->getCells()[iLayer].size());
+      /// Index of the first cell of each tracklet
+      auto& lut{tf->getCellsLookupTable()[iLayer - 1]};
+      lut.assign(currentLayerTrackletsNum + 1, 0);
+      for (auto& cell : layerCells) {
+        lut[cell.getFirstTrackletIndex() + 1]++;
+      }
+      std::inclusive_scan(lut.begin(), lut.end(), lut.begin());
     }
   }
 
   /// Create cells labels
   if (tf->hasMCinformation()) {
-    for (int iLayer{0}; iLayer < mTrkParams.CellsPerRoad(); ++iLayer) {
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads)
+#endif
+    for (int iLayer = 0; iLayer < mTrkParams.CellsPerRoad(); ++iLayer) {
       for (auto& cell : tf->getCells()[iLayer]) {
         MCCompLabel currentLab{tf->getTrackletsLabel(iLayer)[cell.getFirstTrackletIndex()]};
         MCCompLabel nextLab{tf->getTrackletsLabel(iLayer + 1)[cell.getSecondTrackletIndex()]};
@@ -0,0 +1,187 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTrackerThreads.cxx
+/// \brief Checks that the CPU tracker output does not depend on the number of threads
+
+#define BOOST_TEST_MODULE Test ITS tracker threads
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "ITStracking/TimeFrame.h"
+#include "ITStracking/Tracker.h"
+#include "ITStracking/TrackerTraitsCPU.h"
+#include "DetectorsBase/Propagator.h"
+#include "Field/MagneticField.h"
+
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace o2::its;
+
+namespace
+{
+
+constexpr int NROFs = 3;
+constexpr int NTracksPerROF = 40;
+constexpr int NNoisePerLayer = 20;
+
+/// Straight tracks from the nominal vertex plus random noise, in a few readout frames
+void fillTimeFrame(TimeFrame& tf, const TrackingParameters& params)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> phiDist(0.f, 2.f * M_PI);
+  std::uniform_real_distribution<float> tglDist(-0.3f, 0.3f);
+  std::normal_distribution<float> smear(0.f, 5.e-4f);
+  int externalIndex{0};
+  auto addCluster = [&](int layer, float phi, float z) {
+    const float r{params.LayerRadii[layer]};
+    const float y{smear(gen)};
+    // The tracking frame of the sensor is rotated by phi, with x along the radius
+    tf.addClusterToROFrame(layer, r * std::cos(phi) - y * std::sin(phi), r * std::sin(phi) + y * std::cos(phi), z, r, phi,
+                           {y, z}, {2.5e-7f, 0.f, 2.5e-7f}, externalIndex++);
+  };
+  for (int iROF{0}; iROF < NROFs; ++iROF) {
+    for (int iTrack{0}; iTrack < NTracksPerROF; ++iTrack) {
+      const float phi{phiDist(gen)};
+      const float tgl{tglDist(gen)};
+      for (int iLayer{0}; iLayer < params.NLayers; ++iLayer) {
+        addCluster(iLayer, phi, params.LayerRadii[iLayer] * tgl + smear(gen));
+      }
+    }
+    for (int iLayer{0}; iLayer < params.NLayers; ++iLayer) {
+      for (int iNoise{0}; iNoise < NNoisePerLayer; ++iNoise) {
+        addCluster(iLayer, phiDist(gen), params.LayerRadii[iLayer] * tglDist(gen));
+      }
+    }
+    tf.closeROFrame();
+  }
+  for (int iROF{0}; iROF < NROFs; ++iROF) {
+    std::vector<Vertex> vertices(1);
+    vertices.back().setNContributors(1);
+    tf.addPrimaryVertices(vertices);
+  }
+}
+
+void initPropagator()
+{
+  if (!gGeoManager) {
+    new TGeoManager("ITStest", "ITS tracker test");
+  }
+  if (!TGeoGlobalMagField::Instance()->GetField()) {
+    TGeoGlobalMagField::Instance()->SetField(o2::field::MagneticField::createNominalField(5, true));
+    TGeoGlobalMagField::Instance()->Lock();
+  }
+  o2::base::Propagator::Instance();
+}
+
+void runTracker(TimeFrame& tf, int nThreads)
+{
+  TrackerTraitsCPU traits;
+  Tracker tracker(&traits);
+  tracker.setCorrType(o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrNONE);
+  tracker.setBz(5.f);
+  tracker.setNThreads(nThreads);
+  tracker.adoptTimeFrame(tf);
+  tracker.clustersToTracks([](std::string) {});
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TrackerThreads_test)
+{
+  initPropagator();
+  TrackingParameters params;
+
+  TimeFrame serial, parallel;
+  fillTimeFrame(serial, params);
+  fillTimeFrame(parallel, params);
+  runTracker(serial, 1);
+  runTracker(parallel, 4);
+
+  // Tracklets
+  BOOST_REQUIRE_EQUAL(serial.getTracklets().size(), parallel.getTracklets().size());
+  size_t nTracklets{0};
+  for (size_t iLayer{0}; iLayer < serial.getTracklets().size(); ++iLayer) {
+    auto& expected{serial.getTracklets()[iLayer]};
+    auto& result{parallel.getTracklets()[iLayer]};
+    BOOST_REQUIRE_EQUAL(expected.size(), result.size());
+    for (size_t iT{0}; iT < expected.size(); ++iT) {
+      BOOST_CHECK_EQUAL(expected[iT].firstClusterIndex, result[iT].firstClusterIndex);
+      BOOST_CHECK_EQUAL(expected[iT].secondClusterIndex, result[iT].secondClusterIndex);
+      BOOST_CHECK_EQUAL(expected[iT].tanLambda, result[iT].tanLambda);
+      BOOST_CHECK_EQUAL(expected[iT].phi, result[iT].phi);
+      BOOST_CHECK_EQUAL(expected[iT].rof[0], result[iT].rof[0]);
+      BOOST_CHECK_EQUAL(expected[iT].rof[1], result[iT].rof[1]);
+    }
+    nTracklets += expected.size();
+  }
+  BOOST_CHECK(nTracklets > 0);
+
+  // Cells
+  BOOST_REQUIRE_EQUAL(serial.getCells().size(), parallel.getCells().size());
+  size_t nCells{0};
+  for (size_t iLayer{0}; iLayer < serial.getCells().size(); ++iLayer) {
+    auto& expected{serial.getCells()[iLayer]};
+    auto& result{parallel.getCells()[iLayer]};
+    BOOST_REQUIRE_EQUAL(expected.size(), result.size());
+    for (size_t iC{0}; iC < expected.size(); ++iC) {
+      BOOST_CHECK_EQUAL(expected[iC].getFirstClusterIndex(), result[iC].getFirstClusterIndex());
+      BOOST_CHECK_EQUAL(expected[iC].getSecondClusterIndex(), result[iC].getSecondClusterIndex());
+      BOOST_CHECK_EQUAL(expected[iC].getThirdClusterIndex(), result[iC].getThirdClusterIndex());
+      BOOST_CHECK_EQUAL(expected[iC].getFirstTrackletIndex(), result[iC].getFirstTrackletIndex());
+      BOOST_CHECK_EQUAL(expected[iC].getSecondTrackletIndex(), result[iC].getSecondTrackletIndex());
+      BOOST_CHECK_EQUAL(expected[iC].getLevel(), result[iC].getLevel());
+      BOOST_CHECK_EQUAL(expected[iC].getCurvature(), result[iC].getCurvature());
+    }
+    nCells += expected.size();
+  }
+  BOOST_CHECK(nCells > 0);
+
+  // Roads
+  BOOST_REQUIRE_EQUAL(serial.getRoads().size(), parallel.getRoads().size());
+  BOOST_CHECK(serial.getRoads().size() > 0);
+  for (size_t iR{0}; iR < serial.getRoads().size(); ++iR) {
+    auto& expected{serial.getRoads()[iR]};
+    auto& result{parallel.getRoads()[iR]};
+    BOOST_CHECK_EQUAL(expected.getRoadSize(), result.getRoadSize());
+    for (int iC{0}; iC < params.CellsPerRoad(); ++iC) {
+      BOOST_CHECK_EQUAL(expected[iC], result[iC]);
+    }
+  }
+
+  // Tracks
+  size_t nTracks{0};
+  for (int iROF{0}; iROF < NROFs; ++iROF) {
+    auto& expected{serial.getTracks(iROF)};
+    auto& result{parallel.getTracks(iROF)};
+    BOOST_REQUIRE_EQUAL(expected.size(), result.size());
+    for (size_t iT{0}; iT < expected.size(); ++iT) {
+      BOOST_CHECK_EQUAL(expected[iT].getX(), result[iT].getX());
+      BOOST_CHECK_EQUAL(expected[iT].getAlpha(), result[iT].getAlpha());
+      for (int iP{0}; iP < 5; ++iP) {
+        BOOST_CHECK_EQUAL(expected[iT].getParam(iP), result[iT].getParam(iP));
+      }
+      BOOST_CHECK_EQUAL(expected[iT].getChi2(), result[iT].getChi2());
+      for (int iLayer{0}; iLayer < params.NLayers; ++iLayer) {
+        BOOST_CHECK_EQUAL(expected[iT].getClusterIndex(iLayer), result[iT].getClusterIndex(iLayer));
+      }
+    }
+    nTracks += expected.size();
+  }
+  BOOST_CHECK(nTracks > 0);
+}
@@ -82,6 +82,7 @@ void TrackerDPL::init(InitContext& ic)
     auto* chainITS = mRecChain->AddChain<o2::gpu::GPUChainITS>();
     mVertexer = std::make_unique<Vertexer>(chainITS->GetITSVertexerTraits());
     mTracker = std::make_unique<Tracker>(new TrackerTraitsCPU);
+    mTracker->setNThreads(ic.options().get<int>("nthreads"));
 
     std::vector<TrackingParameters> trackParams;
     std::vector<MemoryParameters> memParams;
@@ -386,7 +387,8 @@ DataProcessorSpec getTrackerSpec(bool useMC, const std::string& trModeS, o2::gpu
     AlgorithmSpec{adaptFromTask<TrackerDPL>(useMC, trModeS, dType)},
     Options{
       {"grp-file", VariantType::String, "o2sim_grp.root", {"Name of the grp file"}},
-      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}}}};
+      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads of the CPU tracker"}}}};
 }
 
 } // namespace its
@@ -115,21 +115,48 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>& rofRecVec, co
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
-  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-#define ENCODEITSMFT(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
-  // clang-format off
-  ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
-  ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
-  ENCODEITSMFT(compCl.orbitIncROF, CTF::BLCorbitIncROF, 0);
-  ENCODEITSMFT(compCl.nclusROF, CTF::BLCnclusROF, 0);
-  //
-  ENCODEITSMFT(compCl.chipInc, CTF::BLCchipInc, 0);
-  ENCODEITSMFT(compCl.chipMul, CTF::BLCchipMul, 0);
-  ENCODEITSMFT(compCl.row, CTF::BLCrow, 0);
-  ENCODEITSMFT(compCl.colInc, CTF::BLCcolInc, 0);
-  ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
-  ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
-  // clang-format on
+  if (getNThreads() > 1) {
+    // encode the blocks concurrently to standalone images, then store them in the flat buffer in slot order
+    std::array<o2::ctf::EncodedSlot<>, CTF::getNBlocks()> slots;
+    const auto& ecs = *CTF::get(buff.data());
+#define ENCODEITSMFT(part, slot, bits) [&]() { ecs.encodeToScratch(part, int(slot), slots[int(slot)], bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor(), getCoderCache()); }
+    // clang-format off
+    runParallel({
+      ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0),
+      ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0),
+      ENCODEITSMFT(compCl.orbitIncROF, CTF::BLCorbitIncROF, 0),
+      ENCODEITSMFT(compCl.nclusROF, CTF::BLCnclusROF, 0),
+      //
+      ENCODEITSMFT(compCl.chipInc, CTF::BLCchipInc, 0),
+      ENCODEITSMFT(compCl.chipMul, CTF::BLCchipMul, 0),
+      ENCODEITSMFT(compCl.row, CTF::BLCrow, 0),
+      ENCODEITSMFT(compCl.colInc, CTF::BLCcolInc, 0),
+      ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0),
+      ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0)
+    });
+    // clang-format on
+#undef ENCODEITSMFT
+    for (int slot = 0; slot < CTF::getNBlocks(); slot++) {
+      CTF::get(buff.data())->storeEncodedSlot(slots[slot], slot, &buff);
+    }
+  } else {
+    // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
+#define ENCODEITSMFT(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor(), getCoderCache());
+    // clang-format off
+    ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
+    ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
+    ENCODEITSMFT(compCl.orbitIncROF, CTF::BLCorbitIncROF, 0);
+    ENCODEITSMFT(compCl.nclusROF, CTF::BLCnclusROF, 0);
+    //
+    ENCODEITSMFT(compCl.chipInc, CTF::BLCchipInc, 0);
+    ENCODEITSMFT(compCl.chipMul, CTF::BLCchipMul, 0);
+    ENCODEITSMFT(compCl.row, CTF::BLCrow, 0);
+    ENCODEITSMFT(compCl.colInc, CTF::BLCcolInc, 0);
+    ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
+    ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
+    // clang-format on
+#undef ENCODEITSMFT
+  }
   CTF::get(buff.data())->print(getPrefix());
 }
 
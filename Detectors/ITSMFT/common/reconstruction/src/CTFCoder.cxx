@@ -216,19 +216,23 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec)
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
   ec.print(getPrefix());
-#define DECODEITSMFT(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  // blocks are independent, decode them concurrently if allowed
+#define DECODEITSMFT(part, slot) [&]() { ec.decode(part, int(slot), mCoders[int(slot)].get(), getCoderCache()); }
   // clang-format off
-  DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF);
-  DECODEITSMFT(cc.bcIncROF,     CTF::BLCbcIncROF);
-  DECODEITSMFT(cc.orbitIncROF,  CTF::BLCorbitIncROF);
-  DECODEITSMFT(cc.nclusROF,     CTF::BLCnclusROF);
-  //
-  DECODEITSMFT(cc.chipInc,      CTF::BLCchipInc);
-  DECODEITSMFT(cc.chipMul,      CTF::BLCchipMul);
-  DECODEITSMFT(cc.row,          CTF::BLCrow);
-  DECODEITSMFT(cc.colInc,       CTF::BLCcolInc);
-  DECODEITSMFT(cc.pattID,       CTF::BLCpattID);
-  DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap);
+  runParallel({
+    DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF),
+    DECODEITSMFT(cc.bcIncROF,     CTF::BLCbcIncROF),
+    DECODEITSMFT(cc.orbitIncROF,  CTF::BLCorbitIncROF),
+    DECODEITSMFT(cc.nclusROF,     CTF::BLCnclusROF),
+    //
+    DECODEITSMFT(cc.chipInc,      CTF::BLCchipInc),
+    DECODEITSMFT(cc.chipMul,      CTF::BLCchipMul),
+    DECODEITSMFT(cc.row,          CTF::BLCrow),
+    DECODEITSMFT(cc.colInc,       CTF::BLCcolInc),
+    DECODEITSMFT(cc.pattID,       CTF::BLCpattID),
+    DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap)
+  });
   // clang-format on
+#undef DECODEITSMFT
   return cc;
 }
\ No newline at end of file
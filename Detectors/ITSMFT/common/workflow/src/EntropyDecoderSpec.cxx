@@ -41,6 +41,8 @@ void EntropyDecoderSpec::init(o2::framework::InitContext& ic)
   mClusDictPath = o2::header::gDataOriginITS ? o2::itsmft::ClustererParam<o2::detectors::DetID::ITS>::Instance().dictFilePath : o2::itsmft::ClustererParam<o2::detectors::DetID::MFT>::Instance().dictFilePath;
   mClusDictPath = o2::base::NameConf::getAlpideClusterDictionaryFileName(detID, mClusDictPath, "bin");
   mMaskNoise = ic.options().get<bool>("mask-noise");
+  mCTFCoder.setNThreads(ic.options().get<int>("ctf-threads"));
+  mCTFCoder.setCoderCacheDrift(ic.options().get<float>("ctf-cache-drift"));
   mNoiseFilePath = o2::header::gDataOriginITS ? o2::itsmft::ClustererParam<o2::detectors::DetID::ITS>::Instance().noiseFilePath : o2::itsmft::ClustererParam<o2::detectors::DetID::MFT>::Instance().noiseFilePath;
   mNoiseFilePath = o2::base::NameConf::getNoiseFileName(detID, mNoiseFilePath, "root");
 }
@@ -125,7 +127,9 @@ DataProcessorSpec getEntropyDecoderSpec(o2::header::DataOrigin orig, bool getDig
     AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(orig, getDigits)},
     Options{
       {"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF decoding dictionary"}},
-      {"mask-noise", VariantType::Bool, false, {"apply noise mask to digits or clusters (involves reclusterization)"}}}};
+      {"mask-noise", VariantType::Bool, false, {"apply noise mask to digits or clusters (involves reclusterization)"}},
+      {"ctf-threads", VariantType::Int, 1, {"Number of threads to decode CTF blocks concurrently"}},
+      {"ctf-cache-drift", VariantType::Float, -1.f, {"Reuse decoders of previous TFs for blocks with identical stored dictionary, <0: disable"}}}};
 }
 
 } // namespace itsmft
@@ -38,6 +38,8 @@ void EntropyEncoderSpec::init(o2::framework::InitContext& ic)
 {
   std::string dictPath = ic.options().get<std::string>("ctf-dict");
   mCTFCoder.setMemMarginFactor(ic.options().get<float>("mem-factor"));
+  mCTFCoder.setNThreads(ic.options().get<int>("ctf-threads"));
+  mCTFCoder.setCoderCacheDrift(ic.options().get<float>("ctf-cache-drift"));
   if (!dictPath.empty() && dictPath != "none") {
     mCTFCoder.createCoders(dictPath, o2::ctf::CTFCoderBase::OpType::Encoder);
   }
@@ -80,7 +82,9 @@ DataProcessorSpec getEntropyEncoderSpec(o2::header::DataOrigin orig)
     Outputs{{orig, "CTFDATA", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<EntropyEncoderSpec>(orig)},
     Options{{"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF encoding dictionary"}},
-            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}}}};
+            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
+            {"ctf-threads", VariantType::Int, 1, {"Number of threads to encode CTF blocks concurrently"}},
+            {"ctf-cache-drift", VariantType::Float, -1.f, {"Reuse coders of previous TFs for blocks w/o external dictionary while statistics drift (bits/symbol) is below this value, <0: disable"}}}};
 }
 
 } // namespace itsmft
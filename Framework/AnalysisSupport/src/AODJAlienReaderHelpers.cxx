@@ -32,6 +32,7 @@
 #include <TGrid.h>
 #include <TFile.h>
 #include <TTreeCache.h>
+#include <TROOT.h>
 
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
@@ -39,6 +40,8 @@
 #include <arrow/table.h>
 #include <arrow/util/key_value_metadata.h>
 
+#include <future>
+#include <optional>
 #include <thread>
 
 using namespace o2;
@@ -87,21 +90,6 @@ struct RuntimeWatchdog {
   }
 };
 
-template <typename... C>
-static constexpr auto columnNamesTrait(framework::pack<C...>)
-{
-  return std::vector<std::string>{C::columnLabel()...};
-}
-
-std::vector<std::string> getColumnNames(header::DataHeader dh)
-{
-  auto description = std::string(dh.dataDescription.str);
-  auto origin = std::string(dh.dataOrigin.str);
-
-  // default: column names = {}
-  return std::vector<std::string>({});
-}
-
 using o2::monitoring::Metric;
 using o2::monitoring::Monitoring;
 using o2::monitoring::tags::Key;
@@ -119,6 +107,69 @@ auto setEOSCallback(InitContext& ic)
                                            });
 }
 
+/// Fill @a t2t with the tree @a tr, which is deleted afterwards. Only the
+/// branches in @a colnames are read, unless it is empty.
+static void readTable(TreeToTable& t2t, TTree* tr, std::vector<std::string>&& colnames, size_t& totalSizeCompressed, size_t& totalSizeUncompressed)
+{
+  t2t.setLabel(tr->GetName());
+  if (colnames.size() == 0) {
+    totalSizeCompressed += tr->GetZipBytes();
+    totalSizeUncompressed += tr->GetTotBytes();
+    t2t.addAllColumns(tr);
+  } else {
+    for (auto& colname : colnames) {
+      TBranch* branch = tr->GetBranch(colname.c_str());
+      if (branch == nullptr) {
+        continue;
+      }
+      totalSizeCompressed += branch->GetZipBytes("*");
+      totalSizeUncompressed += branch->GetTotBytes("*");
+    }
+    t2t.addAllColumns(tr, std::move(colnames));
+  }
+  t2t.fill(tr);
+  delete tr;
+}
+
+/// The tables of a dataframe, read while the previous one is being processed
+struct ReadAheadDataFrame {
+  int fileCounter = -1;
+  int numTF = -1;
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  size_t sizeCompressed = 0;
+  size_t sizeUncompressed = 0;
+};
+
+/// Read the tables for @a routes of the dataframe @a ntf of file @a fcnt.
+/// Any failure is left to the regular (synchronous) reading to report.
+static ReadAheadDataFrame readDataFrame(DataInputDirector& didir, std::vector<OutputRoute> const& routes, int fcnt, int ntf)
+{
+  ReadAheadDataFrame dataFrame;
+  try {
+    for (auto& route : routes) {
+      auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+      auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
+      if (auto table = didir.getDataTable(dh, fcnt, ntf)) {
+        dataFrame.tables.push_back(table);
+        continue;
+      }
+      TTree* tr = didir.getDataTree(dh, fcnt, ntf);
+      if (!tr) {
+        return {};
+      }
+      TreeToTable t2t;
+      readTable(t2t, tr, didir.getColumnsToRead(dh), dataFrame.sizeCompressed, dataFrame.sizeUncompressed);
+      dataFrame.tables.push_back(t2t.finalize());
+    }
+  } catch (std::exception const& e) {
+    LOGP(WARNING, "Could not read ahead time frame {} of file {}: {}", ntf, fcnt, e.what());
+    return {};
+  }
+  dataFrame.fileCounter = fcnt;
+  dataFrame.numTF = ntf;
+  return dataFrame;
+}
+
 template <typename O>
 static inline auto extractTypedOriginal(ProcessingContext& pc)
 {
@@ -178,9 +229,22 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       }
     }
 
+    // only read the columns which are used by the workflow
+    didir->setColumnsToRead(options.get<std::string>("aod-reader-columns"));
+
     // get the run time watchdog
     auto* watchdog = new RuntimeWatchdog(options.get<int64_t>("time-limit"));
 
+    // Reading ahead happens on another thread, which therefore needs to be
+    // allowed to use ROOT. The files are still only accessed by one thread at
+    // the time, since each call waits for the read ahead of the previous one
+    // to be over.
+    auto readAhead = std::make_shared<std::future<ReadAheadDataFrame>>();
+    bool readAheadEnabled = options.get<bool>("aod-reader-read-ahead");
+    if (readAheadEnabled) {
+      ROOT::EnableThreadSafety();
+    }
+
     // selected the TFN input and
     // create list of requested tables
     header::DataHeader TFNumberHeader;
@@ -202,7 +266,9 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
                            fileCounter,
                            numTF,
                            watchdog,
-                           didir](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
+                           didir,
+                           readAhead,
+                           readAheadEnabled](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
       // Each parallel reader device.inputTimesliceId reads the files fileCounter*device.maxInputTimeslices+device.inputTimesliceId
       // the TF to read is numTF
       assert(device.inputTimesliceId < device.maxInputTimeslices);
@@ -225,6 +291,17 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       static auto currentFileStartedAt = uv_hrtime();
       static uint64_t currentFileIOTime = 0;
 
+      // the tables read ahead are used if they are for the expected dataframe
+      std::optional<ReadAheadDataFrame> prefetched;
+      if (readAhead->valid()) {
+        prefetched = readAhead->get();
+        if (prefetched->fileCounter != fcnt || prefetched->numTF != ntf) {
+          prefetched.reset();
+        }
+      }
+      std::vector<OutputRoute> laneTables;
+      header::DataHeader firstHeader;
+
       // check if RuntimeLimit is reached
       if (!watchdog->update()) {
         LOGP(INFO, "Run time exceeds run time limit of {} seconds. Exiting gracefully...", watchdog->runTimeLimit);
@@ -244,13 +321,29 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
           continue;
         }
 
+        laneTables.push_back(route);
+
         // create header
         auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
         auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
 
-        // create a TreeToTable object
-        TTree* tr = didir->getDataTree(dh, fcnt, ntf);
-        if (!tr) {
+        if (prefetched) {
+          if (first) {
+            firstHeader = dh;
+            timeFrameNumber = didir->getTimeFrameNumber(dh, fcnt, ntf);
+            auto o = Output(TFNumberHeader);
+            outputs.make<uint64_t>(o) = timeFrameNumber;
+          }
+          outputs.adopt(Output(dh), prefetched->tables[laneTables.size() - 1]);
+          first = false;
+          continue;
+        }
+
+        // inputs in the arrow format provide the table directly, the
+        // others a tree to be converted with a TreeToTable object
+        auto table = didir->getDataTable(dh, fcnt, ntf);
+        TTree* tr = table ? nullptr : didir->getDataTree(dh, fcnt, ntf);
+        if (!tr && !table) {
           if (first) {
             // dump metrics of file which is done for reading
             dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
@@ -269,8 +362,9 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
             }
             // get first folder of next file
             ntf = 0;
-            tr = didir->getDataTree(dh, fcnt, ntf);
-            if (!tr) {
+            table = didir->getDataTable(dh, fcnt, ntf);
+            tr = table ? nullptr : didir->getDataTree(dh, fcnt, ntf);
+            if (!tr && !table) {
               LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin, fcnt, ntf);
               throw std::runtime_error("Processing is stopped!");
             }
@@ -281,33 +375,25 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
         }
 
         if (first) {
+          firstHeader = dh;
           timeFrameNumber = didir->getTimeFrameNumber(dh, fcnt, ntf);
           auto o = Output(TFNumberHeader);
           outputs.make<uint64_t>(o) = timeFrameNumber;
         }
 
+        if (table) {
+          outputs.adopt(Output(dh), table);
+          first = false;
+          continue;
+        }
+
         // create table output
         auto o = Output(dh);
         auto& t2t = outputs.make<TreeToTable>(o);
 
         // add branches to read
         // fill the table
-        auto colnames = getColumnNames(dh);
-        t2t.setLabel(tr->GetName());
-        if (colnames.size() == 0) {
-          totalSizeCompressed += tr->GetZipBytes();
-          totalSizeUncompressed += tr->GetTotBytes();
-          t2t.addAllColumns(tr);
-        } else {
-          for (auto& colname : colnames) {
-            TBranch* branch = tr->GetBranch(colname.c_str());
-            totalSizeCompressed += branch->GetZipBytes("*");
-            totalSizeUncompressed += branch->GetTotBytes("*");
-          }
-          t2t.addAllColumns(tr, std::move(colnames));
-        }
-        t2t.fill(tr);
-        delete tr;
+        readTable(t2t, tr, didir->getColumnsToRead(dh), totalSizeCompressed, totalSizeUncompressed);
 
         // needed for metrics dumping (upon next file read, or terminate due to watchdog)
         if (currentFile == nullptr) {
@@ -317,6 +403,10 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 
         first = false;
       }
+      if (prefetched) {
+        totalSizeCompressed += prefetched->sizeCompressed;
+        totalSizeUncompressed += prefetched->sizeUncompressed;
+      }
       monitoring.send(Metric{(uint64_t)ntf, "df-sent"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeUncompressed / 1000, "aod-bytes-read-uncompressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeCompressed / 1000, "aod-bytes-read-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
@@ -325,6 +415,14 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       *fileCounter = (fcnt - device.inputTimesliceId) / device.maxInputTimeslices;
       *numTF = ntf;
       currentFileIOTime += (uv_hrtime() - ioStart);
+
+      // Read the next dataframe of the current file while this one is being
+      // processed downstream. Moving to the next file is left to the next call.
+      if (readAheadEnabled && laneTables.empty() == false && ntf + 1 < didir->getTimeFramesInFile(firstHeader, fcnt)) {
+        *readAhead = std::async(std::launch::async, [didir, laneTables = std::move(laneTables), fcnt, ntf]() {
+          return readDataFrame(*didir, laneTables, fcnt, ntf + 1);
+        });
+      }
     });
   })};
 
@@ -17,7 +17,11 @@
 #include "Framework/RuntimeError.h"
 #include <arrow/table.h>
 
+#include <algorithm>
 #include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
 #include <tuple>
 #include <utility>
 
@@ -1043,6 +1047,208 @@ CombinationsGenerator<P2<T2s...>> combinations(const P2<T2s...>& policy)
   return CombinationsGenerator<P2<T2s...>>(policy);
 }
 
+/// Allocator for the buffers holding the values of materialized columns,
+/// aligned to a cache line so that vectorised loads never straddle one.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+  using value_type = T;
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(AlignedAllocator<U, Alignment> const&)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T* p, std::size_t)
+  {
+    ::operator delete(p, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  bool operator==(AlignedAllocator<U, Alignment> const&) const
+  {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(AlignedAllocator<U, Alignment> const&) const
+  {
+    return false;
+  }
+};
+
+template <typename T>
+using ColumnBuffer = std::vector<T, AlignedAllocator<T>>;
+
+/// Sequential reader of the values of a chunked arrow column of scalars.
+/// The rows are expected to be requested in increasing order, which is
+/// the case for both plain tables and the selections of Filtered ones.
+template <typename T>
+class ChunkedColumnReader
+{
+ public:
+  static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Only columns of numeric scalars can be read in batches");
+
+  ChunkedColumnReader(arrow::ChunkedArray const* column) : mColumn{column}
+  {
+    if (mColumn->num_chunks() > 0) {
+      setChunk(0, 0);
+    }
+  }
+
+  /// @return the values of rows [row, row + n) if they are contiguous in
+  /// memory, i.e. if they belong to the same chunk, nullptr otherwise
+  T const* contiguous(int64_t row, int64_t n)
+  {
+    seek(row);
+    return row + n <= mChunkEnd ? mValues + (row - mChunkBegin) : nullptr;
+  }
+
+  /// Copy the values of rows [row, row + n) to @a out
+  void copy(int64_t row, int64_t n, T* out)
+  {
+    while (n > 0) {
+      seek(row);
+      auto count = std::min(n, mChunkEnd - row);
+      std::copy_n(mValues + (row - mChunkBegin), count, out);
+      row += count;
+      out += count;
+      n -= count;
+    }
+  }
+
+  /// Copy the values of the @a n increasing @a rows to @a out
+  void gather(int64_t const* rows, int64_t n, T* out)
+  {
+    int64_t i = 0;
+    while (i < n) {
+      seek(rows[i]);
+      auto values = mValues - mChunkBegin;
+      // Tight loop over the rows which are in the current chunk
+      for (; i < n && rows[i] < mChunkEnd; ++i) {
+        out[i] = values[rows[i]];
+      }
+    }
+  }
+
+ private:
+  void setChunk(int chunk, int64_t begin)
+  {
+    auto array = std::static_pointer_cast<arrow_array_for_t<T>>(mColumn->chunk(chunk));
+    mChunk = chunk;
+    mChunkBegin = begin;
+    mChunkEnd = begin + array->length();
+    mValues = array->raw_values();
+  }
+
+  void seek(int64_t row)
+  {
+    if (row < mChunkBegin) {
+      setChunk(0, 0);
+    }
+    while (row >= mChunkEnd && mChunk + 1 < mColumn->num_chunks()) {
+      setChunk(mChunk + 1, mChunkEnd);
+    }
+    if (O2_BUILTIN_UNLIKELY(row >= mChunkEnd)) {
+      throw o2::framework::runtime_error_f("Row %lld is beyond the end of the column", static_cast<long long>(row));
+    }
+  }
+
+  arrow::ChunkedArray const* mColumn;
+  T const* mValues = nullptr;
+  int mChunk = 0;
+  int64_t mChunkBegin = 0;
+  int64_t mChunkEnd = 0;
+};
+
+template <typename C, typename T>
+ChunkedColumnReader<typename C::type> makeColumnReader(T const& table)
+{
+  static_assert(C::persistent::value, "Only persistent columns can be read in batches");
+  auto column = getIndexFromLabel(table.asArrowTable().get(), C::columnLabel());
+  return ChunkedColumnReader<typename C::type>{column};
+}
+
+/// Copy the values of the column C for the rows of @a table into the
+/// contiguous buffer @a out. For a Filtered table only the selected rows
+/// are copied, in order, so that out[i] belongs to the i-th row of the
+/// iteration. Loops over the resulting buffers can be vectorised by the
+/// compiler, while those over the row iterators cannot.
+template <typename C, typename T>
+void materializeColumn(T const& table, ColumnBuffer<typename C::type>& out)
+{
+  out.resize(table.size());
+  if (table.size() == 0) {
+    return;
+  }
+  auto reader = makeColumnReader<C>(table);
+  if constexpr (soa::is_soa_filtered_t<T>::value) {
+    reader.gather(table.getSelectedRows().data(), table.size(), out.data());
+  } else {
+    reader.copy(0, table.size(), out.data());
+  }
+}
+
+template <typename C, typename T>
+ColumnBuffer<typename C::type> materializeColumn(T const& table)
+{
+  ColumnBuffer<typename C::type> out;
+  materializeColumn<C>(table, out);
+  return out;
+}
+
+namespace detail
+{
+template <typename T, typename R, typename B>
+auto batchValues(T const& table, R& reader, B& buffer, int64_t first, int64_t n)
+{
+  if constexpr (soa::is_soa_filtered_t<T>::value) {
+    reader.gather(table.getSelectedRows().data() + first, n, buffer.data());
+  } else {
+    if (auto direct = reader.contiguous(first, n); direct != nullptr) {
+      return direct;
+    }
+    reader.copy(first, n, buffer.data());
+  }
+  return static_cast<typename B::value_type const*>(buffer.data());
+}
+
+template <typename... Cs, typename T, typename F, std::size_t... Is>
+void forEachBatchImpl(T const& table, F&& f, int64_t batchSize, std::index_sequence<Is...>)
+{
+  std::tuple<ChunkedColumnReader<typename Cs::type>...> readers{makeColumnReader<Cs>(table)...};
+  std::tuple<ColumnBuffer<typename Cs::type>...> scratch{ColumnBuffer<typename Cs::type>(batchSize)...};
+  auto size = table.size();
+  for (int64_t first = 0; first < size; first += batchSize) {
+    auto n = std::min(batchSize, size - first);
+    f(first, n, batchValues(table, std::get<Is>(readers), std::get<Is>(scratch), first, n)...);
+  }
+}
+} // namespace detail
+
+/// Iterate over the rows of @a table in batches of at most @a batchSize
+/// rows, invoking @a f(first, n, values...) where first is the position of
+/// the first row of the batch in the iteration, n the number of rows and
+/// values a pointer to n contiguous values for each of the columns Cs. The
+/// values point directly into the arrow buffers when possible, otherwise
+/// (selected rows of a Filtered table, batch crossing a chunk boundary) they
+/// are gathered in a scratch buffer which is reused by all the batches.
+template <typename... Cs, typename T, typename F>
+void forEachBatch(T const& table, F&& f, int64_t batchSize = 1024)
+{
+  if (table.size() == 0) {
+    return;
+  }
+  detail::forEachBatchImpl<Cs...>(table, std::forward<F>(f), batchSize, std::index_sequence_for<Cs...>{});
+}
 } // namespace o2::soa
 
 #endif // O2_FRAMEWORK_ASOAHELPERS_H_
@@ -52,14 +52,42 @@ struct WritingCursor<soa::Table<PC...>> {
     return mCount;
   }
 
+  /// Append @a size rows at once. For each persistent column, either a
+  /// pointer to @a size contiguous values or a contiguous container (e.g. a
+  /// std::vector or a gsl::span) holding them is expected. For array columns
+  /// of type T[N], @a size * N values are expected. Can be mixed with the
+  /// row by row filling.
+  template <typename... T>
+  void bulk(int64_t size, T const&... columns)
+  {
+    static_assert(sizeof...(PC) == sizeof...(T), "Argument number mismatch");
+    if (size <= 0) {
+      return;
+    }
+    mBuilder->bulkAppend(typename persistent_table_t::column_types{}, size, columnData<typename PC::type>(columns, size)...);
+    mCount += size;
+  }
+
   bool resetCursor(TableBuilder& builder)
   {
     mBuilder = &builder;
     cursor = std::move(FFL(builder.cursor<persistent_table_t>()));
+    // unless told otherwise, expect as many rows as in the previous timeframe
+    auto hint = mSizeHint > 0 ? mSizeHint : mCount + 1;
+    if (hint > 0) {
+      reserve(hint);
+    }
     mCount = -1;
     return true;
   }
 
+  /// Number of rows to reserve whenever a new table is started. When not
+  /// set, the number of rows of the previous table is used.
+  void setSizeHint(int64_t size)
+  {
+    mSizeHint = size;
+  }
+
   void setLabel(const char* label)
   {
     mBuilder->setLabel(label);
@@ -75,6 +103,21 @@ struct WritingCursor<soa::Table<PC...>> {
   decltype(FFL(std::declval<cursor_t>())) cursor;
 
  private:
+  template <typename C, typename T>
+  static auto columnData(T const& column, int64_t size)
+  {
+    using value_t = typename BulkValueTrait<C>::type;
+    if constexpr (std::is_pointer_v<T>) {
+      return static_cast<value_t const*>(column);
+    } else {
+      constexpr int64_t extent = std::is_array_v<C> ? std::extent_v<C> : 1;
+      if (static_cast<int64_t>(column.size()) < size * extent) {
+        throw runtime_error_f("Not enough values for bulk insertion: %d instead of %d", (int)column.size(), (int)(size * extent));
+      }
+      return static_cast<value_t const*>(column.data());
+    }
+  }
+
   template <typename T>
   static decltype(auto) extract(T const& arg)
   {
@@ -91,6 +134,7 @@ struct WritingCursor<soa::Table<PC...>> {
   /// able to do all-columns methods like reserve.
   TableBuilder* mBuilder = nullptr;
   int64_t mCount = -1;
+  int64_t mSizeHint = 0;
 };
 
 template <typename T>
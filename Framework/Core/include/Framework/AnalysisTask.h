@@ -19,6 +19,7 @@
 #include "Framework/ControlService.h"
 #include "Framework/DataProcessorSpec.h"
 #include "Framework/Expressions.h"
+#include "Framework/GroupIndexCache.h"
 #include "Framework/ExpressionHelpers.h"
 #include "Framework/EndOfStreamContext.h"
 #include "Framework/Logger.h"
@@ -159,6 +160,12 @@ struct AnalysisDataProcessorBuilder {
     return getInputSpecs(typename T::sources_t{});
   }
 
+  template <typename... C>
+  static void appendProjection(framework::pack<C...>, std::vector<ConfigParamSpec>& inputMetadata)
+  {
+    (inputMetadata.emplace_back(ConfigParamSpec{std::string{"projection:"} + C::columnLabel(), VariantType::Bool, true, {"\"\""}}), ...);
+  }
+
   template <typename Arg>
   static void doAppendInputWithMetadata(const char* name, bool value, std::vector<InputSpec>& inputs)
   {
@@ -173,6 +180,9 @@ struct AnalysisDataProcessorBuilder {
       auto last = std::unique(inputSources.begin(), inputSources.end(), [](ConfigParamSpec const& a, ConfigParamSpec const& b) { return a.name == b.name; });
       inputSources.erase(last, inputSources.end());
       inputMetadata.insert(inputMetadata.end(), inputSources.begin(), inputSources.end());
+    } else {
+      // The persistent columns of the table, so that the reader can skip the others
+      appendProjection(typename std::decay_t<Arg>::persistent_columns_t{}, inputMetadata);
     }
     auto locate = std::find_if(inputs.begin(), inputs.end(), [](InputSpec& input) { return input.binding == metadata::tableLabel(); });
     if (locate != inputs.end()) {
@@ -312,9 +322,9 @@ struct AnalysisDataProcessorBuilder {
   template <typename G, typename... A>
   struct GroupSlicer {
     using grouping_t = std::decay_t<G>;
-    GroupSlicer(G& gt, std::tuple<A...>& at)
+    GroupSlicer(G& gt, std::tuple<A...>& at, GroupIndexCache* cache = nullptr)
       : max{gt.size()},
-        mBegin{GroupSlicerIterator(gt, at)}
+        mBegin{GroupSlicerIterator(gt, at, cache)}
     {
     }
 
@@ -364,16 +374,31 @@ struct AnalysisDataProcessorBuilder {
             if (table.size() == 0) {
               return;
             }
-            // use presorted splitting approach
-            auto result = o2::framework::sliceByColumn(mIndexColumnName.c_str(),
-                                                       name.c_str(),
-                                                       table.asArrowTable(),
-                                                       static_cast<int32_t>(mGt->tableSize()),
-                                                       &groups[index],
-                                                       &offsets[index],
-                                                       &sizes[index]);
-            if (result.ok() == false) {
-              throw runtime_error("Cannot split collection");
+            auto arrowTable = table.asArrowTable();
+            auto key = GroupIndexCache::makeKey(name, mIndexColumnName, arrowTable->num_rows(), mGt->tableSize());
+            if (auto cached = mCache ? mCache->findSorted(key) : nullptr) {
+              // somebody already split this table, only the slices need to be created
+              offsets[index] = cached->offsets;
+              sizes[index] = cached->sizes;
+              groups[index].reserve(offsets[index].size());
+              for (size_t gi = 0; gi < offsets[index].size(); ++gi) {
+                groups[index].emplace_back(arrow::Datum{arrowTable->Slice(offsets[index][gi], sizes[index][gi])});
+              }
+            } else {
+              // use presorted splitting approach
+              auto result = o2::framework::sliceByColumn(mIndexColumnName.c_str(),
+                                                         name.c_str(),
+                                                         arrowTable,
+                                                         static_cast<int32_t>(mGt->tableSize()),
+                                                         &groups[index],
+                                                         &offsets[index],
+                                                         &sizes[index]);
+              if (result.ok() == false) {
+                throw runtime_error("Cannot split collection");
+              }
+              if (mCache) {
+                mCache->sorted.emplace(key, GroupIndexCache::SortedGroups{offsets[index], sizes[index]});
+              }
             }
             if (groups[index].size() > mGt->tableSize()) {
               throw runtime_error_f("Splitting collection %s resulted in a larger group number (%d) than there is rows in the grouping table (%d).", name.c_str(), groups[index].size(), mGt->tableSize());
@@ -382,12 +407,22 @@ struct AnalysisDataProcessorBuilder {
             if (table.tableSize() == 0) {
               return;
             }
-            // use generic splitting approach
-            o2::framework::sliceByColumnGeneric(mIndexColumnName.c_str(),
-                                                name.c_str(),
-                                                table.asArrowTable(),
-                                                static_cast<int32_t>(mGt->tableSize()),
-                                                &filterGroups[index]);
+            auto arrowTable = table.asArrowTable();
+            auto key = GroupIndexCache::makeKey(name, mIndexColumnName, arrowTable->num_rows(), mGt->tableSize());
+            filterGroups[index] = mCache ? mCache->findUnsorted(key) : nullptr;
+            if (filterGroups[index] == nullptr) {
+              // use generic splitting approach
+              auto unsortedGroups = std::make_shared<ListVector>();
+              o2::framework::sliceByColumnGeneric(mIndexColumnName.c_str(),
+                                                  name.c_str(),
+                                                  arrowTable,
+                                                  static_cast<int32_t>(mGt->tableSize()),
+                                                  unsortedGroups.get());
+              filterGroups[index] = unsortedGroups;
+              if (mCache) {
+                mCache->unsorted.emplace(key, unsortedGroups);
+              }
+            }
           }
         }
       }
@@ -403,10 +438,11 @@ struct AnalysisDataProcessorBuilder {
         }
       }
 
-      GroupSlicerIterator(G& gt, std::tuple<A...>& at)
+      GroupSlicerIterator(G& gt, std::tuple<A...>& at, GroupIndexCache* cache = nullptr)
         : mIndexColumnName{std::string("fIndex") + getLabelFromType<G>()},
           mGt{&gt},
           mAt{&at},
+          mCache{cache},
           mGroupingElement{gt.begin()},
           position{0}
       {
@@ -510,10 +546,11 @@ struct AnalysisDataProcessorBuilder {
               }
               // intersect selections
               o2::soa::SelectionVector s;
+              auto const& filterGroup = (*filterGroups[index])[pos];
               if (selections[index]->empty()) {
-                std::copy((filterGroups[index])[pos].begin(), (filterGroups[index])[pos].end(), std::back_inserter(s));
+                std::copy(filterGroup.begin(), filterGroup.end(), std::back_inserter(s));
               } else {
-                std::set_intersection((filterGroups[index])[pos].begin(), (filterGroups[index])[pos].end(), selections[index]->begin(), selections[index]->end(), std::back_inserter(s));
+                std::set_intersection(filterGroup.begin(), filterGroup.end(), selections[index]->begin(), selections[index]->end(), std::back_inserter(s));
               }
               std::decay_t<A1> typedTable{{originalTable.asArrowTable()}, std::move(s)};
               typedTable.bindInternalIndicesTo(&originalTable);
@@ -530,11 +567,12 @@ struct AnalysisDataProcessorBuilder {
       std::string mIndexColumnName;
       G const* mGt;
       std::tuple<A...>* mAt;
+      GroupIndexCache* mCache = nullptr;
       typename grouping_t::iterator mGroupingElement;
       uint64_t position = 0;
       soa::SelectionVector const* groupSelection = nullptr;
       std::array<std::vector<arrow::Datum>, sizeof...(A)> groups;
-      std::array<ListVector, sizeof...(A)> filterGroups;
+      std::array<std::shared_ptr<ListVector const>, sizeof...(A)> filterGroups;
       std::array<std::vector<uint64_t>, sizeof...(A)> offsets;
       std::array<std::vector<int>, sizeof...(A)> sizes;
       std::array<soa::SelectionVector const*, sizeof...(A)> selections;
@@ -561,7 +599,7 @@ struct AnalysisDataProcessorBuilder {
   }
 
   template <typename Task, typename R, typename C, typename Grouping, typename... Associated>
-  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo> const& infos)
+  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo> const& infos, GroupIndexCache* cache = nullptr)
   {
     using G = std::decay_t<Grouping>;
     auto groupingTable = AnalysisDataProcessorBuilder::bindGroupingTable(inputs, processingFunction, infos);
@@ -630,7 +668,7 @@ struct AnalysisDataProcessorBuilder {
 
       if constexpr (soa::is_soa_iterator_t<std::decay_t<G>>::value) {
         // grouping case
-        auto slicer = GroupSlicer(groupingTable, associatedTables);
+        auto slicer = GroupSlicer(groupingTable, associatedTables, cache);
         for (auto& slice : slicer) {
           auto associatedSlices = slice.associatedTables();
 
@@ -880,6 +918,7 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
   homogeneous_apply_refs([&outputs, &hash](auto& x) { return OutputManager<std::decay_t<decltype(x)>>::appendOutput(outputs, x, hash); }, *task.get());
 
   std::vector<ServiceSpec> requiredServices = CommonServices::defaultServices();
+  requiredServices.push_back(CommonAnalysisServices::groupIndexCacheSpec());
   homogeneous_apply_refs([&requiredServices](auto& x) { return ServiceManager<std::decay_t<decltype(x)>>::add(requiredServices, x); }, *task.get());
 
   auto algo = AlgorithmSpec::InitCallback{[task = task, expressionInfos](InitContext& ic) mutable {
@@ -916,14 +955,15 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
       if constexpr (has_run_v<T>) {
         task->run(pc);
       }
+      auto* groupIndexCache = &pc.services().get<GroupIndexCache>();
       if constexpr (has_process_v<T>) {
-        AnalysisDataProcessorBuilder::invokeProcess(*(task.get()), pc.inputs(), &T::process, expressionInfos);
+        AnalysisDataProcessorBuilder::invokeProcess(*(task.get()), pc.inputs(), &T::process, expressionInfos, groupIndexCache);
       }
       homogeneous_apply_refs(
-        [&pc, &expressionInfos, &task](auto& x) {
+        [&pc, &expressionInfos, &task, groupIndexCache](auto& x) {
           if constexpr (is_base_of_template<ProcessConfigurable, std::decay_t<decltype(x)>>::value) {
             if (x.value == true) {
-              AnalysisDataProcessorBuilder::invokeProcess(*task.get(), pc.inputs(), x.process, expressionInfos);
+              AnalysisDataProcessorBuilder::invokeProcess(*task.get(), pc.inputs(), x.process, expressionInfos, groupIndexCache);
               return true;
             }
           }
@@ -0,0 +1,59 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_ARROWFILEHELPERS_H_
+#define O2_FRAMEWORK_ARROWFILEHELPERS_H_
+
+#include <arrow/type_fwd.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace arrow::ipc
+{
+class RecordBatchWriter;
+}
+
+namespace o2::framework
+{
+
+/// Helpers to store AOD tables as Arrow IPC files rather than as trees.
+///
+/// The files follow the same structure as the ROOT ones: a directory
+/// <filename>.arrow plays the role of the ROOT file, with one subdirectory
+/// DF_<number> per dataframe, holding one <treename>.arrow file per table.
+/// When several timeframes are merged in the same dataframe, each of them is
+/// a record batch of the file.
+struct ArrowFileHelpers {
+  /// Extension of the directories and files written in this format
+  static constexpr const char* extension = ".arrow";
+
+  /// Create the file @a path, and the directories leading to it, for tables
+  /// with @a schema. The body buffers are compressed with @a compression
+  /// (none, lz4 or zstd), using multiple threads.
+  static std::shared_ptr<arrow::ipc::RecordBatchWriter> makeWriter(std::string const& path,
+                                                                    std::shared_ptr<arrow::Schema> const& schema,
+                                                                    std::string const& compression);
+  /// Append @a table to the file written by @a writer
+  static void write(arrow::ipc::RecordBatchWriter& writer, arrow::Table const& table);
+
+  /// @return the table stored in the file @a path. The file is memory
+  /// mapped, so that the uncompressed columns are not copied. Only the
+  /// @a columns are read, unless empty.
+  static std::shared_ptr<arrow::Table> read(std::string const& path, std::vector<std::string> const& columns = {});
+
+  /// @return true if @a path is the top directory of a set of tables
+  /// written in this format
+  static bool isArrowDirectory(std::string const& path);
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_ARROWFILEHELPERS_H_
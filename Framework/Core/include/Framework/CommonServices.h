@@ -73,6 +73,8 @@ struct CommonServices {
 
 struct CommonAnalysisServices {
   static ServiceSpec databasePDGSpec();
+  /// Cache of the grouping of the associated tables, shared by the tasks of a device
+  static ServiceSpec groupIndexCacheSpec();
 
   template <typename T>
   static void addAnalysisService(std::vector<ServiceSpec>& specs)
@@ -65,6 +65,10 @@ struct CompletionPolicy {
   Matcher matcher = nullptr;
   /// Actual policy which decides what to do with a partial InputRecord.
   Callback callback = nullptr;
+  /// If true, the callback returns Wait whenever some input of the record
+  /// is missing, so that the DataRelayer can avoid invoking it until the
+  /// record is complete.
+  bool waitsForAllInputs = false;
 
   /// Helper to create the default configuration.
   static std::vector<CompletionPolicy> createDefaultPolicies();
@@ -16,7 +16,9 @@
 
 #include "Framework/DataDescriptorMatcher.h"
 
+#include <arrow/type_fwd.h>
 #include <regex>
+#include <unordered_map>
 #include "rapidjson/fwd.h"
 
 namespace o2::framework
@@ -32,6 +34,8 @@ FileNameHolder* makeFileNameHolder(std::string fileName);
 
 struct FileAndFolder {
   TFile* file = nullptr;
+  /// set instead of file for the inputs in the arrow format, see ArrowFileHelpers
+  std::string directory = "";
   std::string folderName = "";
 };
 
@@ -83,6 +87,7 @@ struct DataInputDescriptor {
   std::vector<FileNameHolder*> mfilenames;
   std::vector<FileNameHolder*>* mdefaultFilenamesPtr = nullptr;
   TFile* mcurrentFile = nullptr;
+  std::string mcurrentDirectory = "";
   bool mAlienSupport = false;
 
   int mtotalNumberTimeFrames = 0;
@@ -107,6 +112,10 @@ struct DataInputDirector {
   void setFilenamesRegex(std::string dfn) { mFilenameRegex = dfn; }
   bool readJson(std::string const& fnjson);
   void closeInputFiles();
+  /// Restrict the branches which are read for each table. @a columns is
+  /// of the form "ORIGIN/DESCRIPTION:column1,column2;..." and tables which
+  /// are not listed are read in full.
+  void setColumnsToRead(std::string const& columns);
 
   // getters
   DataInputDescriptor* getDataInputDescriptor(header::DataHeader dh);
@@ -114,9 +123,13 @@ struct DataInputDirector {
 
   std::unique_ptr<TTreeReader> getTreeReader(header::DataHeader dh, int counter, int numTF, std::string treeName);
   TTree* getDataTree(header::DataHeader dh, int counter, int numTF);
+  /// @return the table @a dh if the input is in the arrow format, nullptr otherwise
+  std::shared_ptr<arrow::Table> getDataTable(header::DataHeader dh, int counter, int numTF);
   uint64_t getTimeFrameNumber(header::DataHeader dh, int counter, int numTF);
   FileAndFolder getFileFolder(header::DataHeader dh, int counter, int numTF);
   int getTimeFramesInFile(header::DataHeader dh, int counter);
+  /// @return the columns to read for the table @a dh, empty if all
+  std::vector<std::string> getColumnsToRead(header::DataHeader dh) const;
 
  private:
   std::string minputfilesFile;
@@ -126,6 +139,7 @@ struct DataInputDirector {
   DataInputDescriptor* mdefaultDataInputDescriptor = nullptr;
   std::vector<FileNameHolder*> mdefaultInputFiles;
   std::vector<DataInputDescriptor*> mdataInputDescriptors;
+  std::unordered_map<std::string, std::vector<std::string>> mColumnsToRead;
 
   bool mDebugMode = false;
   bool mAlienSupport = false;
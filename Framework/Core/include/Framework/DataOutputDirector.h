@@ -16,9 +16,13 @@
 #include "Framework/DataSpecUtils.h"
 #include "Framework/InputSpec.h"
 #include "Framework/DataInputDirector.h"
+#include "Framework/ArrowFileHelpers.h"
 
 #include "rapidjson/fwd.h"
 
+#include <map>
+#include <set>
+
 class TFile;
 
 namespace o2::framework
@@ -75,6 +79,12 @@ struct DataOutputDirector {
   void setNumberTimeFramesToMerge(int ntfmerge) { mnumberTimeFramesToMerge = ntfmerge > 0 ? ntfmerge : 1; }
   std::string getFileMode() { return mfileMode; }
   void setFileMode(std::string filemode) { mfileMode = filemode; }
+  /// The format of the output files: root (trees) or arrow (Arrow IPC files)
+  std::string getFormat() { return mformat; }
+  void setFormat(std::string format);
+  /// The compression of the Arrow IPC files: none, lz4 or zstd
+  std::string getCompression() { return mcompression; }
+  void setCompression(std::string compression) { mcompression = compression; }
 
   // get matching DataOutputDescriptors
   std::vector<DataOutputDescriptor*> getDataOutputDescriptors(header::DataHeader dh);
@@ -83,6 +93,9 @@ struct DataOutputDirector {
   // get the matching TFile
   FileAndFolder getFileFolder(DataOutputDescriptor* dodesc, uint64_t folderNumber);
 
+  // write a table in the arrow format, see ArrowFileHelpers
+  void writeArrowTable(DataOutputDescriptor* dodesc, uint64_t folderNumber, std::shared_ptr<arrow::Table> const& table);
+
   void closeDataFiles();
 
   void setFilenameBase(std::string dfn);
@@ -99,6 +112,10 @@ struct DataOutputDirector {
   bool mdebugmode = false;
   int mnumberTimeFramesToMerge = 1;
   std::string mfileMode = "RECREATE";
+  std::string mformat = "root";
+  std::string mcompression = "zstd";
+  std::map<std::string, std::shared_ptr<arrow::ipc::RecordBatchWriter>> mArrowWriters;
+  std::set<std::string> mArrowDirectories;
 
   std::tuple<std::string, std::string, int> readJsonDocument(Document* doc);
   const std::tuple<std::string, std::string, int> memptyanswer = std::make_tuple(std::string(""), std::string(""), -1);
@@ -40,6 +40,7 @@ namespace o2::framework
 struct InputChannelInfo;
 struct DeviceState;
 struct ComputingQuotaEvaluator;
+class ProcessingLanes;
 
 /// Context associated to a given DataProcessor.
 /// For the time being everything points to
@@ -83,6 +84,9 @@ struct DataProcessorContext {
   std::vector<ExpirationHandler>* expirationHandlers = nullptr;
   TimingInfo* timingInfo = nullptr;
   DataAllocator* allocator = nullptr;
+  /// The lanes used to process multiple timeslices concurrently,
+  /// nullptr if the DataProcessor is processed serially.
+  ProcessingLanes* lanes = nullptr;
   AlgorithmSpec::ProcessCallback* statefulProcess = nullptr;
   AlgorithmSpec::ProcessCallback* statelessProcess = nullptr;
   AlgorithmSpec::ErrorCallback* error = nullptr;
@@ -118,6 +122,7 @@ class DataProcessingDevice : public FairMQDevice
 {
  public:
   DataProcessingDevice(RunningDeviceRef ref, ServiceRegistry&, ProcessingPolicies& policies);
+  ~DataProcessingDevice() override;
   void Init() final;
   void InitTask() final;
   void PreRun() final;
@@ -153,6 +158,7 @@ class DataProcessingDevice : public FairMQDevice
   ServiceRegistry& mServiceRegistry;
   TimingInfo mTimingInfo;
   DataAllocator mAllocator;
+  std::unique_ptr<ProcessingLanes> mLanes;
   DataRelayer* mRelayer = nullptr;
   /// Expiration handler
   std::vector<ExpirationHandler> mExpirationHandlers;
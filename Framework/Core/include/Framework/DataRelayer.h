@@ -14,6 +14,7 @@
 #include "Framework/RootSerializationSupport.h"
 #include "Framework/InputRoute.h"
 #include "Framework/DataDescriptorMatcher.h"
+#include "Framework/InputMatcherIndex.h"
 #include "Framework/ForwardRoute.h"
 #include "Framework/CompletionPolicy.h"
 #include "Framework/MessageSet.h"
@@ -73,6 +74,14 @@ class DataRelayer
     CompletionPolicy::CompletionOp op;
   };
 
+  /// A set of split parts within a multipart message, to be relayed
+  /// together with the other sets of the same message.
+  struct PartsGroup {
+    size_t firstPart;       /// index of the first header of the set
+    size_t restOfPartsSize; /// how many messages follow the first header
+    RelayChoice choice = Invalid;
+  };
+
   DataRelayer(CompletionPolicy const&,
               std::vector<InputRoute> const& routes,
               monitoring::Monitoring&,
@@ -103,6 +112,14 @@ class DataRelayer
   RelayChoice relay(std::unique_ptr<FairMQMessage>& header,
                     std::unique_ptr<FairMQMessage>& payload);
 
+  /// This is to relay all the sets of split parts of a multipart message
+  /// in one go. @a parts is the array of messages, @a groups describes the
+  /// sets to relay and gets filled with the outcome for each of them.
+  /// Consecutive sets with the same identity (origin, description,
+  /// subspecification and timeslice) go to the place of the previous one
+  /// without being matched again, and the stats are updated once per batch.
+  void relay(std::unique_ptr<FairMQMessage>* parts, std::vector<PartsGroup>& groups);
+
   /// @returns the actions ready to be performed.
   void getReadyToProcess(std::vector<RecordAction>& completed);
 
@@ -157,10 +174,29 @@ class DataRelayer
   CompletionPolicy mCompletionPolicy;
   std::vector<size_t> mDistinctRoutesIndex;
   std::vector<data_matcher::DataDescriptorMatcher> mInputMatchers;
+  InputMatcherIndex mInputMatcherIndex;
   std::vector<data_matcher::VariableContext> mVariableContextes;
   std::vector<CacheEntryStatus> mCachedStateMetrics;
   size_t mMaxLanes;
 
+  /// How many inputs of each slot hold data. This is updated on every
+  /// change of the cache, so that we know if a slot is complete without
+  /// looking at all its inputs.
+  std::vector<size_t> mFilledInputs;
+  /// Scratch space for the slots which need to be checked for completion.
+  std::vector<TimesliceSlot> mDirtySlots;
+  /// The slot where the last message was relayed. Messages of the same
+  /// timeslice usually come together, so we try it before any other.
+  TimesliceSlot mLastRelayedSlot{TimesliceSlot::INVALID};
+  /// The input the last message was relayed to.
+  int mLastRelayedInput = -1;
+
+  /// Actually store the given messages in the cache.
+  void saveInSlot(std::unique_ptr<FairMQMessage>& firstPart,
+                  std::unique_ptr<FairMQMessage>* restOfParts,
+                  size_t restOfPartsSize,
+                  int input, TimesliceSlot slot);
+
   static std::vector<std::string> sMetricsNames;
   static std::vector<std::string> sVariablesMetricsNames;
   static std::vector<std::string> sQueriesMetricsNames;
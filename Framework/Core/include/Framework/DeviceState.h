@@ -14,6 +14,7 @@
 #include "Framework/ChannelInfo.h"
 #include "Framework/ComputingQuotaOffer.h"
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <map>
@@ -61,7 +62,8 @@ struct DeviceState {
 
   std::vector<InputChannelInfo> inputChannelInfos;
   StreamingState streaming = StreamingState::Streaming;
-  bool quitRequested = false;
+  /// Can be set by the ControlService from the processing lanes
+  std::atomic<bool> quitRequested = false;
 
   /// ComputingQuotaOffers which have not yet been
   /// evaluated by the ComputingQuotaEvaluator
@@ -19,6 +19,8 @@ namespace o2
 {
 namespace framework
 {
+class MessagePool;
+
 /// Helper class to hide FairMQDevice headers in the DataAllocator header.
 /// This is done because FairMQDevice brings in a bunch of boost.mpl /
 /// boost.fusion stuff, slowing down compilation times enourmously.
@@ -43,8 +45,19 @@ class FairMQDeviceProxy
   std::unique_ptr<FairMQMessage> createMessage() const;
   std::unique_ptr<FairMQMessage> createMessage(const size_t size) const;
 
+  /// Optional pool to recycle the payload messages across timeslices.
+  void setMessagePool(MessagePool* pool)
+  {
+    mMessagePool = pool;
+  }
+  MessagePool* getMessagePool() const
+  {
+    return mMessagePool;
+  }
+
  private:
   FairMQDevice* mDevice;
+  MessagePool* mMessagePool = nullptr;
 };
 
 } // namespace framework
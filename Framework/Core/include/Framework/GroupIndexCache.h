@@ -0,0 +1,81 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_GROUPINDEXCACHE_H_
+#define O2_FRAMEWORK_GROUPINDEXCACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// Per timeframe cache of the way the associated tables are grouped by their
+/// index to the grouping table, shared by all the process functions of the
+/// tasks in a device. The grouping of a given (table, index column) only
+/// needs to be computed by the first GroupSlicer which asks for it, the
+/// others only need to slice the table. Cleared before every timeframe.
+struct GroupIndexCache {
+  /// Groups of a table which is sorted by the index
+  struct SortedGroups {
+    std::vector<uint64_t> offsets;
+    std::vector<int> sizes;
+  };
+  /// Rows of each group of a table which is not sorted by the index
+  using UnsortedGroups = std::vector<std::vector<int64_t>>;
+
+  /// @return the key for the grouping of the table labelled @a target by
+  /// @a indexColumn. The sizes of the tables are part of the key so that
+  /// whatever does not match the current timeframe is never used.
+  static std::string makeKey(std::string const& target, std::string const& indexColumn, int64_t rows, int64_t groupingSize)
+  {
+    return target + "/" + indexColumn + "/" + std::to_string(rows) + "/" + std::to_string(groupingSize);
+  }
+
+  SortedGroups const* findSorted(std::string const& key)
+  {
+    auto it = sorted.find(key);
+    if (it == sorted.end()) {
+      misses++;
+      return nullptr;
+    }
+    hits++;
+    return &it->second;
+  }
+
+  std::shared_ptr<UnsortedGroups const> findUnsorted(std::string const& key)
+  {
+    auto it = unsorted.find(key);
+    if (it == unsorted.end()) {
+      misses++;
+      return nullptr;
+    }
+    hits++;
+    return it->second;
+  }
+
+  void clear()
+  {
+    sorted.clear();
+    unsorted.clear();
+  }
+
+  std::unordered_map<std::string, SortedGroups> sorted;
+  std::unordered_map<std::string, std::shared_ptr<UnsortedGroups const>> unsorted;
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_GROUPINDEXCACHE_H_
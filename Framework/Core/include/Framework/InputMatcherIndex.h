@@ -0,0 +1,71 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_INPUTMATCHERINDEX_H_
+#define O2_FRAMEWORK_INPUTMATCHERINDEX_H_
+
+#include "Headers/DataHeader.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// Precomputed dispatch table for the input matchers of a device.
+///
+/// Inputs which are fully specified (i.e. ConcreteDataMatcher) are indexed
+/// by their (origin, description, subSpecification), all the others
+/// (wildcards, variables, ranges) end up in the fallback list. For each key
+/// we store the merged list of candidates, in the original route order, so
+/// that a single lookup gives the only matchers which can possibly match a
+/// given header, without changing which one matches first.
+struct InputMatcherIndex {
+  struct Key {
+    header::DataOrigin origin;
+    header::DataDescription description;
+    header::DataHeader::SubSpecificationType subSpec;
+
+    bool operator==(Key const& other) const
+    {
+      return origin == other.origin && description == other.description && subSpec == other.subSpec;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(Key const& key) const
+    {
+      uint64_t h = key.origin.itg[0];
+      h = h * 0x9e3779b97f4a7c15ULL ^ key.description.itg[0];
+      h = h * 0x9e3779b97f4a7c15ULL ^ key.description.itg[1];
+      h = h * 0x9e3779b97f4a7c15ULL ^ key.subSpec;
+      return h ^ (h >> 32);
+    }
+  };
+
+  /// @return the positions in the distinct route index which need to be
+  /// checked for a message with the given DataHeader. When @a dh is nullptr
+  /// only the fallback ones are returned.
+  std::vector<size_t> const& candidates(header::DataHeader const* dh) const
+  {
+    if (dh == nullptr || byKey.empty()) {
+      return fallback;
+    }
+    auto it = byKey.find(Key{dh->dataOrigin, dh->dataDescription, dh->subSpecification});
+    return it != byKey.end() ? it->second : fallback;
+  }
+
+  std::unordered_map<Key, std::vector<size_t>, KeyHash> byKey;
+  std::vector<size_t> fallback;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_INPUTMATCHERINDEX_H_
@@ -36,6 +36,7 @@ namespace o2::framework
 {
 
 class Output;
+class MessagePool;
 
 class MessageContext
 {
@@ -53,6 +54,8 @@ class MessageContext
   {
   }
 
+  ~MessageContext();
+
   void init(DispatchControl&& dispatcher)
   {
     mDispatchControl = dispatcher;
@@ -532,6 +535,11 @@ class MessageContext
     return mProxy;
   }
 
+  /// Take ownership of the pool used to recycle the output messages and
+  /// hand it to the proxy. A null pool releases the current one, together
+  /// with its region, so this must happen while the transport is alive.
+  void setMessagePool(std::unique_ptr<MessagePool> pool);
+
   /// call the proxy to create a message of the specified size
   /// we don't implement in the header to avoid including the FairMQDevice header here
   /// that's why the different versions need to be implemented as individual functions
@@ -545,6 +553,7 @@ class MessageContext
 
  private:
   FairMQDeviceProxy mProxy;
+  std::unique_ptr<MessagePool> mMessagePool;
   Messages mMessages;
   Messages mScheduledMessages;
   DispatchControl mDispatchControl;
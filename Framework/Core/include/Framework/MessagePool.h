@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_MESSAGEPOOL_H_
+#define O2_FRAMEWORK_MESSAGEPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <fairmq/FwdDecls.h>
+
+namespace o2::framework
+{
+
+/// Per device pool of output messages, carved out of a single unmanaged
+/// shared memory region, so that the payloads which are created for every
+/// timeslice do not need to go through the shared memory allocator over and
+/// over again.
+///
+/// Requested sizes are rounded up to a size class (four classes per power of
+/// two, starting from 256 bytes). A size class is only served by the pool once
+/// it was requested in a previous timeslice, so that one-off sizes do not
+/// waste the region. Blocks are carved lazily and go back to the free list of
+/// their class once the receiver of the message releases it, so that they
+/// can be reused by the following timeslices. Whatever the pool cannot serve
+/// is a miss and must be allocated the usual way.
+class MessagePool
+{
+ public:
+  static constexpr size_t MinBlockSize = 256;
+
+  struct Block {
+    void* data = nullptr;
+    int sizeClass = -1;
+  };
+
+  /// Counters for the current timeslice, reset by endOfTimeslice().
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    /// Bytes requested by the hits
+    size_t requestedBytes = 0;
+    /// Bytes of the blocks given out for the hits
+    size_t blockBytes = 0;
+  };
+
+  /// Manage the memory in [@a base, @a base + @a size) which must outlive
+  /// the pool.
+  MessagePool(void* base, size_t size);
+  ~MessagePool();
+
+  /// Create a pool backed by a new unmanaged region of @a size bytes of the
+  /// given transport. The region callback gives back the blocks to the pool.
+  static std::unique_ptr<MessagePool> create(FairMQTransportFactory* transport, size_t size);
+
+  /// @return a message of @a size bytes from the pool or nullptr in case of a
+  /// miss. Only available for pools created with create().
+  std::unique_ptr<FairMQMessage> createMessage(size_t size);
+  /// @return true if the messages of the pool can be sent with @a transport
+  bool isCompatible(FairMQTransportFactory* transport) const { return transport == mTransport; }
+
+  /// @return a block able to hold @a size bytes, or an empty block on a miss.
+  Block allocate(size_t size);
+  /// Give back a block obtained with allocate(). Thread safe, since it is
+  /// invoked by the transport once the message has been consumed.
+  void release(Block block);
+
+  /// Learn the size classes requested in the timeslice which just finished,
+  /// and reset the per timeslice statistics.
+  void endOfTimeslice();
+
+  /// @return a copy of the statistics, which are updated by the other threads
+  Stats getStats() const;
+  /// @return the fraction of requests which were served by the pool
+  float getHitRate() const;
+  /// @return the fraction of the bytes given out which were not requested,
+  /// i.e. the internal fragmentation due to the size classes
+  float getFragmentation() const;
+  /// @return the bytes carved out of the region so far
+  size_t getCarvedBytes() const;
+  /// @return the bytes of carved blocks which are currently not in use
+  size_t getIdleBytes() const;
+  size_t getSize() const { return mSize; }
+
+  static int sizeClassFor(size_t size);
+  static size_t sizeOfClass(int sizeClass);
+
+ private:
+  struct SizeClass {
+    std::vector<void*> free;
+    bool learned = false;
+    bool requested = false;
+  };
+
+  char* mBase;
+  size_t mSize;
+  size_t mCarved = 0;
+  std::vector<SizeClass> mClasses;
+  Stats mStats;
+  mutable std::mutex mMutex;
+  FairMQTransportFactory* mTransport = nullptr;
+  std::unique_ptr<FairMQUnmanagedRegion> mRegion;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_MESSAGEPOOL_H_
@@ -109,7 +109,7 @@ struct ServiceRegistry {
 
   ServiceRegistry(ServiceRegistry const& other)
   {
-    for (size_t i = 0; i < MAX_SERVICES; ++i) {
+    for (size_t i = 0; i < mServicesKey.size(); ++i) {
       mServicesKey[i].store(other.mServicesKey[i].load());
     }
     mServicesValue = other.mServicesValue;
@@ -121,7 +121,7 @@ struct ServiceRegistry {
 
   ServiceRegistry& operator=(ServiceRegistry const& other)
   {
-    for (size_t i = 0; i < MAX_SERVICES; ++i) {
+    for (size_t i = 0; i < mServicesKey.size(); ++i) {
       mServicesKey[i].store(other.mServicesKey[i].load());
     }
     mServicesValue = other.mServicesValue;
@@ -169,6 +169,11 @@ struct ServiceRegistry {
   /// This method is supposed to be thread safe
   void registerService(hash_type typeHash, void* service, ServiceKind kind, uint64_t threadId, char const* name = nullptr) const;
 
+  /// Make all the entries registered for @a typeHash point to @a service.
+  /// Used to give a copy of the registry its own instance of a given
+  /// service. This method is not thread safe.
+  void overrideService(hash_type typeHash, void* service);
+
   // Lookup a given @a typeHash for a given @a threadId at
   // a unique (per typeHash) location. There might
   // be other typeHash which sit in the same place, but
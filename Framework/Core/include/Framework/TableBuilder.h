@@ -223,6 +223,24 @@ struct BuilderUtils {
     }
   }
 
+  /// Append @a size values of a column at once, or @a size arrays of values
+  /// for the array columns. Whatever was cached by the single row appends
+  /// goes first, so that the two can be mixed.
+  template <typename HolderType, typename T>
+  static arrow::Status bulkAppendColumn(HolderType& holder, T const* data, size_t size)
+  {
+    auto status = flush(holder);
+    if constexpr (std::is_same_v<decltype(holder.builder), std::unique_ptr<arrow::FixedSizeListBuilder>>) {
+      return status & appendToList<T const>(holder.builder, data, size);
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return status & holder.builder->AppendValues(reinterpret_cast<const uint8_t*>(data), size, nullptr);
+    } else {
+      using ValueType = typename std::decay_t<decltype(*holder.builder)>::value_type;
+      static_assert(sizeof(ValueType) == sizeof(T), "Column type mismatch");
+      return status & holder.builder->AppendValues(reinterpret_cast<ValueType const*>(data), size, nullptr);
+    }
+  }
+
   template <typename HolderType, typename ITERATOR>
   static arrow::Status append(HolderType& holder, std::pair<ITERATOR, ITERATOR> ip)
   {
@@ -456,7 +474,9 @@ struct CachedInsertion {
   arrow::Status flush(BUILDER& builder)
   {
     if (pos % CHUNK_SIZE != 0) {
-      return builder->AppendValues(cache, pos % CHUNK_SIZE, nullptr);
+      auto status = builder->AppendValues(cache, pos % CHUNK_SIZE, nullptr);
+      pos = 0;
+      return status;
     }
     return arrow::Status::OK();
   }
@@ -512,6 +532,12 @@ struct TableBuilderHelpers {
     return (BuilderUtils::bulkAppend(std::get<Is>(holders), bulkSize, std::get<Is>(ptrs)).ok() && ...);
   }
 
+  template <std::size_t... Is, typename HOLDERS, typename PTRS>
+  static bool bulkAppendColumns(HOLDERS& holders, size_t bulkSize, std::index_sequence<Is...>, PTRS ptrs)
+  {
+    return (BuilderUtils::bulkAppendColumn(std::get<Is>(holders), std::get<Is>(ptrs), bulkSize).ok() && ...);
+  }
+
   /// Return true if all columns are done.
   template <std::size_t... Is, typename BUILDERS, typename INFOS>
   static bool bulkAppendChunked(BUILDERS& builders, std::index_sequence<Is...>, INFOS infos)
@@ -560,6 +586,17 @@ struct HolderTrait {
   using Holder = BuilderHolder<T, DirectInsertion>;
 };
 
+/// Type of the values expected by the bulk appends for a column of type T
+template <typename T>
+struct BulkValueTrait {
+  using type = T;
+};
+
+template <typename T, int N>
+struct BulkValueTrait<T[N]> {
+  using type = T;
+};
+
 template <>
 struct HolderTrait<int8_t> {
   using Holder = BuilderHolder<int8_t, CachedInsertion>;
@@ -806,6 +843,18 @@ class TableBuilder
     visitBuilders(pack, [s](auto& holder) { return holder.builder->Reserve(s).ok(); });
   }
 
+  /// Append @a nRows rows at once to the columns ARGS of a table being
+  /// filled with a cursor, which can still be used afterwards. For each
+  /// column @a data points to @a nRows contiguous values (nRows * N values
+  /// for a column of type T[N]), which are copied with a single AppendValues.
+  template <typename... ARGS>
+  void bulkAppend(o2::framework::pack<ARGS...> pack, size_t nRows, typename BulkValueTrait<ARGS>::type const*... data)
+  {
+    if (TableBuilderHelpers::bulkAppendColumns(*getBuilders(pack), nRows, std::index_sequence_for<ARGS...>{}, std::forward_as_tuple(data...)) == false) {
+      throwError(runtime_error("Unable to bulk append"));
+    }
+  }
+
   /// Invoke the appropriate visitor on the various builders
   template <typename... ARGS, typename V>
   auto visitBuilders(o2::framework::pack<ARGS...> pack, V&& visitor)
@@ -16,6 +16,7 @@
 #include "Framework/CompilerBuiltins.h"
 #include "Framework/ServiceHandle.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <tuple>
 #include <vector>
@@ -74,6 +75,10 @@ class TimesliceIndex
   inline bool isDirty(TimesliceSlot const& slot) const;
   inline void markAsDirty(TimesliceSlot slot, bool value);
   inline void markAsInvalid(TimesliceSlot slot);
+  /// Move to @a slots the slots which were marked as dirty since the last
+  /// invocation, so that they can be checked without scanning the whole index.
+  /// Notice that a slot can be reported even if it is not dirty anymore.
+  inline void extractDirtySlots(std::vector<TimesliceSlot>& slots);
   /// Publish a slot to be sent via metrics.
   inline void publishSlot(TimesliceSlot slot);
   /// Associated the @a timestamp to the given @a slot. Notice that
@@ -113,6 +118,9 @@ class TimesliceIndex
   /// since last time we called getReadyToProcess()
   std::vector<bool> mDirty;
 
+  /// The slots which went from clean to dirty since last extractDirtySlots()
+  std::vector<TimesliceSlot> mDirtySlots;
+
   /// What to do in case of backpressure
   BackpressureOp mBackpressurePolicy = BackpressureOp::Wait;
   /// The maximum number of lanes for this timeslice index
@@ -0,0 +1,114 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ArrowFileHelpers.h"
+#include "Framework/RuntimeError.h"
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
+#include <arrow/util/compression.h>
+
+#include <algorithm>
+#include <filesystem>
+
+namespace o2::framework
+{
+
+std::shared_ptr<arrow::ipc::RecordBatchWriter> ArrowFileHelpers::makeWriter(std::string const& path,
+                                                                           std::shared_ptr<arrow::Schema> const& schema,
+                                                                           std::string const& compression)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+  if (ec) {
+    throw runtime_error_f("Cannot create the directory for %s: %s", path.c_str(), ec.message().c_str());
+  }
+  auto sink = arrow::io::FileOutputStream::Open(path);
+  if (!sink.ok()) {
+    throw runtime_error_f("Cannot create %s: %s", path.c_str(), sink.status().ToString().c_str());
+  }
+
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  // The buffers of the different columns are compressed in parallel
+  options.use_threads = true;
+  if (compression == "lz4" || compression == "zstd") {
+    auto codec = arrow::util::Codec::Create(compression == "lz4" ? arrow::Compression::LZ4_FRAME : arrow::Compression::ZSTD);
+    if (!codec.ok()) {
+      throw runtime_error_f("Compression %s is not available: %s", compression.c_str(), codec.status().ToString().c_str());
+    }
+    options.codec = std::move(codec).ValueOrDie();
+  } else if (compression.empty() == false && compression != "none") {
+    throw runtime_error_f("Unknown compression %s, use none, lz4 or zstd", compression.c_str());
+  }
+
+  auto writer = arrow::ipc::MakeFileWriter(*sink, schema, options);
+  if (!writer.ok()) {
+    throw runtime_error_f("Cannot write to %s: %s", path.c_str(), writer.status().ToString().c_str());
+  }
+  return *writer;
+}
+
+void ArrowFileHelpers::write(arrow::ipc::RecordBatchWriter& writer, arrow::Table const& table)
+{
+  auto status = writer.WriteTable(table);
+  if (!status.ok()) {
+    throw runtime_error_f("Cannot write table: %s", status.ToString().c_str());
+  }
+}
+
+std::shared_ptr<arrow::Table> ArrowFileHelpers::read(std::string const& path, std::vector<std::string> const& columns)
+{
+  auto file = arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ);
+  if (!file.ok()) {
+    throw runtime_error_f("Cannot open %s: %s", path.c_str(), file.status().ToString().c_str());
+  }
+  auto options = arrow::ipc::IpcReadOptions::Defaults();
+  auto reader = arrow::ipc::RecordBatchFileReader::Open(*file, options);
+  if (reader.ok() && columns.empty() == false) {
+    // Columns which are not needed are not even decompressed
+    auto schema = (*reader)->schema();
+    for (auto& column : columns) {
+      auto index = schema->GetFieldIndex(column);
+      if (index != -1) {
+        options.included_fields.push_back(index);
+      }
+    }
+    std::sort(options.included_fields.begin(), options.included_fields.end());
+    reader = arrow::ipc::RecordBatchFileReader::Open(*file, options);
+  }
+  if (!reader.ok()) {
+    throw runtime_error_f("Cannot read %s: %s", path.c_str(), reader.status().ToString().c_str());
+  }
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0; i < (*reader)->num_record_batches(); ++i) {
+    auto batch = (*reader)->ReadRecordBatch(i);
+    if (!batch.ok()) {
+      throw runtime_error_f("Cannot read batch %d of %s: %s", i, path.c_str(), batch.status().ToString().c_str());
+    }
+    batches.push_back(*batch);
+  }
+  auto table = arrow::Table::FromRecordBatches((*reader)->schema(), batches);
+  if (!table.ok()) {
+    throw runtime_error_f("Cannot create table from %s: %s", path.c_str(), table.status().ToString().c_str());
+  }
+  return *table;
+}
+
+bool ArrowFileHelpers::isArrowDirectory(std::string const& path)
+{
+  std::error_code ec;
+  return std::filesystem::path(path).extension() == extension && std::filesystem::is_directory(path, ec);
+}
+
+} // namespace o2::framework
@@ -362,6 +362,22 @@ DataProcessorSpec
         // a table can be saved in multiple ways
         // e.g. different selections of columns to different files
         for (auto d : ds) {
+          if (dod->getFormat() == "arrow") {
+            // the arrow table is written as is, no conversion needed
+            auto toWrite = table;
+            if (!d->colnames.empty()) {
+              std::vector<int> indices;
+              for (auto& cn : d->colnames) {
+                auto idx = table->schema()->GetFieldIndex(cn);
+                if (idx != -1) {
+                  indices.push_back(idx);
+                }
+              }
+              toWrite = table->SelectColumns(indices).ValueOrDie();
+            }
+            dod->writeArrowTable(d, tfNumber, toWrite);
+            continue;
+          }
           auto fileAndFolder = dod->getFileFolder(d, tfNumber);
           auto treename = fileAndFolder.folderName + d->treename;
           TableToTree ta2tr(table,
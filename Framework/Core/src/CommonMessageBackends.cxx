@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 #include "Framework/CommonMessageBackends.h"
 #include "Framework/MessageContext.h"
+#include "Framework/MessagePool.h"
 #include "Framework/ArrowContext.h"
 #include "Framework/StringContext.h"
 #include "Framework/RawBufferContext.h"
@@ -21,18 +22,26 @@
 #include "Framework/Tracing.h"
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceInfo.h"
+#include "Framework/ProcessingContext.h"
+#include "Framework/Logger.h"
 
 #include "CommonMessageBackendsHelpers.h"
 
 #include <Monitoring/Monitoring.h>
 #include <Headers/DataHeader.h>
 
+#include <FairMQDevice.h>
 #include <options/FairMQProgOptions.h>
 
 #include <uv.h>
 #include <boost/program_options/variables_map.hpp>
 #include <csignal>
 
+using o2::monitoring::Monitoring;
+using Metric = o2::monitoring::Metric;
+using Key = o2::monitoring::tags::Key;
+using Value = o2::monitoring::tags::Value;
+
 // This is to allow C++20 aggregate initialisation
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
@@ -70,9 +79,35 @@ o2::framework::ServiceSpec CommonMessageBackends::fairMQBackendSpec()
     },
     .configure = CommonServices::noConfiguration(),
     .preProcessing = CommonMessageBackendsHelpers<MessageContext>::clearContext(),
-    .postProcessing = CommonMessageBackendsHelpers<MessageContext>::sendCallback(),
+    .postProcessing = [](ProcessingContext& ctx, void* service) {
+      CommonMessageBackendsHelpers<MessageContext>::sendCallback()(ctx, service);
+      auto pool = reinterpret_cast<MessageContext*>(service)->proxy().getMessagePool();
+      if (pool == nullptr) {
+        return;
+      }
+      auto& monitoring = ctx.services().get<Monitoring>();
+      monitoring.send(Metric{pool->getHitRate(), "message_pool_hit_rate"}.addTag(Key::Subsystem, Value::DPL));
+      monitoring.send(Metric{pool->getFragmentation(), "message_pool_fragmentation"}.addTag(Key::Subsystem, Value::DPL));
+      monitoring.send(Metric{(uint64_t)pool->getIdleBytes(), "message_pool_idle_bytes"}.addTag(Key::Subsystem, Value::DPL));
+      monitoring.send(Metric{(uint64_t)pool->getCarvedBytes(), "message_pool_carved_bytes"}.addTag(Key::Subsystem, Value::DPL));
+      pool->endOfTimeslice();
+    },
     .preEOS = CommonMessageBackendsHelpers<MessageContext>::clearContextEOS(),
     .postEOS = CommonMessageBackendsHelpers<MessageContext>::sendCallbackEOS(),
+    .start = [](ServiceRegistry& services, void* service) {
+      auto context = reinterpret_cast<MessageContext*>(service);
+      auto device = services.get<RawDeviceService>().device();
+      // The pool is opt-in, since it reserves its region upfront.
+      auto poolSize = std::stoull(device->fConfig->GetProperty<std::string>("message-pool-size", "0"));
+      if (poolSize > 0 && context->proxy().getMessagePool() == nullptr) {
+        LOGP(info, "Recycling output messages through a pool of {} bytes", poolSize);
+        context->setMessagePool(MessagePool::create(device->Transport(), poolSize));
+      }
+    },
+    .exit = [](ServiceRegistry&, void* service) {
+      // Drop the region while the device transport is still there.
+      reinterpret_cast<MessageContext*>(service)->setMessagePool(nullptr);
+    },
     .kind = ServiceKind::Serial};
 }
 
@@ -24,6 +24,7 @@
 #include "Framework/DataProcessingStats.h"
 #include "Framework/CommonMessageBackends.h"
 #include "Framework/DanglingContext.h"
+#include "Framework/GroupIndexCache.h"
 #include "InputRouteHelpers.h"
 #include "Framework/EndOfStreamContext.h"
 #include "Framework/RawDeviceService.h"
@@ -624,5 +625,15 @@ o2::framework::ServiceSpec CommonAnalysisServices::databasePDGSpec()
     .exit = [](ServiceRegistry&, void* service) { reinterpret_cast<TDatabasePDG*>(service)->Delete(); },
     .kind = ServiceKind::Serial};
 }
+
+o2::framework::ServiceSpec CommonAnalysisServices::groupIndexCacheSpec()
+{
+  return ServiceSpec{
+    .name = "group-index-cache",
+    .init = CommonServices::simpleServiceInit<GroupIndexCache, GroupIndexCache>(),
+    .configure = CommonServices::noConfiguration(),
+    .preProcessing = [](ProcessingContext&, void* service) { reinterpret_cast<GroupIndexCache*>(service)->clear(); },
+    .kind = ServiceKind::Serial};
+}
 } // namespace o2::framework
 #pragma GCC diagnostic pop
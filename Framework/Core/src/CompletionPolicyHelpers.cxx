@@ -107,7 +107,9 @@ CompletionPolicy CompletionPolicyHelpers::consumeWhenAll(const char* name, Compl
     }
     return CompletionPolicy::CompletionOp::Consume;
   };
-  return CompletionPolicy{name, matcher, callback};
+  CompletionPolicy policy{name, matcher, callback};
+  policy.waitsForAllInputs = true;
+  return policy;
 }
 
 CompletionPolicy CompletionPolicyHelpers::consumeExistingWhenAny(const char* name, CompletionPolicy::Matcher matcher)
@@ -13,6 +13,7 @@
 #include "Framework/TableTreeHelpers.h"
 #include "Framework/DataAllocator.h"
 #include "Framework/MessageContext.h"
+#include "Framework/MessagePool.h"
 #include "Framework/ArrowContext.h"
 #include "Framework/DataSpecUtils.h"
 #include "Framework/DataProcessingHeader.h"
@@ -187,14 +188,27 @@ void doWriteTable(std::shared_ptr<FairMQResizableBuffer> b, arrow::Table* table)
   }
 }
 
+/// The arrow buffers are recycled through the message pool, when enabled.
+FairMQResizableBuffer::Creator arrowBufferCreator(ServiceRegistry& registry)
+{
+  auto pool = registry.get<MessageContext>().proxy().getMessagePool();
+  return [device = registry.get<ArrowContext>().proxy().getDevice(), pool](size_t s) -> std::unique_ptr<FairMQMessage> {
+    if (pool) {
+      if (auto message = pool->createMessage(s)) {
+        return message;
+      }
+    }
+    return device->NewMessage(s);
+  };
+}
+
 void DataAllocator::adopt(const Output& spec, TableBuilder* tb)
 {
   std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
   auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodArrow, 0);
   auto& context = mRegistry->get<ArrowContext>();
 
-  auto creator = [device = context.proxy().getDevice()](size_t s) -> std::unique_ptr<FairMQMessage> { return device->NewMessage(s); };
-  auto buffer = std::make_shared<FairMQResizableBuffer>(creator);
+  auto buffer = std::make_shared<FairMQResizableBuffer>(arrowBufferCreator(*mRegistry));
 
   /// To finalise this we write the table to the buffer.
   /// FIXME: most likely not a great idea. We should probably write to the buffer
@@ -215,10 +229,7 @@ void DataAllocator::adopt(const Output& spec, TreeToTable* t2t)
   auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodArrow, 0);
   auto& context = mRegistry->get<ArrowContext>();
 
-  auto creator = [device = context.proxy().getDevice()](size_t s) -> std::unique_ptr<FairMQMessage> {
-    return device->NewMessage(s);
-  };
-  auto buffer = std::make_shared<FairMQResizableBuffer>(creator);
+  auto buffer = std::make_shared<FairMQResizableBuffer>(arrowBufferCreator(*mRegistry));
 
   /// To finalise this we write the table to the buffer.
   /// FIXME: most likely not a great idea. We should probably write to the buffer
@@ -238,10 +249,7 @@ void DataAllocator::adopt(const Output& spec, std::shared_ptr<arrow::Table> ptr)
   auto header = headerMessageFromOutput(spec, channel, o2::header::gSerializationMethodArrow, 0);
   auto& context = mRegistry->get<ArrowContext>();
 
-  auto creator = [device = context.proxy().getDevice()](size_t s) -> std::unique_ptr<FairMQMessage> {
-    return device->NewMessage(s);
-  };
-  auto buffer = std::make_shared<FairMQResizableBuffer>(creator);
+  auto buffer = std::make_shared<FairMQResizableBuffer>(arrowBufferCreator(*mRegistry));
 
   auto writer = [table = ptr](std::shared_ptr<FairMQResizableBuffer> b) -> void {
     doWriteTable(b, table.get());
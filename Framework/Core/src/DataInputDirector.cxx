@@ -11,6 +11,7 @@
 #include "Framework/DataInputDirector.h"
 #include "Framework/DataDescriptorQueryBuilder.h"
 #include "Framework/Logger.h"
+#include "Framework/ArrowFileHelpers.h"
 #include "AnalysisDataModelHelpers.h"
 
 #include "rapidjson/document.h"
@@ -20,6 +21,9 @@
 #include "TGrid.h"
 #include "TObjString.h"
 
+#include <filesystem>
+#include <sstream>
+
 namespace o2
 {
 namespace framework
@@ -92,6 +96,32 @@ bool DataInputDescriptor::setFile(int counter)
 
   // open file
   auto filename = mfilenames[counter]->fileName;
+  if (ArrowFileHelpers::isArrowDirectory(filename)) {
+    if (mcurrentDirectory != filename) {
+      closeInputFile();
+      mcurrentDirectory = filename;
+    }
+
+    // the dataframes are the subdirectories
+    if (mfilenames[counter]->numberOfTimeFrames <= 0) {
+      std::regex TFRegex = std::regex("DF_[0-9]+");
+      for (auto& entry : std::filesystem::directory_iterator(filename)) {
+        auto name = entry.path().filename().string();
+        if (entry.is_directory() && std::regex_match(name, TFRegex)) {
+          mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(std::stoul(name.substr(3)));
+        }
+      }
+      std::sort(mfilenames[counter]->listOfTimeFrameNumbers.begin(), mfilenames[counter]->listOfTimeFrameNumbers.end());
+
+      for (auto folderNumber : mfilenames[counter]->listOfTimeFrameNumbers) {
+        mfilenames[counter]->listOfTimeFrameKeys.emplace_back("DF_" + std::to_string(folderNumber));
+      }
+      mfilenames[counter]->numberOfTimeFrames = mfilenames[counter]->listOfTimeFrameKeys.size();
+    }
+    return true;
+  }
+  mcurrentDirectory.clear();
+
   if (mcurrentFile) {
     if (mcurrentFile->GetName() != filename) {
       closeInputFile();
@@ -160,6 +190,7 @@ FileAndFolder DataInputDescriptor::getFileFolder(int counter, int numTF)
   }
 
   fileAndFolder.file = mcurrentFile;
+  fileAndFolder.directory = mcurrentDirectory;
   fileAndFolder.folderName = (mfilenames[counter]->listOfTimeFrameKeys)[numTF];
 
   return fileAndFolder;
@@ -177,6 +208,7 @@ void DataInputDescriptor::closeInputFile()
     mcurrentFile = nullptr;
     delete mcurrentFile;
   }
+  mcurrentDirectory.clear();
 }
 
 int DataInputDescriptor::fillInputfiles()
@@ -583,6 +615,58 @@ TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int nu
   return tree;
 }
 
+std::shared_ptr<arrow::Table> DataInputDirector::getDataTable(header::DataHeader dh, int counter, int numTF)
+{
+  std::string treename;
+
+  auto didesc = getDataInputDescriptor(dh);
+  if (didesc) {
+    treename = didesc->treename;
+  } else {
+    didesc = mdefaultDataInputDescriptor;
+    treename = aod::datamodel::getTreeName(dh);
+  }
+
+  auto fileAndFolder = didesc->getFileFolder(counter, numTF);
+  if (fileAndFolder.directory.empty()) {
+    return nullptr;
+  }
+  auto path = fileAndFolder.directory + "/" + fileAndFolder.folderName + "/" + treename + ArrowFileHelpers::extension;
+  if (!std::filesystem::exists(path)) {
+    throw std::runtime_error(fmt::format(R"(Couldn't find table "{}" in "{}")", treename, fileAndFolder.directory));
+  }
+  return ArrowFileHelpers::read(path, getColumnsToRead(dh));
+}
+
+void DataInputDirector::setColumnsToRead(std::string const& columns)
+{
+  mColumnsToRead.clear();
+  std::stringstream tables(columns);
+  std::string table;
+  while (std::getline(tables, table, ';')) {
+    auto pos = table.find(':');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    auto& names = mColumnsToRead[table.substr(0, pos)];
+    std::stringstream list(table.substr(pos + 1));
+    std::string name;
+    while (std::getline(list, name, ',')) {
+      names.push_back(name);
+    }
+  }
+}
+
+std::vector<std::string> DataInputDirector::getColumnsToRead(header::DataHeader dh) const
+{
+  auto key = dh.dataOrigin.as<std::string>() + "/" + dh.dataDescription.as<std::string>();
+  auto it = mColumnsToRead.find(key);
+  if (it == mColumnsToRead.end()) {
+    return {};
+  }
+  return it->second;
+}
+
 void DataInputDirector::closeInputFiles()
 {
   mdefaultDataInputDescriptor->closeInputFile();
@@ -15,6 +15,10 @@
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/filereadstream.h"
 
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
+#include <filesystem>
+
 namespace o2
 {
 namespace framework
@@ -314,6 +318,26 @@ std::tuple<std::string, std::string, int> DataOutputDirector::readJsonDocument(D
     }
   }
 
+  itemName = "format";
+  if (dodirItem.HasMember(itemName)) {
+    if (dodirItem[itemName].IsString()) {
+      setFormat(dodirItem[itemName].GetString());
+    } else {
+      LOGP(ERROR, "Check the JSON document! Item \"{}\" must be a string!", itemName);
+      return memptyanswer;
+    }
+  }
+
+  itemName = "compression";
+  if (dodirItem.HasMember(itemName)) {
+    if (dodirItem[itemName].IsString()) {
+      setCompression(dodirItem[itemName].GetString());
+    } else {
+      LOGP(ERROR, "Check the JSON document! Item \"{}\" must be a string!", itemName);
+      return memptyanswer;
+    }
+  }
+
   itemName = "ntfmerge";
   if (dodirItem.HasMember(itemName)) {
     if (dodirItem[itemName].IsNumber()) {
@@ -456,6 +480,35 @@ FileAndFolder DataOutputDirector::getFileFolder(DataOutputDescriptor* dodesc, ui
   return fileAndFolder;
 }
 
+void DataOutputDirector::setFormat(std::string format)
+{
+  if (format != "root" && format != "arrow") {
+    LOGP(ERROR, "Unknown output format \"{}\", using root", format);
+    format = "root";
+  }
+  mformat = format;
+}
+
+void DataOutputDirector::writeArrowTable(DataOutputDescriptor* dodesc, uint64_t folderNumber, std::shared_ptr<arrow::Table> const& table)
+{
+  auto directory = dodesc->getFilenameBase() + ArrowFileHelpers::extension;
+  if (mArrowDirectories.insert(directory).second && mfileMode == "RECREATE") {
+    // first table for this output
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+  }
+
+  // The writers stay open until closeDataFiles(), as the ROOT files do: a
+  // late time frame of a previous dataframe is appended to its file, while
+  // opening it again would truncate it
+  auto path = directory + "/DF_" + std::to_string(folderNumber) + "/" + dodesc->treename + ArrowFileHelpers::extension;
+  auto& writer = mArrowWriters[path];
+  if (!writer) {
+    writer = ArrowFileHelpers::makeWriter(path, table->schema(), mcompression);
+  }
+  ArrowFileHelpers::write(*writer, *table);
+}
+
 void DataOutputDirector::closeDataFiles()
 {
   for (auto filePtr : mfilePtrs) {
@@ -463,6 +516,13 @@ void DataOutputDirector::closeDataFiles()
       filePtr->Close();
     }
   }
+  for (auto& [path, writer] : mArrowWriters) {
+    auto status = writer->Close();
+    if (!status.ok()) {
+      LOGP(ERROR, "Could not close {}: {}", path, status.ToString());
+    }
+  }
+  mArrowWriters.clear();
 }
 
 void DataOutputDirector::printOut()
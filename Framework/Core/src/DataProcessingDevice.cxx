@@ -42,6 +42,7 @@
 #include "DataProcessingHelpers.h"
 #include "DataRelayerHelpers.h"
 #include "ProcessingPoliciesHelpers.h"
+#include "ProcessingLanes.h"
 #include "Headers/DataHeader.h"
 #include "Headers/DataHeaderHelpers.h"
 
@@ -58,6 +59,8 @@
 #include <TClonesArray.h>
 
 #include <algorithm>
+#include <exception>
+#include <optional>
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -163,6 +166,8 @@ DataProcessingDevice::DataProcessingDevice(RunningDeviceRef ref, ServiceRegistry
   });
 }
 
+DataProcessingDevice::~DataProcessingDevice() = default;
+
 // Callback to execute the processing. Notice how the data is
 // is a vector of DataProcessorContext so that we can index the correct
 // one with the thread id. For the moment we simply use the first one.
@@ -502,6 +507,17 @@ void DataProcessingDevice::InitTask()
   // channel, we can still start an enumeration.
   mWasActive = true;
 
+  // A DataProcessor can declare that its processing callback is thread safe
+  // by having a "processing-threads" option. In that case the timeslices which
+  // are ready together get processed concurrently on that many lanes.
+  if (mConfigRegistry->isSet("processing-threads")) {
+    auto nLanes = mConfigRegistry->get<int>("processing-threads");
+    if (nLanes > 1) {
+      LOGP(info, "Processing up to {} timeslices concurrently", nLanes);
+      mLanes = std::make_unique<ProcessingLanes>(nLanes, mServiceRegistry, FairMQDeviceProxy{this}, mSpec.outputs);
+    }
+  }
+
   // We should be ready to run here. Therefore we copy all the
   // required parts in the DataProcessorContext. Eventually we should
   // do so on a per thread basis, with fine grained locks.
@@ -537,6 +553,7 @@ void DataProcessingDevice::fillContext(DataProcessorContext& context, DeviceCont
   context.expirationHandlers = &mExpirationHandlers;
   context.timingInfo = &mTimingInfo;
   context.allocator = &mAllocator;
+  context.lanes = mLanes.get();
   context.statefulProcess = &mStatefulProcess;
   context.statelessProcess = &mStatelessProcess;
   context.error = &mError;
@@ -953,9 +970,11 @@ void DataProcessingDevice::handleData(DataProcessorContext& context, InputChanne
 
   auto handleValidMessages = [&info, &context = context, &relayer = *context.relayer, &reportError](std::vector<InputType> const& types) {
     static WaitBackpressurePolicy policy;
+    std::vector<DataRelayer::PartsGroup> groups;
     auto& parts = info.parts;
     // We relay execution to make sure we have a complete set of parts
-    // available.
+    // available. All the data parts of the message are relayed in one go,
+    // so that the relayer can reuse the matching of similar parts.
     for (size_t pi = 0; pi < (parts.Size() / 2); ++pi) {
       switch (types[pi]) {
         case InputType::Data: {
@@ -963,28 +982,8 @@ void DataProcessingDevice::handleData(DataProcessorContext& context, InputChanne
           auto payloadIndex = 2 * pi + 1;
           assert(payloadIndex < parts.Size());
           auto dh = o2::header::get<DataHeader*>(parts.At(headerIndex)->GetData());
-          auto relayed = relayer.relay(parts.At(headerIndex),
-                                       &parts.At(payloadIndex), dh->splitPayloadParts > 0 ? dh->splitPayloadParts * 2 - 1 : 0);
+          groups.push_back({headerIndex, dh->splitPayloadParts > 0 ? dh->splitPayloadParts * 2 - 1 : 0});
           pi += dh->splitPayloadParts > 0 ? dh->splitPayloadParts - 1 : 0;
-          switch (relayed) {
-            case DataRelayer::Backpressured:
-              if (info.normalOpsNotified == true && info.backpressureNotified == false) {
-                LOGP(WARN, "Backpressure on channel {}. Waiting.", info.channel->GetName());
-                info.backpressureNotified = true;
-                info.normalOpsNotified = false;
-              }
-              policy.backpressure(info);
-              break;
-            case DataRelayer::Dropped:
-            case DataRelayer::Invalid:
-            case DataRelayer::WillRelay:
-              if (info.normalOpsNotified == false && info.backpressureNotified == true) {
-                LOGP(info, "Back to normal on channel {}.", info.channel->GetName());
-                info.normalOpsNotified = true;
-                info.backpressureNotified = false;
-              }
-              break;
-          }
         } break;
         case InputType::SourceInfo: {
           *context.wasActive = true;
@@ -1007,6 +1006,30 @@ void DataProcessingDevice::handleData(DataProcessorContext& context, InputChanne
         } break;
       }
     }
+    if (groups.empty() == false) {
+      relayer.relay(parts.fParts.data(), groups);
+    }
+    for (auto& group : groups) {
+      switch (group.choice) {
+        case DataRelayer::Backpressured:
+          if (info.normalOpsNotified == true && info.backpressureNotified == false) {
+            LOGP(WARN, "Backpressure on channel {}. Waiting.", info.channel->GetName());
+            info.backpressureNotified = true;
+            info.normalOpsNotified = false;
+          }
+          policy.backpressure(info);
+          break;
+        case DataRelayer::Dropped:
+        case DataRelayer::Invalid:
+        case DataRelayer::WillRelay:
+          if (info.normalOpsNotified == false && info.backpressureNotified == true) {
+            LOGP(info, "Back to normal on channel {}.", info.channel->GetName());
+            info.normalOpsNotified = true;
+            info.backpressureNotified = false;
+          }
+          break;
+      }
+    }
     auto it = std::remove_if(parts.fParts.begin(), parts.fParts.end(), [](auto& msg) -> bool { return msg.get() == nullptr; });
     auto r = std::distance(it, parts.fParts.end());
     parts.fParts.erase(it, parts.end());
@@ -1076,11 +1099,11 @@ void update_maximum(std::atomic<T>& maximum_value, T const& value) noexcept
 bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context, std::vector<DataRelayer::RecordAction>& completed)
 {
   ZoneScopedN("DataProcessingDevice::tryDispatchComputation");
-  // This is the actual hidden state for the outer loop. In case we decide we
-  // want to support multithreaded dispatching of operations, I can simply
-  // move these to some thread local store and the rest of the lambdas
-  // should work just fine.
+  // This is the actual hidden state for the outer loop. When the processing
+  // happens on multiple lanes, each lane has its own set of inputs, which
+  // is why the lambdas below take the one to use as an argument.
   std::vector<MessageSet> currentSetOfInputs;
+  static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
 
   auto reportError = [&registry = *context.registry, &context](const char* message) {
     registry.get<DataProcessingStats>().errorCount++;
@@ -1109,8 +1132,7 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
   };
 
   //
-  auto getInputSpan = [&relayer = context.relayer,
-                       &currentSetOfInputs](TimesliceSlot slot) {
+  auto getInputSpan = [&relayer = context.relayer](TimesliceSlot slot, std::vector<MessageSet>& currentSetOfInputs) {
     currentSetOfInputs = std::move(relayer->getInputsForTimeslice(slot));
     auto getter = [&currentSetOfInputs](size_t i, size_t partindex) -> DataRef {
       if (currentSetOfInputs[i].size() > partindex) {
@@ -1134,21 +1156,20 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
   // propagates it to the various contextes (i.e. the actual entities which
   // create messages) because the messages need to have the timeslice id into
   // it.
-  auto prepareAllocatorForCurrentTimeSlice = [&timingInfo = context.timingInfo,
-                                              &relayer = context.relayer](TimesliceSlot i) {
+  auto prepareAllocatorForCurrentTimeSlice = [&relayer = context.relayer](TimesliceSlot i, TimingInfo& timingInfo) {
     ZoneScopedN("DataProcessingDevice::prepareForCurrentTimeslice");
     auto timeslice = relayer->getTimesliceForSlot(i);
-    timingInfo->timeslice = timeslice.value;
-    timingInfo->tfCounter = relayer->getFirstTFCounterForSlot(i);
-    timingInfo->firstTFOrbit = relayer->getFirstTFOrbitForSlot(i);
-    timingInfo->runNumber = relayer->getRunNumberForSlot(i);
+    timingInfo.timeslice = timeslice.value;
+    timingInfo.tfCounter = relayer->getFirstTFCounterForSlot(i);
+    timingInfo.firstTFOrbit = relayer->getFirstTFOrbitForSlot(i);
+    timingInfo.runNumber = relayer->getRunNumberForSlot(i);
   };
 
   // When processing them, timers will have to be cleaned up
   // to avoid double counting them.
   // This was actually the easiest solution we could find for
   // O2-646.
-  auto cleanTimers = [&currentSetOfInputs](TimesliceSlot slot, InputRecord& record) {
+  auto cleanTimers = [](TimesliceSlot slot, InputRecord& record, std::vector<MessageSet>& currentSetOfInputs) {
     assert(record.size() == currentSetOfInputs.size());
     for (size_t ii = 0, ie = record.size(); ii < ie; ++ii) {
       DataRef input = record.getByPos(ii);
@@ -1191,7 +1212,7 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
   // FIXME: do it in a smarter way than O(N^2)
   auto forwardInputs = [&reportError,
                         &spec = context.deviceContext->spec,
-                        &device = context.deviceContext->device, &currentSetOfInputs](TimesliceSlot slot, InputRecord& record, bool copy, bool consume = true) {
+                        &device = context.deviceContext->device](TimesliceSlot slot, InputRecord& record, std::vector<MessageSet>& currentSetOfInputs, bool copy, bool consume = true) {
     ZoneScopedN("forward inputs");
     assert(record.size() == currentSetOfInputs.size());
     // we collect all messages per forward in a map and send them together
@@ -1335,16 +1356,43 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     }
   };
 
-  // This is the main dispatching loop
-  for (auto action : getReadyActions()) {
-    if (action.op == CompletionPolicy::CompletionOp::Wait) {
-      continue;
+  // Invoke the user provided processing. When the DataProcessor runs on
+  // multiple lanes this is the only part which happens outside the main
+  // thread.
+  auto invokeProcess = [&context](ProcessingContext& processContext) {
+    if (*context.statefulProcess) {
+      ZoneScopedN("statefull process");
+      (*context.statefulProcess)(processContext);
     }
+    if (*context.statelessProcess) {
+      ZoneScopedN("stateless process");
+      (*context.statelessProcess)(processContext);
+    }
+  };
 
-    prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot});
-    InputSpan span = getInputSpan(action.slot);
-    InputRecord record{context.deviceContext->spec->inputs, span};
-    ProcessingContext processContext{record, *context.registry, *context.allocator};
+  auto handleErrors = [&context](InputRecord& record, auto&& callback) {
+    if (noCatch) {
+      callback();
+      return;
+    }
+    try {
+      callback();
+    } catch (std::exception& ex) {
+      ZoneScopedN("error handling");
+      /// Convert a standard exception to a RuntimeErrorRef
+      /// Notice how this will lose the backtrace information
+      /// and report the exception coming from here.
+      auto e = runtime_error(ex.what());
+      (*context.errorHandling)(e, record);
+    } catch (o2::framework::RuntimeErrorRef e) {
+      ZoneScopedN("error handling");
+      (*context.errorHandling)(e, record);
+    }
+  };
+
+  // Everything which needs to happen before the processing of a given
+  // action. @return false if the action does not need to be processed.
+  auto prepareAction = [&](DataRelayer::RecordAction const& action, InputRecord& record, std::vector<MessageSet>& inputs, ProcessingContext& processContext) -> bool {
     {
       ZoneScopedN("service pre processing");
       context.registry->preProcessingCallbacks(processContext);
@@ -1352,8 +1400,8 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     if (action.op == CompletionPolicy::CompletionOp::Discard) {
       context.registry->postDispatchingCallbacks(processContext);
       if (context.deviceContext->spec->forwards.empty() == false) {
-        forwardInputs(action.slot, record, false);
-        continue;
+        forwardInputs(action.slot, record, inputs, false);
+        return false;
       }
     }
     // If there is no optional inputs we canForwardEarly
@@ -1361,65 +1409,149 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     // In this case we pass true to indicate that we want to
     // copy the messages to the subsequent data processor.
     if (context.canForwardEarly && context.deviceContext->spec->forwards.empty() == false && action.op == CompletionPolicy::CompletionOp::Consume) {
-      forwardInputs(action.slot, record, true);
+      forwardInputs(action.slot, record, inputs, true);
     }
     markInputsAsDone(action.slot);
+    return true;
+  };
 
-    uint64_t tStart = uv_hrtime();
-    preUpdateStats(action, record, tStart);
-
-    static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
-
-    auto runNoCatch = [&context, &processContext](DataRelayer::RecordAction& action) {
-      if (context.deviceContext->state->quitRequested == false) {
-        if (*context.statefulProcess) {
-          ZoneScopedN("statefull process");
-          (*context.statefulProcess)(processContext);
-        }
-        if (*context.statelessProcess) {
-          ZoneScopedN("stateless process");
-          (*context.statelessProcess)(processContext);
-        }
-
-        {
-          ZoneScopedN("service post processing");
-          context.registry->postProcessingCallbacks(processContext);
-        }
-      }
-    };
-
-    if (noCatch) {
-      runNoCatch(action);
-    } else {
-      try {
-        runNoCatch(action);
-      } catch (std::exception& ex) {
-        ZoneScopedN("error handling");
-        /// Convert a standard exception to a RuntimeErrorRef
-        /// Notice how this will lose the backtrace information
-        /// and report the exception coming from here.
-        auto e = runtime_error(ex.what());
-        (*context.errorHandling)(e, record);
-      } catch (o2::framework::RuntimeErrorRef e) {
-        ZoneScopedN("error handling");
-        (*context.errorHandling)(e, record);
-      }
-    }
-
+  // Everything which needs to happen once the processing of a given
+  // action is completed.
+  auto finishAction = [&](DataRelayer::RecordAction const& action, InputRecord& record, std::vector<MessageSet>& inputs, ProcessingContext& processContext, uint64_t tStart) {
     postUpdateStats(action, record, tStart);
     // We forward inputs only when we consume them. If we simply Process them,
     // we keep them for next message arriving.
     if (action.op == CompletionPolicy::CompletionOp::Consume) {
       context.registry->postDispatchingCallbacks(processContext);
       if ((context.canForwardEarly == false) && context.deviceContext->spec->forwards.empty() == false) {
-        forwardInputs(action.slot, record, false);
+        forwardInputs(action.slot, record, inputs, false);
       }
 #ifdef TRACY_ENABLE
       cleanupRecord(record);
 #endif
     } else if (action.op == CompletionPolicy::CompletionOp::Process) {
-      cleanTimers(action.slot, record);
+      cleanTimers(action.slot, record, inputs);
+    }
+  };
+
+  // This is the main dispatching loop
+  if (context.lanes == nullptr) {
+    for (auto action : getReadyActions()) {
+      if (action.op == CompletionPolicy::CompletionOp::Wait) {
+        continue;
+      }
+
+      prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot}, *context.timingInfo);
+      InputSpan span = getInputSpan(action.slot, currentSetOfInputs);
+      InputRecord record{context.deviceContext->spec->inputs, span};
+      ProcessingContext processContext{record, *context.registry, *context.allocator};
+      if (prepareAction(action, record, currentSetOfInputs, processContext) == false) {
+        continue;
+      }
+
+      uint64_t tStart = uv_hrtime();
+      preUpdateStats(action, record, tStart);
+
+      handleErrors(record, [&context, &processContext, &invokeProcess]() {
+        if (context.deviceContext->state->quitRequested == false) {
+          invokeProcess(processContext);
+          {
+            ZoneScopedN("service post processing");
+            context.registry->postProcessingCallbacks(processContext);
+          }
+        }
+      });
+
+      finishAction(action, record, currentSetOfInputs, processContext, tStart);
+    }
+  } else {
+    // The ready actions are processed in batches of (at most) one per lane.
+    // Relaying, forwarding and sending stay on the main thread and happen in
+    // the same order as for the serial case, only the user callback runs
+    // concurrently.
+    struct LaneWork {
+      DataRelayer::RecordAction action;
+      ProcessingLanes::Lane* lane = nullptr;
+      std::optional<InputSpan> span;
+      std::optional<InputRecord> record;
+      std::optional<ProcessingContext> processContext;
+      uint64_t tStart = 0;
+      std::exception_ptr error;
+    };
+    auto& lanes = *context.lanes;
+    std::vector<LaneWork> batch(lanes.size());
+    size_t batchSize = 0;
+    auto& mainMessageContext = context.registry->get<MessageContext>();
+    auto& mainArrowContext = context.registry->get<ArrowContext>();
+
+    auto flushBatch = [&]() {
+      lanes.run(batchSize, [&batch, &context, &invokeProcess](size_t li) {
+        auto& work = batch[li];
+        if (context.deviceContext->state->quitRequested) {
+          return;
+        }
+        if (noCatch) {
+          invokeProcess(*work.processContext);
+          return;
+        }
+        try {
+          invokeProcess(*work.processContext);
+        } catch (...) {
+          work.error = std::current_exception();
+        }
+      });
+      for (size_t bi = 0; bi < batchSize; ++bi) {
+        auto& work = batch[bi];
+        auto& record = *work.record;
+        prepareAllocatorForCurrentTimeSlice(work.action.slot, *context.timingInfo);
+        ProcessingContext processContext{record, *context.registry, *context.allocator};
+        handleErrors(record, [&]() {
+          if (work.error) {
+            std::rethrow_exception(work.error);
+          }
+          if (context.deviceContext->state->quitRequested == false) {
+            work.lane->send(*context.deviceContext->device, *context.registry, mainArrowContext);
+            ZoneScopedN("service post processing");
+            context.registry->postProcessingCallbacks(processContext);
+          }
+        });
+        work.lane->clear();
+        finishAction(work.action, record, work.lane->inputs, processContext, work.tStart);
+        work.processContext.reset();
+        work.record.reset();
+        work.span.reset();
+        work.error = nullptr;
+      }
+      batchSize = 0;
+    };
+
+    for (auto action : getReadyActions()) {
+      if (action.op == CompletionPolicy::CompletionOp::Wait) {
+        continue;
+      }
+      auto& work = batch[batchSize];
+      work.action = action;
+      work.lane = &lanes[batchSize];
+      auto& lane = *work.lane;
+      lane.clear();
+      lane.messageContext.proxy().setMessagePool(mainMessageContext.proxy().getMessagePool());
+      prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot}, lane.timingInfo);
+      work.span.emplace(getInputSpan(action.slot, lane.inputs));
+      work.record.emplace(context.deviceContext->spec->inputs, *work.span);
+      work.processContext.emplace(*work.record, lane.registry, lane.allocator);
+      if (prepareAction(action, *work.record, lane.inputs, *work.processContext) == false) {
+        work.processContext.reset();
+        work.record.reset();
+        work.span.reset();
+        continue;
+      }
+      work.tStart = uv_hrtime();
+      preUpdateStats(action, *work.record, work.tStart);
+      if (++batchSize == lanes.size()) {
+        flushBatch();
+      }
     }
+    flushBatch();
   }
   // We now broadcast the end of stream if it was requested
   if (context.deviceContext->state->streaming == StreamingState::EndOfStreaming) {
@@ -36,7 +36,9 @@
 
 #include <fmt/format.h>
 #include <gsl/span>
+#include <algorithm>
 #include <numeric>
+#include <optional>
 #include <string>
 
 using namespace o2::framework::data_matcher;
@@ -53,6 +55,16 @@ constexpr int INVALID_INPUT = -1;
 // The number should really be tuned at runtime for each processor.
 constexpr int DEFAULT_PIPELINE_LENGTH = 32;
 
+namespace
+{
+/// An input is filled when its first part has both header and payload,
+/// i.e. when the completion policy would see it as present.
+bool isFilled(MessageSet const& set)
+{
+  return set.size() > 0 && set[0].header != nullptr && set[0].payload != nullptr;
+}
+} // namespace
+
 DataRelayer::DataRelayer(const CompletionPolicy& policy,
                          std::vector<InputRoute> const& routes,
                          monitoring::Monitoring& metrics,
@@ -62,6 +74,7 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
     mCompletionPolicy{policy},
     mDistinctRoutesIndex{DataRelayerHelpers::createDistinctRouteIndex(routes)},
     mInputMatchers{DataRelayerHelpers::createInputMatchers(routes)},
+    mInputMatcherIndex{DataRelayerHelpers::createInputMatcherIndex(routes, mDistinctRoutesIndex)},
     mMaxLanes{InputRouteHelpers::maxLanes(routes)}
 {
   std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
@@ -150,6 +163,9 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
         part.parts.resize(1);
       }
       expirator.handler(services, part[0], variables);
+      if (isFilled(part)) {
+        mFilledInputs[ti]++;
+      }
       activity.expiredSlots++;
 
       mTimesliceIndex.markAsDirty(slot, true);
@@ -163,12 +179,15 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
 /// This does the mapping between a route and a InputSpec. The
 /// reason why these might diffent is that when you have timepipelining
 /// you have one route per timeslice, even if the type is the same.
+/// Only the candidates of the precomputed dispatch table are evaluated.
 size_t matchToContext(void* data,
                       std::vector<DataDescriptorMatcher> const& matchers,
                       std::vector<size_t> const& index,
+                      InputMatcherIndex const& matcherIndex,
                       VariableContext& context)
 {
-  for (size_t ri = 0, re = index.size(); ri < re; ++ri) {
+  auto dh = o2::header::get<DataHeader*>(data);
+  for (auto ri : matcherIndex.candidates(dh)) {
     auto& matcher = matchers[index[ri]];
 
     if (matcher.match(reinterpret_cast<char const*>(data), context)) {
@@ -238,12 +257,13 @@ DataRelayer::RelayChoice
   // become more complicated when we will start supporting ranges.
   auto getInputTimeslice = [&matchers = mInputMatchers,
                             &distinctRoutes = mDistinctRoutesIndex,
+                            &matcherIndex = mInputMatcherIndex,
                             &firstPart,
                             &index](VariableContext& context)
     -> std::tuple<int, TimesliceId> {
     /// FIXME: for the moment we only use the first context and reset
     /// between one invokation and the other.
-    auto input = matchToContext(firstPart->GetData(), matchers, distinctRoutes, context);
+    auto input = matchToContext(firstPart->GetData(), matchers, distinctRoutes, matcherIndex, context);
 
     if (input == INVALID_INPUT) {
       return {
@@ -269,6 +289,7 @@ DataRelayer::RelayChoice
   // hence the first if.
   auto pruneCache = [&cache,
                      &cachedStateMetrics = mCachedStateMetrics,
+                     &filledInputs = mFilledInputs,
                      &numInputTypes,
                      &index,
                      &metrics](TimesliceSlot slot) {
@@ -282,28 +303,15 @@ DataRelayer::RelayChoice
       cache[ai].clear();
       cachedStateMetrics[ai] = CacheEntryStatus::EMPTY;
     }
+    filledInputs[slot.index] = 0;
   };
 
   // Actually save the header / payload in the slot
-  auto saveInSlot = [&firstPart,
-                     &cachedStateMetrics = mCachedStateMetrics,
+  auto saveInSlot = [this,
+                     &firstPart,
                      &restOfParts,
-                     &restOfPartsSize,
-                     &cache,
-                     &numInputTypes,
-                     &metrics](TimesliceId timeslice, int input, TimesliceSlot slot) {
-    auto cacheIdx = numInputTypes * slot.index + input;
-    std::vector<PartRef>& parts = cache[cacheIdx].parts;
-    cachedStateMetrics[cacheIdx] = CacheEntryStatus::PENDING;
-    // TODO: make sure that multiple parts can only be added within the same call of
-    // DataRelayer::relay
-    PartRef entry{std::move(firstPart), std::move(restOfParts[0])};
-    parts.emplace_back(std::move(entry));
-    auto rest = restOfParts + 1;
-    for (size_t pi = 0; pi < (restOfPartsSize - 1) / 2; ++pi) {
-      PartRef entry{std::move(rest[pi * 2]), std::move(rest[pi * 2 + 1])};
-      parts.emplace_back(std::move(entry));
-    }
+                     &restOfPartsSize](TimesliceId timeslice, int input, TimesliceSlot slot) {
+    this->saveInSlot(firstPart, restOfParts, restOfPartsSize, input, slot);
   };
 
   auto updateStatistics = [& stats = mStats](TimesliceIndex::ActionTaken action) {
@@ -381,6 +389,8 @@ DataRelayer::RelayChoice
     saveInSlot(timeslice, input, slot);
     index.publishSlot(slot);
     index.markAsDirty(slot, true);
+    mLastRelayedSlot = slot;
+    mLastRelayedInput = input;
     mStats.relayedMessages++;
     return WillRelay;
   }
@@ -461,11 +471,93 @@ DataRelayer::RelayChoice
       saveInSlot(timeslice, input, slot);
       index.publishSlot(slot);
       index.markAsDirty(slot, true);
+      mLastRelayedSlot = slot;
+      mLastRelayedInput = input;
       return WillRelay;
   }
   O2_BUILTIN_UNREACHABLE();
 }
 
+void DataRelayer::saveInSlot(std::unique_ptr<FairMQMessage>& firstPart,
+                             std::unique_ptr<FairMQMessage>* restOfParts,
+                             size_t restOfPartsSize,
+                             int input, TimesliceSlot slot)
+{
+  auto cacheIdx = mDistinctRoutesIndex.size() * slot.index + input;
+  std::vector<PartRef>& parts = mCache[cacheIdx].parts;
+  bool wasFilled = isFilled(mCache[cacheIdx]);
+  mCachedStateMetrics[cacheIdx] = CacheEntryStatus::PENDING;
+  // TODO: make sure that multiple parts can only be added within the same call of
+  // DataRelayer::relay
+  PartRef entry{std::move(firstPart), std::move(restOfParts[0])};
+  parts.emplace_back(std::move(entry));
+  auto rest = restOfParts + 1;
+  for (size_t pi = 0; pi < (restOfPartsSize - 1) / 2; ++pi) {
+    PartRef entry{std::move(rest[pi * 2]), std::move(rest[pi * 2 + 1])};
+    parts.emplace_back(std::move(entry));
+  }
+  if (!wasFilled && isFilled(mCache[cacheIdx])) {
+    mFilledInputs[slot.index]++;
+  }
+}
+
+void DataRelayer::relay(std::unique_ptr<FairMQMessage>* parts, std::vector<PartsGroup>& groups)
+{
+  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+
+  // What decides where a set of parts goes: the matchers only look at the
+  // data type and at the timeslice, while the rest is recorded in the context
+  // when the slot is created.
+  struct Identity {
+    o2::header::DataOrigin origin;
+    o2::header::DataDescription description;
+    DataHeader::SubSpecificationType subSpec = 0;
+    DataHeader::RunNumberType runNumber = 0;
+    DataHeader::TFCounterType tfCounter = 0;
+    DataHeader::TForbitType firstTForbit = 0;
+    uint64_t startTime = 0;
+
+    bool operator==(Identity const& other) const
+    {
+      return origin == other.origin && description == other.description && subSpec == other.subSpec &&
+             runNumber == other.runNumber && tfCounter == other.tfCounter && firstTForbit == other.firstTForbit &&
+             startTime == other.startTime;
+    }
+  };
+  auto getIdentity = [](FairMQMessage const& header) -> std::optional<Identity> {
+    auto dh = o2::header::get<DataHeader*>(header.GetData());
+    auto dph = o2::header::get<DataProcessingHeader*>(header.GetData());
+    if (!dh || !dph) {
+      return std::nullopt;
+    }
+    return Identity{dh->dataOrigin, dh->dataDescription, dh->subSpecification,
+                    dh->runNumber, dh->tfCounter, dh->firstTForbit, dph->startTime};
+  };
+
+  std::optional<Identity> previous;
+  size_t fastRelayed = 0;
+  for (auto& group : groups) {
+    auto& firstPart = parts[group.firstPart];
+    auto* restOfParts = parts + group.firstPart + 1;
+    auto identity = getIdentity(*firstPart);
+    auto slot = mLastRelayedSlot;
+    // The previous set went to a slot which is still in use, so this one,
+    // being of the same kind, must go there as well.
+    if (identity && previous && *identity == *previous && mLastRelayedInput != INVALID_INPUT &&
+        TimesliceSlot::isValid(slot) && mTimesliceIndex.isValid(slot)) {
+      saveInSlot(firstPart, restOfParts, group.restOfPartsSize, mLastRelayedInput, slot);
+      mTimesliceIndex.publishSlot(slot);
+      mTimesliceIndex.markAsDirty(slot, true);
+      fastRelayed++;
+      group.choice = WillRelay;
+      continue;
+    }
+    group.choice = relay(firstPart, restOfParts, group.restOfPartsSize);
+    previous = group.choice == WillRelay ? identity : std::nullopt;
+  }
+  mStats.relayedMessages += fastRelayed;
+}
+
 void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& completed)
 {
   std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
@@ -495,12 +587,11 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
 
   // THE OUTER LOOP
   //
-  // To determine if a line is complete, we iterate on all the arguments
-  // and check if they are ready. We do it this way, because in the end
-  // the number of inputs is going to be small and having a more complex
-  // structure will probably result in a larger footprint in any case.
-  // Also notice that ai == inputsNumber only when we reach the end of the
-  // iteration, that means we have found all the required bits.
+  // We only check the cachelines which have been updated by an incoming
+  // message since the last invocation. The TimesliceIndex keeps track of
+  // them, so that we do not need to scan all the cachelines. If the policy
+  // needs all the inputs to be there, we also know from the number of filled
+  // inputs of the slot whether it is worth looking at the record at all.
   //
   // Notice that the only time numInputTypes is 0 is when we are a dummy
   // device created as a source for timers / conditions.
@@ -510,14 +601,21 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   size_t cacheLines = cache.size() / numInputTypes;
   assert(cacheLines * numInputTypes == cache.size());
 
-  for (int li = cacheLines - 1; li >= 0; --li) {
-    TimesliceSlot slot{(size_t)li};
-    // We only check the cachelines which have been updated by an incoming
-    // message.
-    if (mTimesliceIndex.isDirty(slot) == false) {
+  auto& dirtySlots = mDirtySlots;
+  mTimesliceIndex.extractDirtySlots(dirtySlots);
+  // Keep the order of the full scan, from the last cacheline to the first.
+  std::sort(dirtySlots.begin(), dirtySlots.end(), [](TimesliceSlot const& a, TimesliceSlot const& b) { return a.index > b.index; });
+  dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end(), [](TimesliceSlot const& a, TimesliceSlot const& b) { return a.index == b.index; }), dirtySlots.end());
+
+  for (auto slot : dirtySlots) {
+    if (slot.index >= cacheLines || mTimesliceIndex.isDirty(slot) == false) {
+      continue;
+    }
+    if (mCompletionPolicy.waitsForAllInputs && mFilledInputs[slot.index] < numInputTypes) {
+      mTimesliceIndex.markAsDirty(slot, false);
       continue;
     }
-    auto partial = getPartialRecord(li);
+    auto partial = getPartialRecord(slot.index);
     auto getter = [&partial](size_t idx, size_t part) {
       if (partial[idx].size() > 0 && partial[idx].at(part).header && partial[idx].at(part).payload) {
         return DataRef{nullptr,
@@ -603,11 +701,12 @@ std::vector<o2::framework::MessageSet> DataRelayer::getInputsForTimeslice(Timesl
   // timeslice, so I can simply do that. I keep the assertion there because in principle
   // we should have dispatched the timeslice already!
   // FIXME: what happens when we have enough timeslices to hit the invalid one?
-  auto invalidateCacheFor = [&numInputTypes, &cachedStateMetrics = mCachedStateMetrics, &index, &cache](TimesliceSlot s) {
+  auto invalidateCacheFor = [&numInputTypes, &cachedStateMetrics = mCachedStateMetrics, &filledInputs = mFilledInputs, &index, &cache](TimesliceSlot s) {
     for (size_t ai = s.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
       assert(std::accumulate(cache[ai].begin(), cache[ai].end(), true, [](bool result, auto const& element) { return result && element.header.get() == nullptr && element.payload.get() == nullptr; }));
       cache[ai].clear();
     }
+    filledInputs[s.index] = 0;
     index.markAsInvalid(s);
   };
 
@@ -628,6 +727,7 @@ void DataRelayer::clear()
   for (auto& cache : mCache) {
     cache.clear();
   }
+  std::fill(mFilledInputs.begin(), mFilledInputs.end(), 0);
   for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
     mTimesliceIndex.markAsInvalid(TimesliceSlot{s});
   }
@@ -658,6 +758,7 @@ void DataRelayer::publishMetrics()
 
   auto numInputTypes = mDistinctRoutesIndex.size();
   mCache.resize(numInputTypes * mTimesliceIndex.size());
+  mFilledInputs.resize(mTimesliceIndex.size(), 0);
   mMetrics.send({(int)numInputTypes, "data_relayer/h", Verbosity::Debug});
   mMetrics.send({(int)mTimesliceIndex.size(), "data_relayer/w", Verbosity::Debug});
   sMetricsNames.resize(mCache.size());
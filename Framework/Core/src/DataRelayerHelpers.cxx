@@ -12,6 +12,7 @@
 #include "DataRelayerHelpers.h"
 #include "Framework/DataDescriptorMatcher.h"
 #include "Framework/InputRoute.h"
+#include <algorithm>
 #include <stdexcept>
 
 using namespace o2::framework::data_matcher;
@@ -70,4 +71,29 @@ std::vector<DataDescriptorMatcher>
   return result;
 }
 
+InputMatcherIndex
+  DataRelayerHelpers::createInputMatcherIndex(std::vector<InputRoute> const& routes, std::vector<size_t> const& distinctRoutes)
+{
+  InputMatcherIndex result;
+
+  for (size_t ri = 0; ri < distinctRoutes.size(); ++ri) {
+    auto& route = routes[distinctRoutes[ri]];
+    if (auto pval = std::get_if<ConcreteDataMatcher>(&route.matcher.matcher)) {
+      result.byKey[InputMatcherIndex::Key{pval->origin, pval->description, pval->subSpec}].push_back(ri);
+    } else {
+      result.fallback.push_back(ri);
+    }
+  }
+  // Inputs which cannot be indexed might match anything, so they need to be
+  // checked as well, keeping the original order to preserve which one wins.
+  for (auto& [key, candidates] : result.byKey) {
+    std::vector<size_t> merged;
+    merged.reserve(candidates.size() + result.fallback.size());
+    std::merge(candidates.begin(), candidates.end(), result.fallback.begin(), result.fallback.end(), std::back_inserter(merged));
+    candidates.swap(merged);
+  }
+
+  return result;
+}
+
 } // namespace o2::framework
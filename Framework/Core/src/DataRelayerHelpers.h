@@ -12,6 +12,7 @@
 #define O2_FRAMEWORK_DATARELAYERHELPERS_H_
 
 #include "Framework/InputRoute.h"
+#include "Framework/InputMatcherIndex.h"
 #include <vector>
 
 namespace o2::framework
@@ -23,6 +24,9 @@ struct DataRelayerHelpers {
   static std::vector<size_t> createDistinctRouteIndex(std::vector<InputRoute> const&);
   /// This converts from InputRoute to the associated DataDescriptorMatcher.
   static std::vector<data_matcher::DataDescriptorMatcher> createInputMatchers(std::vector<InputRoute> const&);
+  /// Build the dispatch table for the distinct routes, so that only the
+  /// matchers which can possibly match a given header need to be evaluated.
+  static InputMatcherIndex createInputMatcherIndex(std::vector<InputRoute> const&, std::vector<size_t> const& distinctRoutes);
 };
 
 } // namespace o2::framework
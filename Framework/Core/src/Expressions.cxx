@@ -21,6 +21,7 @@
 #include <unordered_map>
 #include <set>
 #include <algorithm>
+#include <mutex>
 
 using namespace o2::framework;
 
@@ -376,43 +377,98 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
   return gandiva::TreeExprBuilder::MakeExpression(std::move(node), std::move(result));
 }
 
+namespace
+{
+/// Process wide cache of the compiled filters and projectors. The key is
+/// the schema followed by the string representation of the expression
+/// trees, which fully identifies the generated code.
+template <typename T>
+struct CompiledCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<T>> entries;
+  CompiledExpressionCacheStats stats;
+};
+
+template <typename T>
+CompiledCache<T>& compiledCache()
+{
+  static CompiledCache<T> cache;
+  return cache;
+}
+
+/// @return the cached T for @a key, or the one returned by @a make, which
+/// is then added to the cache. Compilation happens under the lock, so that
+/// concurrent requests for the same expression do not compile it twice.
+template <typename T, typename F>
+std::shared_ptr<T> getOrCompile(std::string const& key, F&& make)
+{
+  auto& cache = compiledCache<T>();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto it = cache.entries.find(key);
+  if (it != cache.entries.end()) {
+    cache.stats.hits++;
+    return it->second;
+  }
+  cache.stats.misses++;
+  auto compiled = make();
+  cache.entries.emplace(key, compiled);
+  return compiled;
+}
+} // namespace
+
+CompiledExpressionCacheStats getCompiledExpressionCacheStats()
+{
+  auto& filters = compiledCache<gandiva::Filter>();
+  auto& projectors = compiledCache<gandiva::Projector>();
+  std::scoped_lock lock(filters.mutex, projectors.mutex);
+  return {filters.stats.hits + projectors.stats.hits, filters.stats.misses + projectors.stats.misses};
+}
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return createFilter(Schema, makeCondition(createExpressionTree(opSpecs, Schema)));
 }
 
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 std::move(condition),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+  auto key = Schema->ToString() + "\n" + condition->ToString();
+  return getOrCompile<gandiva::Filter>(key, [&Schema, &condition]() {
+    std::shared_ptr<gandiva::Filter> filter;
+    auto s = gandiva::Filter::Make(Schema,
+                                   std::move(condition),
+                                   &filter);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+    }
+    return filter;
+  });
+}
+
+std::shared_ptr<gandiva::Projector>
+  createProjector(gandiva::SchemaPtr const& Schema, gandiva::ExpressionVector const& expressions)
+{
+  auto key = Schema->ToString();
+  for (auto& expression : expressions) {
+    key += "\n" + expression->result()->ToString() + " = " + expression->ToString();
   }
-  return filter;
+  return getOrCompile<gandiva::Projector>(key, [&Schema, &expressions]() {
+    std::shared_ptr<gandiva::Projector> projector;
+    auto s = gandiva::Projector::Make(Schema,
+                                      expressions,
+                                      &projector);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+    }
+    return projector;
+  });
 }
 
 std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))},
-                                    &projector);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
-  return projector;
+  return createProjector(Schema, {makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))});
 }
 
 std::shared_ptr<gandiva::Projector>
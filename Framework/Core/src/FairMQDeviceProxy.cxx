@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 
 #include "Framework/FairMQDeviceProxy.h"
+#include "Framework/MessagePool.h"
 
 #include <fairmq/FairMQDevice.h>
 #include <fairmq/FairMQMessage.h>
@@ -34,6 +35,11 @@ std::unique_ptr<FairMQMessage> FairMQDeviceProxy::createMessage() const
 
 std::unique_ptr<FairMQMessage> FairMQDeviceProxy::createMessage(const size_t size) const
 {
+  if (mMessagePool) {
+    if (auto message = mMessagePool->createMessage(size)) {
+      return message;
+    }
+  }
   return mDevice->Transport()->CreateMessage(size, fair::mq::Alignment{64});
 }
 
@@ -11,6 +11,7 @@
 
 #include "Framework/Output.h"
 #include "Framework/MessageContext.h"
+#include "Framework/MessagePool.h"
 #include "fairmq/FairMQDevice.h"
 
 namespace o2
@@ -18,8 +19,23 @@ namespace o2
 namespace framework
 {
 
+MessageContext::~MessageContext() = default;
+
+void MessageContext::setMessagePool(std::unique_ptr<MessagePool> pool)
+{
+  // The proxy must not see a dangling pool, not even temporarily.
+  mProxy.setMessagePool(pool.get());
+  mMessagePool = std::move(pool);
+}
+
 FairMQMessagePtr MessageContext::createMessage(const std::string& channel, int index, size_t size)
 {
+  auto pool = proxy().getMessagePool();
+  if (pool && pool->isCompatible(proxy().getTransport(channel, 0))) {
+    if (auto message = pool->createMessage(size)) {
+      return message;
+    }
+  }
   return proxy().getDevice()->NewMessageFor(channel, 0, size, fair::mq::Alignment{64});
 }
 
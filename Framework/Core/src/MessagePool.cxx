@@ -0,0 +1,183 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/MessagePool.h"
+
+#include <fairmq/FairMQTransportFactory.h>
+#include <fairmq/FairMQUnmanagedRegion.h>
+#include <fairmq/FairMQMessage.h>
+
+namespace o2::framework
+{
+
+namespace
+{
+/// Position of the most significant bit
+int log2Floor(size_t value)
+{
+  int result = 0;
+  while (value >>= 1) {
+    ++result;
+  }
+  return result;
+}
+} // namespace
+
+MessagePool::MessagePool(void* base, size_t size)
+  : mBase{static_cast<char*>(base)},
+    mSize{size}
+{
+}
+
+MessagePool::~MessagePool()
+{
+  // The region callback refers to this pool, so the region goes first.
+  mRegion.reset();
+}
+
+std::unique_ptr<MessagePool> MessagePool::create(FairMQTransportFactory* transport, size_t size)
+{
+  auto pool = std::make_unique<MessagePool>(nullptr, 0);
+  // The pool owns the region and drops it first when destroyed, so the
+  // callback never outlives the pool it refers to.
+  auto* self = pool.get();
+  pool->mTransport = transport;
+  pool->mRegion = transport->CreateUnmanagedRegion(size, [self](void* data, size_t, void* hint) {
+    self->release(Block{data, static_cast<int>(reinterpret_cast<intptr_t>(hint))});
+  });
+  pool->mBase = static_cast<char*>(pool->mRegion->GetData());
+  pool->mSize = pool->mRegion->GetSize();
+  return pool;
+}
+
+std::unique_ptr<FairMQMessage> MessagePool::createMessage(size_t size)
+{
+  if (mRegion.get() == nullptr) {
+    return nullptr;
+  }
+  auto block = allocate(size);
+  if (block.data == nullptr) {
+    return nullptr;
+  }
+  return mTransport->CreateMessage(mRegion, block.data, size, reinterpret_cast<void*>(static_cast<intptr_t>(block.sizeClass)));
+}
+
+int MessagePool::sizeClassFor(size_t size)
+{
+  if (size <= MinBlockSize) {
+    return 0;
+  }
+  // Four classes for each power of two above MinBlockSize
+  int group = log2Floor((size - 1) / MinBlockSize);
+  size_t base = MinBlockSize << group;
+  size_t step = (4 * (size - base) + base - 1) / base;
+  return 1 + 4 * group + (step - 1);
+}
+
+size_t MessagePool::sizeOfClass(int sizeClass)
+{
+  if (sizeClass == 0) {
+    return MinBlockSize;
+  }
+  int group = (sizeClass - 1) / 4;
+  int step = (sizeClass - 1) % 4;
+  return ((MinBlockSize << group) / 4) * (4 + step + 1);
+}
+
+MessagePool::Block MessagePool::allocate(size_t size)
+{
+  std::scoped_lock lock(mMutex);
+  // Anything which could not fit even in an empty pool is not worth tracking
+  if (size > mSize / 4) {
+    mStats.misses++;
+    return Block{};
+  }
+  auto sizeClass = sizeClassFor(size);
+  auto blockSize = sizeOfClass(sizeClass);
+  if (mClasses.size() <= size_t(sizeClass)) {
+    mClasses.resize(sizeClass + 1);
+  }
+  auto& entry = mClasses[sizeClass];
+  entry.requested = true;
+
+  void* data = nullptr;
+  if (entry.free.empty() == false) {
+    data = entry.free.back();
+    entry.free.pop_back();
+  } else if (entry.learned && mCarved + blockSize <= mSize) {
+    data = mBase + mCarved;
+    mCarved += blockSize;
+  }
+  if (data == nullptr) {
+    mStats.misses++;
+    return Block{};
+  }
+  mStats.hits++;
+  mStats.requestedBytes += size;
+  mStats.blockBytes += blockSize;
+  return Block{data, sizeClass};
+}
+
+void MessagePool::release(Block block)
+{
+  if (block.data == nullptr) {
+    return;
+  }
+  std::scoped_lock lock(mMutex);
+  mClasses[block.sizeClass].free.push_back(block.data);
+}
+
+void MessagePool::endOfTimeslice()
+{
+  std::scoped_lock lock(mMutex);
+  for (auto& entry : mClasses) {
+    entry.learned = entry.learned || entry.requested;
+    entry.requested = false;
+  }
+  mStats = Stats{};
+}
+
+MessagePool::Stats MessagePool::getStats() const
+{
+  std::scoped_lock lock(mMutex);
+  return mStats;
+}
+
+float MessagePool::getHitRate() const
+{
+  std::scoped_lock lock(mMutex);
+  auto total = mStats.hits + mStats.misses;
+  return total ? float(mStats.hits) / total : 0.f;
+}
+
+float MessagePool::getFragmentation() const
+{
+  std::scoped_lock lock(mMutex);
+  return mStats.blockBytes ? 1.f - float(mStats.requestedBytes) / mStats.blockBytes : 0.f;
+}
+
+size_t MessagePool::getCarvedBytes() const
+{
+  std::scoped_lock lock(mMutex);
+  return mCarved;
+}
+
+size_t MessagePool::getIdleBytes() const
+{
+  std::scoped_lock lock(mMutex);
+  size_t result = 0;
+  for (size_t ci = 0; ci < mClasses.size(); ++ci) {
+    result += mClasses[ci].free.size() * sizeOfClass(ci);
+  }
+  return result;
+}
+
+} // namespace o2::framework
@@ -0,0 +1,138 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "ProcessingLanes.h"
+#include "Framework/DataProcessor.h"
+#include "Framework/TypeIdHelpers.h"
+
+namespace o2::framework
+{
+
+ProcessingLanes::Lane::Lane(ServiceRegistry& mainRegistry, FairMQDeviceProxy proxy, std::vector<OutputRoute> const& outputs)
+  : registry{mainRegistry},
+    messageContext{proxy},
+    stringContext{proxy},
+    arrowContext{proxy},
+    rawBufferContext{proxy},
+    allocator{&timingInfo, &registry, outputs}
+{
+  // Everything which ends up in the outputs of the lane must be private to
+  // it, the rest of the services is shared with the main thread.
+  registry.overrideService(TypeIdHelpers::uniqueId<MessageContext>(), &messageContext);
+  registry.overrideService(TypeIdHelpers::uniqueId<StringContext>(), &stringContext);
+  registry.overrideService(TypeIdHelpers::uniqueId<ArrowContext>(), &arrowContext);
+  registry.overrideService(TypeIdHelpers::uniqueId<RawBufferContext>(), &rawBufferContext);
+  // The grouping is cached per timeslice, and the lanes process different ones.
+  registry.overrideService(TypeIdHelpers::uniqueId<GroupIndexCache>(), &groupIndexCache);
+}
+
+void ProcessingLanes::Lane::send(FairMQDevice& device, ServiceRegistry& mainRegistry, ArrowContext& mainArrowContext)
+{
+  DataProcessor::doSend(device, messageContext, mainRegistry);
+  DataProcessor::doSend(device, stringContext, mainRegistry);
+  DataProcessor::doSend(device, rawBufferContext, mainRegistry);
+  // Arrow tables are finalised by the postProcessing of the ArrowContext,
+  // which also takes care of the accounting of the shared memory.
+  for (auto& message : arrowContext) {
+    mainArrowContext.addBuffer(std::move(message.header), std::move(message.buffer), std::move(message.finalize), message.channel);
+  }
+  clear();
+}
+
+void ProcessingLanes::Lane::clear()
+{
+  messageContext.clear();
+  stringContext.clear();
+  arrowContext.clear();
+  rawBufferContext.clear();
+  groupIndexCache.clear();
+}
+
+ProcessingLanes::ProcessingLanes(size_t nLanes, ServiceRegistry& registry, FairMQDeviceProxy proxy, std::vector<OutputRoute> const& outputs)
+{
+  mLanes.reserve(nLanes);
+  for (size_t li = 0; li < nLanes; ++li) {
+    mLanes.emplace_back(std::make_unique<Lane>(registry, proxy, outputs));
+  }
+  mErrors.resize(nLanes);
+  mThreads.reserve(nLanes);
+  for (size_t li = 0; li < nLanes; ++li) {
+    mThreads.emplace_back([this, li]() { loop(li); });
+  }
+}
+
+ProcessingLanes::~ProcessingLanes()
+{
+  {
+    std::scoped_lock lock(mMutex);
+    mStop = true;
+  }
+  mWakeUp.notify_all();
+  for (auto& thread : mThreads) {
+    thread.join();
+  }
+}
+
+void ProcessingLanes::run(size_t n, std::function<void(size_t)> const& task)
+{
+  if (n == 0) {
+    return;
+  }
+  std::unique_lock lock(mMutex);
+  mTask = &task;
+  mActive = std::min(n, mLanes.size());
+  mPending = mActive;
+  mGeneration++;
+  mWakeUp.notify_all();
+  mDone.wait(lock, [this]() { return mPending == 0; });
+  mTask = nullptr;
+  for (size_t li = 0; li < mActive; ++li) {
+    // Every active lane overwrites its entry, so no reset is needed.
+    if (mErrors[li]) {
+      std::rethrow_exception(mErrors[li]);
+    }
+  }
+}
+
+void ProcessingLanes::loop(size_t laneIndex)
+{
+  uint64_t seen = 0;
+  while (true) {
+    std::function<void(size_t)> const* task = nullptr;
+    {
+      std::unique_lock lock(mMutex);
+      mWakeUp.wait(lock, [this, &seen]() { return mStop || mGeneration != seen; });
+      if (mStop) {
+        return;
+      }
+      seen = mGeneration;
+      if (laneIndex >= mActive) {
+        continue;
+      }
+      task = mTask;
+    }
+    std::exception_ptr error;
+    try {
+      (*task)(laneIndex);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    {
+      std::scoped_lock lock(mMutex);
+      mErrors[laneIndex] = error;
+      if (--mPending == 0) {
+        mDone.notify_one();
+      }
+    }
+  }
+}
+
+} // namespace o2::framework
@@ -0,0 +1,106 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_PROCESSINGLANES_H_
+#define O2_FRAMEWORK_PROCESSINGLANES_H_
+
+#include "Framework/ArrowContext.h"
+#include "Framework/DataAllocator.h"
+#include "Framework/GroupIndexCache.h"
+#include "Framework/MessageContext.h"
+#include "Framework/MessageSet.h"
+#include "Framework/RawBufferContext.h"
+#include "Framework/ServiceRegistry.h"
+#include "Framework/StringContext.h"
+#include "Framework/TimingInfo.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// A fixed set of threads used to invoke a thread safe processing callback
+/// on several timeslices at the same time, within the same device.
+///
+/// Each lane has its own copy of the ServiceRegistry, in which the
+/// following services are replaced by lane local instances:
+/// - the MessageContext, StringContext, ArrowContext and RawBufferContext,
+///   so that the DataAllocator of the lane never touches the contexts of
+///   the others;
+/// - the GroupIndexCache, which is only valid for a single timeslice.
+/// The lane also has its own TimingInfo, DataAllocator and inputs.
+/// All the other services, as well as the state of the processing callback
+/// itself, are shared by the lanes and must be thread safe for a device to
+/// declare "processing-threads". The lanes only run the processing
+/// callback, everything else (relaying, the service callbacks, forwarding,
+/// sending) stays on the main thread.
+class ProcessingLanes
+{
+ public:
+  struct Lane {
+    Lane(ServiceRegistry& registry, FairMQDeviceProxy proxy, std::vector<OutputRoute> const& outputs);
+
+    /// Send what was created by the last processing. The arrow tables are
+    /// handed over to @a arrowContext, so that they are accounted for
+    /// together with the ones of the main thread.
+    void send(FairMQDevice& device, ServiceRegistry& registry, ArrowContext& arrowContext);
+    /// Discard what was left over by the last processing.
+    void clear();
+
+    ServiceRegistry registry;
+    TimingInfo timingInfo;
+    MessageContext messageContext;
+    StringContext stringContext;
+    ArrowContext arrowContext;
+    RawBufferContext rawBufferContext;
+    GroupIndexCache groupIndexCache;
+    DataAllocator allocator;
+    std::vector<MessageSet> inputs;
+  };
+
+  ProcessingLanes(size_t nLanes, ServiceRegistry& registry, FairMQDeviceProxy proxy, std::vector<OutputRoute> const& outputs);
+  ~ProcessingLanes();
+  ProcessingLanes(ProcessingLanes const&) = delete;
+  ProcessingLanes& operator=(ProcessingLanes const&) = delete;
+
+  size_t size() const { return mLanes.size(); }
+  Lane& operator[](size_t i) { return *mLanes[i]; }
+
+  /// Invoke @a task for each of the first @a n lanes, each on its own
+  /// thread, and wait for all of them to complete. If some of them threw,
+  /// the exception of the lowest lane is rethrown on the calling thread.
+  void run(size_t n, std::function<void(size_t)> const& task);
+
+ private:
+  void loop(size_t laneIndex);
+
+  std::vector<std::unique_ptr<Lane>> mLanes;
+  std::vector<std::thread> mThreads;
+  std::vector<std::exception_ptr> mErrors;
+  std::mutex mMutex;
+  std::condition_variable mWakeUp;
+  std::condition_variable mDone;
+  std::function<void(size_t)> const* mTask = nullptr;
+  size_t mActive = 0;
+  size_t mPending = 0;
+  uint64_t mGeneration = 0;
+  bool mStop = false;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_PROCESSINGLANES_H_
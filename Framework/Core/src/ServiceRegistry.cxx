@@ -18,7 +18,7 @@ namespace o2::framework
 
 ServiceRegistry::ServiceRegistry()
 {
-  for (size_t i = 0; i < MAX_SERVICES; ++i) {
+  for (size_t i = 0; i < mServicesKey.size(); ++i) {
     mServicesKey[i].store(0L);
   }
 
@@ -64,6 +64,16 @@ void ServiceRegistry::registerService(hash_type typeHash, void* service, Service
                            ". Make sure you use const / non-const correctly.");
 }
 
+void ServiceRegistry::overrideService(hash_type typeHash, void* service)
+{
+  for (size_t i = 0; i < mServicesKey.size(); ++i) {
+    if (mServicesKey[i].load() == typeHash) {
+      mServicesValue[i] = service;
+    }
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
 void ServiceRegistry::declareService(ServiceSpec const& spec, DeviceState& state, fair::mq::ProgOptions& options)
 {
   mSpecs.push_back(spec);
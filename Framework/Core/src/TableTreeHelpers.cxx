@@ -376,9 +376,9 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
       if (lookup != names.end()) {
         addReader(branch, branch->GetName());
       }
-      if (mBranchReaders.size() != names.size()) {
-        LOGF(warn, "Not all requested columns were found in the tree");
-      }
+    }
+    if (mBranchReaders.size() != names.size()) {
+      LOGF(warn, "Not all requested columns were found in the tree");
     }
   }
   if (mBranchReaders.empty()) {
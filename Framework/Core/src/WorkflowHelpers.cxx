@@ -29,6 +29,7 @@
 #include "Headers/DataHeader.h"
 #include <algorithm>
 #include <list>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -163,6 +164,40 @@ void addMissingOutputsToReader(std::vector<OutputSpec> const& providedOutputs,
   }
 }
 
+std::string WorkflowHelpers::aodColumnsToRead(std::vector<InputSpec> const& requestedAODs)
+{
+  std::map<std::string, std::set<std::string>> columns;
+  std::set<std::string> readAll;
+  std::string const prefix = "projection:";
+  for (auto& input : requestedAODs) {
+    auto concrete = DataSpecUtils::asConcreteDataMatcher(input);
+    auto key = concrete.origin.as<std::string>() + "/" + concrete.description.as<std::string>();
+    bool declared = false;
+    for (auto& param : input.metadata) {
+      if (param.name.compare(0, prefix.size(), prefix) == 0) {
+        columns[key].insert(param.name.substr(prefix.size()));
+        declared = true;
+      }
+    }
+    if (declared == false) {
+      readAll.insert(key);
+    }
+  }
+  std::string result;
+  for (auto& [key, names] : columns) {
+    if (readAll.count(key) != 0) {
+      continue;
+    }
+    result += (result.empty() ? "" : ";") + key + ":";
+    std::string separator;
+    for (auto& name : names) {
+      result += separator + name;
+      separator = ",";
+    }
+  }
+  return result;
+}
+
 void addMissingOutputsToSpawner(std::vector<InputSpec>&& requestedDYNs,
                                 std::vector<InputSpec>& requestedAODs,
                                 DataProcessorSpec& publisher)
@@ -267,6 +302,7 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
     AlgorithmSpec::dummyAlgorithm(),
     {ConfigParamSpec{"aod-file", VariantType::String, {"Input AOD file"}},
      ConfigParamSpec{"aod-reader-json", VariantType::String, {"json configuration file"}},
+     ConfigParamSpec{"aod-reader-read-ahead", VariantType::Bool, false, {"read the next dataframe while the current one is processed"}},
      ConfigParamSpec{"time-limit", VariantType::Int64, 0ll, {"Maximum run time limit in seconds"}},
      ConfigParamSpec{"orbit-offset-enumeration", VariantType::Int64, 0ll, {"initial value for the orbit"}},
      ConfigParamSpec{"orbit-multiplier-enumeration", VariantType::Int64, 0ll, {"multiplier to get the orbit from the counter"}},
@@ -415,6 +451,7 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
   addMissingOutputsToSpawner(std::move(requestedDYNs), requestedAODs, aodSpawner);
   addMissingOutputsToBuilder(std::move(requestedIDXs), requestedAODs, indexBuilder);
 
+  aodReader.options.emplace_back(ConfigParamSpec{"aod-reader-columns", VariantType::String, aodColumnsToRead(requestedAODs), {"columns to read for each table, all if not listed"}});
   addMissingOutputsToReader(providedAODs, requestedAODs, aodReader);
   addMissingOutputsToReader(providedCCDBs, requestedCCDBs, ccdbBackend);
 
@@ -1015,6 +1052,18 @@ std::shared_ptr<DataOutputDirector> WorkflowHelpers::getDataOutputDirector(Confi
       ntfmerge = ntfm;
     }
   }
+  if (options.isSet("aod-writer-format")) {
+    auto format = options.get<std::string>("aod-writer-format");
+    if (!format.empty()) {
+      dod->setFormat(format);
+    }
+  }
+  if (options.isSet("aod-writer-compression")) {
+    auto compression = options.get<std::string>("aod-writer-compression");
+    if (!compression.empty()) {
+      dod->setCompression(compression);
+    }
+  }
   // parse the keepString
   if (options.isSet("aod-writer-keep")) {
     auto keepString = options.get<std::string>("aod-writer-keep");
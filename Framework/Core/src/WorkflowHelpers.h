@@ -214,6 +214,12 @@ struct WorkflowHelpers {
 
   /// returns only dangling outputs
   static std::vector<InputSpec> computeDanglingOutputs(WorkflowSpec const& workflow);
+
+  /// @return the columns which need to be read for each of the requested AOD
+  /// tables, in the format expected by DataInputDirector::setColumnsToRead.
+  /// A table is only restricted if all its consumers declared the columns
+  /// they use via the projection: metadata, otherwise it is read in full.
+  static std::string aodColumnsToRead(std::vector<InputSpec> const& requestedAODs);
 };
 
 } // namespace o2::framework
@@ -1044,6 +1044,7 @@ int doChild(int argc, char** argv, ServiceRegistry& serviceRegistry,
       ("infologger-severity", bpo::value<std::string>()->default_value(""), "minimum FairLogger severity to send to InfoLogger")                                                           //
       ("expected-region-callbacks", bpo::value<std::string>()->default_value("0"), "how many region callbacks we are expecting")                                                           //
       ("configuration,cfg", bpo::value<std::string>()->default_value("command-line"), "configuration backend")                                                                             //
+      ("message-pool-size", bpo::value<std::string>()->default_value("0"), "size in bytes of the shared memory region used to recycle output messages, 0 to disable")                  //
       ("infologger-mode", bpo::value<std::string>()->default_value(""), "O2_INFOLOGGER_MODE override");
     r.fConfig.AddToCmdLineOptions(optsDesc, true);
   });
@@ -1480,6 +1481,10 @@ int runStateMachine(DataProcessorSpecs const& workflow,
                 if (param.type == VariantType::Bool && param.name.find("control:") != std::string::npos) {
                   return param.defaultValue.get<bool>() == true;
                 }
+                // the columns of the table are not relevant for the process switches
+                if (param.name.find("projection:") != std::string::npos) {
+                  return false;
+                }
                 return true;
               });
             });
@@ -1612,6 +1617,8 @@ int runStateMachine(DataProcessorSpecs const& workflow,
             "--aod-file",
             "--aod-memory-rate-limit",
             "--aod-writer-json",
+            "--aod-writer-compression",
+            "--aod-writer-format",
             "--aod-writer-ntfmerge",
             "--aod-writer-resfile",
             "--aod-writer-resmode",
@@ -303,4 +303,141 @@ static void BM_RelaySplitParts(benchmark::State& state)
 
 BENCHMARK(BM_RelaySplitParts);
 
+/// Device with many inputs and many timeslices in flight, using the default
+/// completion policy. The inputs of the different timeslices are interleaved,
+/// so that all the slots are partially filled until the last input arrives.
+/// state.range(0) is the number of inputs, state.range(1) the number of slots.
+static void BM_RelayManyInputsManySlots(benchmark::State& state)
+{
+  Monitoring metrics;
+  const size_t nInputs = state.range(0);
+  const size_t nSlots = state.range(1);
+
+  std::vector<InputRoute> inputs;
+  for (size_t i = 0; i < nInputs; ++i) {
+    InputSpec spec{"input", "TST", "DATA", static_cast<o2::header::DataHeader::SubSpecificationType>(i)};
+    inputs.emplace_back(InputRoute{spec, i, "Fake", 0});
+  }
+
+  std::vector<ForwardRoute> forwards;
+  TimesliceIndex index{1};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(nSlots);
+
+  DataHeader dh;
+  dh.dataDescription = "DATA";
+  dh.dataOrigin = "TST";
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t timeslice = 0;
+  size_t completed = 0;
+  std::vector<RecordAction> ready;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<FairMQMessagePtr> messages;
+    for (size_t ts = 0; ts < nSlots; ++ts) {
+      for (size_t i = 0; i < nInputs; ++i) {
+        DataProcessingHeader dph{timeslice + ts, 1};
+        dh.subSpecification = i;
+        Stack stack{dh, dph};
+        FairMQMessagePtr header = transport->CreateMessage(stack.size());
+        memcpy(header->GetData(), stack.data(), stack.size());
+        messages.emplace_back(std::move(header));
+        messages.emplace_back(transport->CreateMessage(100));
+      }
+    }
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < nInputs; ++i) {
+      for (size_t ts = 0; ts < nSlots; ++ts) {
+        auto mi = 2 * (ts * nInputs + i);
+        relayer.relay(messages[mi], messages[mi + 1]);
+        ready.clear();
+        relayer.getReadyToProcess(ready);
+        for (auto& action : ready) {
+          assert(action.op == CompletionPolicy::CompletionOp::Consume);
+          auto result = relayer.getInputsForTimeslice(action.slot);
+          assert(result.size() == nInputs);
+          completed++;
+        }
+      }
+    }
+    timeslice += nSlots;
+  }
+  if (completed != state.iterations() * nSlots) {
+    state.SkipWithError("not all the timeslices were completed");
+  }
+  state.SetItemsProcessed(state.iterations() * nSlots * nInputs);
+}
+
+BENCHMARK(BM_RelayManyInputsManySlots)->Args({50, 64})->Args({100, 64})->Args({50, 128});
+
+/// Many small parts of the same kind in a single multipart message, as
+/// received by readout facing devices, relayed one by one or in one go.
+/// state.range(0) is the number of parts, state.range(1) is 1 for the
+/// batched relay.
+static void BM_RelayManySmallParts(benchmark::State& state)
+{
+  Monitoring metrics;
+  InputSpec spec{"raw", "TST", "RAWDATA"};
+
+  std::vector<InputRoute> inputs = {
+    InputRoute{spec, 0, "Fake", 0}};
+
+  TimesliceIndex index{1};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(4);
+
+  DataHeader dh;
+  dh.dataDescription = "RAWDATA";
+  dh.dataOrigin = "TST";
+  dh.subSpecification = 0;
+  dh.splitPayloadIndex = 0;
+  dh.splitPayloadParts = 1;
+
+  const size_t nParts = state.range(0);
+  const bool batched = state.range(1);
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t timeslice = 0;
+  std::vector<RecordAction> ready;
+  std::vector<DataRelayer::PartsGroup> groups;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<FairMQMessagePtr> parts;
+    groups.clear();
+    DataProcessingHeader dph{timeslice++, 1};
+    Stack stack{dh, dph};
+    for (size_t i = 0; i < nParts; ++i) {
+      FairMQMessagePtr header = transport->CreateMessage(stack.size());
+      memcpy(header->GetData(), stack.data(), stack.size());
+      groups.push_back({parts.size(), 1});
+      parts.emplace_back(std::move(header));
+      parts.emplace_back(transport->CreateMessage(64));
+    }
+    state.ResumeTiming();
+
+    if (batched) {
+      relayer.relay(parts.data(), groups);
+    } else {
+      for (auto& group : groups) {
+        relayer.relay(parts[group.firstPart], &parts[group.firstPart + 1], group.restOfPartsSize);
+      }
+    }
+    ready.clear();
+    relayer.getReadyToProcess(ready);
+    assert(ready.size() == 1);
+    auto result = relayer.getInputsForTimeslice(ready[0].slot);
+    assert(result.at(0).size() == nParts);
+  }
+  state.SetItemsProcessed(state.iterations() * nParts);
+}
+
+BENCHMARK(BM_RelayManySmallParts)->Args({1000, 0})->Args({1000, 1})->Args({10000, 0})->Args({10000, 1});
+
 BENCHMARK_MAIN();
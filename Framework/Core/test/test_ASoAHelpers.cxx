@@ -1348,3 +1348,61 @@ BOOST_AUTO_TEST_CASE(CombinationsHelpers)
   }
   BOOST_CHECK_EQUAL(count, expectedStrictlyUpperTriples.size());
 }
+
+BOOST_AUTO_TEST_CASE(BatchedColumnAccess)
+{
+  // Two chunks of 10 rows each
+  std::vector<std::shared_ptr<arrow::Table>> chunks;
+  for (int c = 0; c < 2; ++c) {
+    TableBuilder builder;
+    auto rowWriter = builder.persist<int32_t, float>({"x", "floatZ"});
+    for (int i = 0; i < 10; ++i) {
+      rowWriter(0, c * 10 + i, 0.5f * (c * 10 + i));
+    }
+    chunks.push_back(builder.finalize());
+  }
+  using TestA = o2::soa::Table<o2::soa::Index<>, test::X, test::FloatZ>;
+  TestA tests{ArrowHelpers::concatTables(std::move(chunks))};
+  BOOST_REQUIRE_EQUAL(tests.asArrowTable()->column(0)->num_chunks(), 2);
+
+  auto xs = materializeColumn<test::X>(tests);
+  BOOST_REQUIRE_EQUAL(xs.size(), 20);
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(xs.data()) % 64, 0);
+  for (int i = 0; i < 20; ++i) {
+    BOOST_CHECK_EQUAL(xs[i], i);
+  }
+
+  // Batches within a chunk point to the arrow buffers, the one across the
+  // chunk boundary is gathered.
+  std::vector<int64_t> firsts;
+  float sum = 0;
+  forEachBatch<test::X, test::FloatZ>(
+    tests, [&](int64_t first, int64_t n, int32_t const* x, float const* z) {
+      firsts.push_back(first);
+      for (int64_t i = 0; i < n; ++i) {
+        BOOST_CHECK_EQUAL(x[i], first + i);
+        sum += z[i];
+      }
+    },
+    8);
+  BOOST_CHECK_EQUAL(firsts.size(), 3);
+  BOOST_CHECK_EQUAL(firsts[2], 16);
+  BOOST_CHECK_CLOSE(sum, 95.f, 0.001);
+
+  expressions::Filter filter = test::x < 3 || test::x > 12;
+  auto filtered = Filtered<TestA>{{tests.asArrowTable()}, o2::framework::expressions::createSelection(tests.asArrowTable(), filter)};
+  auto fxs = materializeColumn<test::X>(filtered);
+  BOOST_REQUIRE_EQUAL(fxs.size(), filtered.size());
+  size_t ri = 0;
+  for (auto& row : filtered) {
+    BOOST_CHECK_EQUAL(fxs[ri++], row.x());
+  }
+
+  std::vector<int32_t> seen;
+  forEachBatch<test::X>(
+    filtered, [&](int64_t, int64_t n, int32_t const* x) {
+      seen.insert(seen.end(), x, x + n);
+    },
+    4);
+  BOOST_CHECK(std::vector<int32_t>(fxs.begin(), fxs.end()) == seen);
+}
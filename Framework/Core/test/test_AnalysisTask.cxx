@@ -16,6 +16,7 @@
 #include "TestClasses.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
+#include "../src/WorkflowHelpers.h"
 
 #include <boost/test/unit_test.hpp>
 
@@ -184,6 +185,52 @@ BOOST_AUTO_TEST_CASE(AdaptorCompilation)
   auto task10 = adaptAnalysisTask<JTask>(*cfgc, TaskName{"test10"});
 }
 
+BOOST_AUTO_TEST_CASE(TestColumnProjection)
+{
+  auto cfgc = makeEmptyConfigContext();
+
+  auto projection = [](InputSpec const& input) {
+    std::vector<std::string> columns;
+    for (auto& param : input.metadata) {
+      if (param.name.rfind("projection:", 0) == 0) {
+        columns.push_back(param.name.substr(std::string{"projection:"}.size()));
+      }
+    }
+    return columns;
+  };
+
+  // Only the persistent columns are requested, the dynamic one is computed
+  auto task5 = adaptAnalysisTask<ETask>(*cfgc, TaskName{"test5"});
+  BOOST_REQUIRE_EQUAL(task5.inputs.size(), 1);
+  auto columns = projection(task5.inputs[0]);
+  BOOST_REQUIRE_EQUAL(columns.size(), 2);
+  BOOST_CHECK_EQUAL(columns[0], "fFoo");
+  BOOST_CHECK_EQUAL(columns[1], "fBar");
+
+  // Each table of a join requests its own columns
+  auto task7 = adaptAnalysisTask<GTask>(*cfgc, TaskName{"test7"});
+  BOOST_REQUIRE_EQUAL(task7.inputs.size(), 3);
+  for (auto& input : task7.inputs) {
+    if (input.binding == "XYZ") {
+      BOOST_CHECK_EQUAL(projection(input).size(), 3);
+    } else {
+      BOOST_CHECK_EQUAL(projection(input).size(), 1);
+    }
+  }
+
+  // The reader is asked for the union of the columns of the consumers, so
+  // that a branch which is not a column of the table is never read.
+  std::vector<InputSpec> requested{task5.inputs[0]};
+  for (auto& input : task7.inputs) {
+    requested.push_back(input);
+  }
+  BOOST_CHECK_EQUAL(WorkflowHelpers::aodColumnsToRead(requested), "AOD/BAR:fBar;AOD/FOO:fFoo;AOD/FOOBAR:fBar,fFoo;AOD/XYZ:fX,fY,fZ");
+
+  // A consumer which does not declare its columns reads the whole table
+  requested.push_back(InputSpec{"FooBars", "AOD", "FOOBAR"});
+  BOOST_CHECK_EQUAL(WorkflowHelpers::aodColumnsToRead(requested), "AOD/BAR:fBar;AOD/FOO:fFoo;AOD/XYZ:fX,fY,fZ");
+}
+
 BOOST_AUTO_TEST_CASE(TestPartitionIteration)
 {
   TableBuilder builderA;
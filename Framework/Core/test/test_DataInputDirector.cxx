@@ -108,3 +108,20 @@ BOOST_AUTO_TEST_CASE(TestDatainputDirector)
   BOOST_CHECK(didesc);
   BOOST_CHECK_EQUAL(didesc->getNumberInputfiles(), 3);
 }
+
+BOOST_AUTO_TEST_CASE(TestColumnsToRead)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+
+  DataInputDirector didir;
+  didir.setColumnsToRead("AOD/TRACK:fX,fY;AOD/COLLISION:fPosZ");
+  auto columns = didir.getColumnsToRead(DataHeader(DataDescription{"TRACK"}, DataOrigin{"AOD"}, 0));
+  BOOST_REQUIRE_EQUAL(columns.size(), 2);
+  BOOST_CHECK_EQUAL(columns[0], "fX");
+  BOOST_CHECK_EQUAL(columns[1], "fY");
+  BOOST_CHECK_EQUAL(didir.getColumnsToRead(DataHeader(DataDescription{"COLLISION"}, DataOrigin{"AOD"}, 0)).size(), 1);
+  // Tables which are not listed are read in full
+  BOOST_CHECK(didir.getColumnsToRead(DataHeader(DataDescription{"BC"}, DataOrigin{"AOD"}, 0)).empty());
+  BOOST_CHECK(didir.getColumnsToRead(DataHeader(DataDescription{"TRACK"}, DataOrigin{"RN2"}, 0)).empty());
+}
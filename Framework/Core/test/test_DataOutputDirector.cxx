@@ -15,6 +15,9 @@
 #include <boost/test/unit_test.hpp>
 #include "Headers/DataHeader.h"
 #include "Framework/DataOutputDirector.h"
+#include <arrow/builder.h>
+#include <arrow/table.h>
+#include <filesystem>
 #include <fstream>
 
 BOOST_AUTO_TEST_CASE(TestDataOutputDirector)
@@ -125,3 +128,72 @@ BOOST_AUTO_TEST_CASE(TestDataOutputDirector)
   BOOST_CHECK_EQUAL(ds[1]->treename, std::string("due"));
   BOOST_CHECK_EQUAL(ds[1]->colnames.size(), 1);
 }
+
+BOOST_AUTO_TEST_CASE(TestArrowFormat)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+
+  auto makeTable = [](int first, int n) {
+    arrow::Int32Builder xs;
+    arrow::FloatBuilder ys;
+    for (int i = first; i < first + n; ++i) {
+      (void)xs.Append(i);
+      (void)ys.Append(0.5f * i);
+    }
+    auto schema = arrow::schema({arrow::field("fX", arrow::int32()), arrow::field("fY", arrow::float32())});
+    return arrow::Table::Make(schema, {xs.Finish().ValueOrDie(), ys.Finish().ValueOrDie()});
+  };
+
+  DataOutputDirector dod;
+  dod.readString("AOD/UNO/0:::arrowresults");
+  dod.setFormat("arrow");
+  dod.setCompression("lz4");
+  BOOST_CHECK_EQUAL(dod.getFormat(), std::string("arrow"));
+  dod.setFormat("parquet");
+  BOOST_CHECK_EQUAL(dod.getFormat(), std::string("root"));
+  dod.setFormat("arrow");
+
+  auto dh = DataHeader(DataDescription{"UNO"},
+                       DataOrigin{"AOD"},
+                       DataHeader::SubSpecificationType{0});
+  auto ds = dod.getDataOutputDescriptors(dh);
+  BOOST_REQUIRE_EQUAL(ds.size(), 1);
+  // three time frames merged in the first dataframe, one in the second. The
+  // last one arrives after the second dataframe was started
+  dod.writeArrowTable(ds[0], 1, makeTable(0, 10));
+  dod.writeArrowTable(ds[0], 1, makeTable(10, 5));
+  dod.writeArrowTable(ds[0], 2, makeTable(100, 3));
+  dod.writeArrowTable(ds[0], 1, makeTable(15, 4));
+  dod.closeDataFiles();
+
+  BOOST_REQUIRE(ArrowFileHelpers::isArrowDirectory("arrowresults.arrow"));
+  DataInputDirector didir("arrowresults.arrow");
+  BOOST_CHECK_EQUAL(didir.getTimeFramesInFile(dh, 0), 0);
+  auto table = didir.getDataTable(dh, 0, 0);
+  BOOST_REQUIRE(table != nullptr);
+  BOOST_CHECK_EQUAL(didir.getTimeFramesInFile(dh, 0), 2);
+  BOOST_CHECK_EQUAL(didir.getTimeFrameNumber(dh, 0, 1), 2);
+  BOOST_CHECK_EQUAL(table->num_rows(), 19);
+  BOOST_REQUIRE_EQUAL(table->num_columns(), 2);
+  auto xs = table->column(0);
+  int row = 0;
+  for (int chunk = 0; chunk < xs->num_chunks(); ++chunk) {
+    auto values = std::static_pointer_cast<arrow::Int32Array>(xs->chunk(chunk));
+    for (int i = 0; i < values->length(); ++i, ++row) {
+      BOOST_CHECK_EQUAL(values->Value(i), row);
+    }
+  }
+
+  // only the requested columns are read
+  didir.setColumnsToRead("AOD/UNO:fY");
+  table = didir.getDataTable(dh, 0, 1);
+  BOOST_REQUIRE(table != nullptr);
+  BOOST_CHECK_EQUAL(table->num_rows(), 3);
+  BOOST_REQUIRE_EQUAL(table->num_columns(), 1);
+  BOOST_CHECK_EQUAL(table->schema()->field(0)->name(), std::string("fY"));
+  BOOST_CHECK(didir.getDataTable(dh, 0, 2) == nullptr);
+  didir.closeInputFiles();
+
+  std::filesystem::remove_all("arrowresults.arrow");
+}
@@ -593,3 +593,189 @@ BOOST_AUTO_TEST_CASE(SplitParts)
   BOOST_CHECK_NE(header2.get(), nullptr);
   BOOST_CHECK_NE(payload2.get(), nullptr);
 }
+
+// Relay a whole multipart message in one go.
+BOOST_AUTO_TEST_CASE(BatchedRelay)
+{
+  Monitoring metrics;
+  InputSpec spec1{"clusters", "TPC", "CLUSTERS"};
+  InputSpec spec2{"tracks", "TPC", "TRACKS"};
+
+  std::vector<InputRoute> inputs = {
+    InputRoute{spec1, 0, "Fake1", 0},
+    InputRoute{spec2, 1, "Fake2", 0}};
+
+  TimesliceIndex index{1};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(4);
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  std::vector<FairMQMessagePtr> parts;
+  std::vector<DataRelayer::PartsGroup> groups;
+  auto addPart = [&](const char* description, size_t timeslice) {
+    DataHeader dh;
+    dh.dataDescription = description;
+    dh.dataOrigin = "TPC";
+    dh.subSpecification = 0;
+    dh.splitPayloadIndex = 0;
+    dh.splitPayloadParts = 1;
+    DataProcessingHeader dph{timeslice, 1};
+    Stack stack{dh, dph};
+    FairMQMessagePtr header = transport->CreateMessage(stack.size());
+    memcpy(header->GetData(), stack.data(), stack.size());
+    groups.push_back({parts.size(), 1});
+    parts.emplace_back(std::move(header));
+    parts.emplace_back(transport->CreateMessage(100));
+  };
+  // Three parts of the same kind, which can reuse the matching of the first one,
+  // then the other input and a part of the next timeslice.
+  addPart("CLUSTERS", 0);
+  addPart("CLUSTERS", 0);
+  addPart("CLUSTERS", 0);
+  addPart("TRACKS", 0);
+  addPart("CLUSTERS", 1);
+
+  relayer.relay(parts.data(), groups);
+  for (auto& group : groups) {
+    BOOST_CHECK(group.choice == DataRelayer::WillRelay);
+  }
+  for (auto& part : parts) {
+    BOOST_CHECK_EQUAL(part.get(), nullptr);
+  }
+  BOOST_CHECK_EQUAL(relayer.getStats().relayedMessages, 5);
+
+  std::vector<RecordAction> ready;
+  relayer.getReadyToProcess(ready);
+  BOOST_REQUIRE_EQUAL(ready.size(), 1);
+  BOOST_CHECK_EQUAL(ready[0].op, CompletionPolicy::CompletionOp::Consume);
+  BOOST_CHECK_EQUAL(relayer.getTimesliceForSlot(ready[0].slot).value, 0);
+  auto result = relayer.getInputsForTimeslice(ready[0].slot);
+  BOOST_REQUIRE_EQUAL(result.size(), 2);
+  BOOST_CHECK_EQUAL(result.at(0).size(), 3);
+  BOOST_CHECK_EQUAL(result.at(1).size(), 1);
+}
+
+// When more than one slot matches an incoming message, the first one wins,
+// whichever slot got the previous message.
+BOOST_AUTO_TEST_CASE(TestFirstMatchingSlot)
+{
+  Monitoring metrics;
+  InputSpec spec1{"clusters", "TPC", "CLUSTERS"};
+  InputSpec spec2{"tracks", "TPC", "TRACKS"};
+
+  std::vector<InputRoute> inputs = {
+    InputRoute{spec1, 0, "Fake1", 0},
+    InputRoute{spec2, 1, "Fake2", 0}};
+
+  TimesliceIndex index{1};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(2);
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  auto createMessage = [&transport, &relayer](const char* description, size_t timeslice) {
+    DataHeader dh;
+    dh.dataDescription = description;
+    dh.dataOrigin = "TPC";
+    dh.subSpecification = 0;
+    dh.splitPayloadIndex = 0;
+    dh.splitPayloadParts = 1;
+    DataProcessingHeader dph{timeslice, 1};
+    Stack stack{dh, dph};
+    FairMQMessagePtr header = transport->CreateMessage(stack.size());
+    FairMQMessagePtr payload = transport->CreateMessage(100);
+    memcpy(header->GetData(), stack.data(), stack.size());
+    BOOST_CHECK(relayer.relay(header, payload) == DataRelayer::WillRelay);
+  };
+
+  createMessage("CLUSTERS", 0);
+  createMessage("CLUSTERS", 1);
+  std::vector<RecordAction> ready;
+  relayer.getReadyToProcess(ready);
+  BOOST_REQUIRE_EQUAL(ready.size(), 0);
+
+  // Make the second slot, which got the last message, match timeslice 0 as well.
+  index.associate(TimesliceId{0}, TimesliceSlot{1});
+  BOOST_CHECK_EQUAL(relayer.getTimesliceForSlot(TimesliceSlot{0}).value, 0);
+  BOOST_CHECK_EQUAL(relayer.getTimesliceForSlot(TimesliceSlot{1}).value, 0);
+
+  createMessage("TRACKS", 0);
+  ready.clear();
+  relayer.getReadyToProcess(ready);
+  BOOST_REQUIRE_EQUAL(ready.size(), 1);
+  BOOST_CHECK_EQUAL(ready[0].slot.index, 0);
+  BOOST_CHECK_EQUAL(ready[0].op, CompletionPolicy::CompletionOp::Consume);
+  auto result = relayer.getInputsForTimeslice(ready[0].slot);
+  BOOST_REQUIRE_EQUAL(result.size(), 2);
+  BOOST_CHECK_EQUAL(result.at(0).size(), 1);
+  BOOST_CHECK_EQUAL(result.at(1).size(), 1);
+}
+
+// Check that the dispatch table only gives the inputs which can match,
+// keeping the wildcards as candidates, in route order.
+BOOST_AUTO_TEST_CASE(TestInputMatcherIndex)
+{
+  InputSpec clusters{"clusters", "TPC", "CLUSTERS", 0};
+  InputSpec anyTPC{"any", {"TPC", "CLUSTERS"}};
+  InputSpec tracks{"tracks", "TPC", "TRACKS", 0};
+
+  std::vector<InputRoute> routes = {
+    InputRoute{clusters, 0, "Fake", 0},
+    InputRoute{clusters, 1, "Fake", 1},
+    InputRoute{anyTPC, 2, "Fake", 0},
+    InputRoute{tracks, 3, "Fake", 0}};
+
+  auto distinctRoutes = DataRelayerHelpers::createDistinctRouteIndex(routes);
+  BOOST_REQUIRE_EQUAL(distinctRoutes.size(), 3);
+  auto matcherIndex = DataRelayerHelpers::createInputMatcherIndex(routes, distinctRoutes);
+  BOOST_CHECK(matcherIndex.fallback == std::vector<size_t>{1});
+
+  DataHeader dh;
+  dh.dataOrigin = "TPC";
+  dh.dataDescription = "CLUSTERS";
+  dh.subSpecification = 0;
+  BOOST_CHECK((matcherIndex.candidates(&dh) == std::vector<size_t>{0, 1}));
+  dh.subSpecification = 1;
+  BOOST_CHECK(matcherIndex.candidates(&dh) == std::vector<size_t>{1});
+  dh.dataDescription = "TRACKS";
+  BOOST_CHECK(matcherIndex.candidates(&dh) == std::vector<size_t>{1});
+  dh.subSpecification = 0;
+  BOOST_CHECK((matcherIndex.candidates(&dh) == std::vector<size_t>{1, 2}));
+  BOOST_CHECK(matcherIndex.candidates(nullptr) == std::vector<size_t>{1});
+
+  // The wildcard still gets what the concrete input does not match.
+  Monitoring metrics;
+  TimesliceIndex index{1};
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, routes, metrics, index);
+  relayer.setPipelineLength(4);
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  auto relayWithSubSpec = [&](DataHeader::SubSpecificationType subSpec) {
+    DataHeader clustersHeader;
+    clustersHeader.dataOrigin = "TPC";
+    clustersHeader.dataDescription = "CLUSTERS";
+    clustersHeader.subSpecification = subSpec;
+    clustersHeader.splitPayloadIndex = 0;
+    clustersHeader.splitPayloadParts = 1;
+    DataProcessingHeader dph{0, 1};
+    Stack stack{clustersHeader, dph};
+    FairMQMessagePtr header = transport->CreateMessage(stack.size());
+    FairMQMessagePtr payload = transport->CreateMessage(100);
+    memcpy(header->GetData(), stack.data(), stack.size());
+    return relayer.relay(header, payload);
+  };
+  BOOST_CHECK(relayWithSubSpec(0) == DataRelayer::WillRelay);
+  BOOST_CHECK(relayWithSubSpec(7) == DataRelayer::WillRelay);
+
+  std::vector<RecordAction> ready;
+  relayer.getReadyToProcess(ready);
+  BOOST_REQUIRE_EQUAL(ready.size(), 1);
+  auto result = relayer.getInputsForTimeslice(ready[0].slot);
+  BOOST_REQUIRE_EQUAL(result.size(), 3);
+  BOOST_CHECK_EQUAL(result.at(0).size(), 1);
+  BOOST_CHECK_EQUAL(result.at(1).size(), 1);
+  BOOST_CHECK_EQUAL(result.at(2).size(), 0);
+}
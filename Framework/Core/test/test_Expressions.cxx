@@ -258,3 +258,34 @@ BOOST_AUTO_TEST_CASE(TestConditionalExpressions)
   BOOST_REQUIRE_EQUAL(gandiva_tree2->ToString(),
                       "bool greater_than((float) fSigned1Pt, (const float) 0 raw(0)) && if (bool less_than(float absf((float) fEta), (const float) 1 raw(3f800000)) && if (bool less_than((float) fPt, (const float) 1 raw(3f800000))) { bool greater_than((float) fRawPhi, (const float) 1.5708 raw(3fc90fdb)) } else { bool less_than((float) fRawPhi, (const float) 1.5708 raw(3fc90fdb)) }) { bool greater_than(float absf((float) fX), (const float) 1 raw(3f800000)) } else { bool greater_than(float absf((float) fY), (const float) 1 raw(3f800000)) }");
 }
+
+BOOST_AUTO_TEST_CASE(TestCompiledExpressionCache)
+{
+  Filter f1 = o2::aod::track::pt > 0.5f && nabs(o2::aod::track::eta) < 0.8f;
+  Filter f2 = o2::aod::track::pt > 0.5f && nabs(o2::aod::track::eta) < 0.8f;
+  Filter f3 = o2::aod::track::pt > 1.0f && nabs(o2::aod::track::eta) < 0.8f;
+  auto schema = std::make_shared<arrow::Schema>(std::vector{o2::aod::track::Pt::asArrowField(), o2::aod::track::Eta::asArrowField()});
+
+  auto before = getCompiledExpressionCacheStats();
+  auto gf1 = createFilter(schema, createOperations(f1));
+  auto gf2 = createFilter(schema, createOperations(f2));
+  auto gf3 = createFilter(schema, createOperations(f3));
+  auto after = getCompiledExpressionCacheStats();
+  // Identical expressions share the same compiled filter
+  BOOST_CHECK_EQUAL(gf1.get(), gf2.get());
+  BOOST_CHECK(gf1.get() != gf3.get());
+  BOOST_CHECK_EQUAL(after.hits - before.hits, 1);
+  BOOST_CHECK_EQUAL(after.misses - before.misses, 2);
+
+  // The same expression on a different schema is compiled separately
+  auto schema2 = std::make_shared<arrow::Schema>(std::vector{o2::aod::track::Eta::asArrowField(), o2::aod::track::Pt::asArrowField()});
+  auto gf4 = createFilter(schema2, createOperations(f1));
+  BOOST_CHECK(gf1.get() != gf4.get());
+
+  auto schema_p = o2::soa::createSchemaFromColumns(o2::aod::Tracks::persistent_columns_t{});
+  auto p1 = createProjectors(o2::framework::pack<o2::aod::track::Pt>{}, schema_p);
+  auto p2 = createProjectors(o2::framework::pack<o2::aod::track::Pt>{}, schema_p);
+  auto p3 = createProjectors(o2::framework::pack<o2::aod::track::Pt, o2::aod::track::P>{}, schema_p);
+  BOOST_CHECK_EQUAL(p1.get(), p2.get());
+  BOOST_CHECK(p1.get() != p3.get());
+}
@@ -416,6 +416,73 @@ BOOST_AUTO_TEST_CASE(GroupSlicerMismatchedUnsortedFilteredGroups)
   }
 }
 
+BOOST_AUTO_TEST_CASE(GroupSlicerSharedCache)
+{
+  TableBuilder builderE;
+  auto evtsWriter = builderE.cursor<aod::Events>();
+  for (auto i = 0; i < 20; ++i) {
+    evtsWriter(0, i, 0.5f * i, 2.f * i, 3.f * i);
+  }
+  auto evtTable = builderE.finalize();
+
+  TableBuilder builderT;
+  auto trksWriter = builderT.cursor<aod::TrksX>();
+  for (auto i = 0; i < 20; ++i) {
+    if (i == 3 || i == 10) {
+      continue;
+    }
+    for (auto j = 0.f; j < 5; j += 0.5f) {
+      trksWriter(0, i, 0.5f * j);
+    }
+  }
+  auto trkTable = builderT.finalize();
+
+  TableBuilder builderTU;
+  auto trksWriterU = builderTU.cursor<aod::TrksXU>();
+  std::vector<int> randomized{10, 2, 1, 0, 15, 3, 6, 4, 14, 5, 7, 9, 8, 19, 11, 13, 17, 12, 18, 16};
+  for (auto i : randomized) {
+    for (auto j = 0.f; j < 5; j += 0.5f) {
+      trksWriterU(0, i, 0.5f * j);
+    }
+  }
+  auto trkTableU = builderTU.finalize();
+
+  aod::Events e{evtTable};
+  GroupIndexCache cache;
+  // Two consumers of the same tables, e.g. two process functions
+  for (auto consumer = 0; consumer < 2; ++consumer) {
+    aod::TrksX t{trkTable};
+    std::vector<int64_t> sel(10 * 20);
+    std::iota(sel.begin(), sel.end(), 0);
+    soa::SmallGroups<aod::TrksXU> tu{{trkTableU}, std::move(sel)};
+    auto tt = std::make_tuple(t, tu);
+    o2::framework::AnalysisDataProcessorBuilder::GroupSlicer g(e, tt, &cache);
+
+    unsigned int count = 0;
+    for (auto& slice : g) {
+      auto as = slice.associatedTables();
+      auto gg = slice.groupingElement();
+      BOOST_CHECK_EQUAL(gg.globalIndex(), count);
+      auto trks = std::get<aod::TrksX>(as);
+      BOOST_CHECK_EQUAL(trks.size(), (count == 3 || count == 10) ? 0 : 10);
+      for (auto& trk : trks) {
+        BOOST_CHECK_EQUAL(trk.eventId(), count);
+      }
+      auto trksU = std::get<soa::SmallGroups<aod::TrksXU>>(as);
+      BOOST_CHECK_EQUAL(trksU.size(), 10);
+      for (auto& trk : trksU) {
+        BOOST_CHECK_EQUAL(trk.eventId(), count);
+      }
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 20);
+  }
+  BOOST_CHECK_EQUAL(cache.misses, 2);
+  BOOST_CHECK_EQUAL(cache.hits, 2);
+  cache.clear();
+  BOOST_CHECK(cache.sorted.empty() && cache.unsorted.empty());
+}
+
 BOOST_AUTO_TEST_CASE(EmptySliceables)
 {
   TableBuilder builderE;
@@ -0,0 +1,93 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Framework MessagePool
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "Framework/MessagePool.h"
+#include <vector>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestSizeClasses)
+{
+  BOOST_CHECK_EQUAL(MessagePool::sizeClassFor(1), 0);
+  BOOST_CHECK_EQUAL(MessagePool::sizeClassFor(256), 0);
+  BOOST_CHECK_EQUAL(MessagePool::sizeClassFor(257), 1);
+  BOOST_CHECK_EQUAL(MessagePool::sizeOfClass(1), 320);
+  BOOST_CHECK_EQUAL(MessagePool::sizeClassFor(512), 4);
+  BOOST_CHECK_EQUAL(MessagePool::sizeClassFor(513), 5);
+  BOOST_CHECK_EQUAL(MessagePool::sizeOfClass(5), 640);
+  for (size_t size = 1; size < (1 << 22); size = size * 3 / 2 + 1) {
+    auto sizeClass = MessagePool::sizeClassFor(size);
+    BOOST_CHECK(MessagePool::sizeOfClass(sizeClass) >= size);
+    BOOST_CHECK(sizeClass == 0 || MessagePool::sizeOfClass(sizeClass - 1) < size);
+    BOOST_CHECK_EQUAL(MessagePool::sizeOfClass(sizeClass) % 64, 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestReuseAcrossTimeslices)
+{
+  std::vector<char> region(1 << 20);
+  MessagePool pool(region.data(), region.size());
+
+  // The first timeslice only teaches the pool which sizes are needed.
+  BOOST_CHECK(pool.allocate(1000).data == nullptr);
+  BOOST_CHECK(pool.allocate(5000).data == nullptr);
+  BOOST_CHECK_EQUAL(pool.getStats().misses, 2);
+  BOOST_CHECK_EQUAL(pool.getHitRate(), 0.f);
+  pool.endOfTimeslice();
+
+  auto a = pool.allocate(1000);
+  auto b = pool.allocate(5000);
+  auto c = pool.allocate(1000);
+  BOOST_REQUIRE(a.data != nullptr && b.data != nullptr && c.data != nullptr);
+  BOOST_CHECK(a.data != c.data);
+  BOOST_CHECK(pool.allocate(70000).data == nullptr);
+  BOOST_CHECK_EQUAL(pool.getStats().hits, 3);
+  BOOST_CHECK_EQUAL(pool.getHitRate(), 0.75f);
+  BOOST_CHECK(pool.getFragmentation() > 0.f && pool.getFragmentation() < 0.25f);
+  auto carved = pool.getCarvedBytes();
+  pool.release(a);
+  pool.release(b);
+  pool.release(c);
+  BOOST_CHECK_EQUAL(pool.getIdleBytes(), carved);
+  pool.endOfTimeslice();
+
+  // Same sizes again: nothing new is carved, blocks are recycled.
+  auto d = pool.allocate(900);
+  auto e = pool.allocate(4500);
+  BOOST_CHECK(d.data == a.data || d.data == c.data);
+  BOOST_CHECK(e.data == b.data);
+  BOOST_CHECK(pool.allocate(70000).data != nullptr);
+  BOOST_CHECK_EQUAL(pool.getStats().misses, 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestExhaustion)
+{
+  std::vector<char> region(4096);
+  MessagePool pool(region.data(), region.size());
+  BOOST_CHECK(pool.allocate(2048).data == nullptr);
+  pool.allocate(1000);
+  pool.endOfTimeslice();
+  std::vector<MessagePool::Block> blocks;
+  for (int i = 0; i < 8; ++i) {
+    auto block = pool.allocate(1000);
+    if (block.data) {
+      blocks.push_back(block);
+    }
+  }
+  BOOST_CHECK_EQUAL(blocks.size(), 4);
+  BOOST_CHECK_EQUAL(pool.getStats().misses, 4);
+  BOOST_CHECK(pool.getCarvedBytes() <= pool.getSize());
+}
@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Framework ProcessingLanes
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "../src/ProcessingLanes.h"
+#include "Framework/ServiceRegistryHelpers.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace o2::framework;
+
+namespace
+{
+struct SharedService {
+  std::atomic<int> calls{0};
+};
+
+// Register @a service under the global (tid 0) key, which is the one looked
+// up by the threads which did not register the service themselves.
+template <typename T>
+void registerGlobalService(ServiceRegistry& registry, T* service)
+{
+  auto handle = ServiceRegistryHelpers::handleForService<T>(service);
+  registry.registerService(handle.hash, handle.instance, handle.kind, 0, handle.name.c_str());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestProcessingLanesRun)
+{
+  ServiceRegistry registry;
+  ProcessingLanes lanes(4, registry, FairMQDeviceProxy{nullptr}, {});
+  BOOST_REQUIRE_EQUAL(lanes.size(), 4);
+
+  for (size_t n = 0; n < 6; ++n) {
+    for (int iteration = 0; iteration < 50; ++iteration) {
+      std::vector<int> calls(lanes.size(), 0);
+      std::vector<std::thread::id> threads(lanes.size());
+      lanes.run(n, [&](size_t li) {
+        // Lanes which are slower to complete must still be waited for.
+        std::this_thread::sleep_for(std::chrono::microseconds(10 * (lanes.size() - li)));
+        calls[li]++;
+        threads[li] = std::this_thread::get_id();
+      });
+      // Every requested lane ran exactly once, on its own thread, and all of
+      // them completed before run() returned.
+      for (size_t li = 0; li < lanes.size(); ++li) {
+        BOOST_CHECK_EQUAL(calls[li], li < n ? 1 : 0);
+        if (li < n) {
+          BOOST_CHECK(threads[li] != std::this_thread::get_id());
+          for (size_t lj = 0; lj < li; ++lj) {
+            BOOST_CHECK(threads[li] != threads[lj]);
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestProcessingLanesErrors)
+{
+  ServiceRegistry registry;
+  ProcessingLanes lanes(4, registry, FairMQDeviceProxy{nullptr}, {});
+  std::vector<int> calls(lanes.size(), 0);
+  auto failing = [&calls](size_t li) {
+    calls[li]++;
+    if (li == 1 || li == 3) {
+      throw std::runtime_error("lane " + std::to_string(li));
+    }
+  };
+  // The exception of the lowest lane is rethrown once all of them are done.
+  try {
+    lanes.run(4, failing);
+    BOOST_FAIL("exception expected");
+  } catch (std::runtime_error const& e) {
+    BOOST_CHECK_EQUAL(std::string(e.what()), "lane 1");
+  }
+  for (auto c : calls) {
+    BOOST_CHECK_EQUAL(c, 1);
+  }
+  // Errors of previous runs are not rethrown.
+  BOOST_CHECK_NO_THROW(lanes.run(4, [](size_t) {}));
+  // Lanes which are not active in a run do not rethrow either.
+  BOOST_CHECK_NO_THROW(lanes.run(1, failing));
+}
+
+BOOST_AUTO_TEST_CASE(TestProcessingLanesServices)
+{
+  ServiceRegistry registry;
+  MessageContext messageContext{FairMQDeviceProxy{nullptr}};
+  GroupIndexCache groupIndexCache;
+  SharedService shared;
+  registerGlobalService(registry, &messageContext);
+  registerGlobalService(registry, &groupIndexCache);
+  registerGlobalService(registry, &shared);
+
+  ProcessingLanes lanes(3, registry, FairMQDeviceProxy{nullptr}, {});
+  std::vector<MessageContext*> laneMessageContexts(lanes.size());
+  std::vector<GroupIndexCache*> laneCaches(lanes.size());
+  lanes.run(lanes.size(), [&](size_t li) {
+    auto& laneRegistry = lanes[li].registry;
+    laneMessageContexts[li] = &laneRegistry.get<MessageContext>();
+    laneCaches[li] = &laneRegistry.get<GroupIndexCache>();
+    laneRegistry.get<SharedService>().calls++;
+  });
+  for (size_t li = 0; li < lanes.size(); ++li) {
+    // The lane local services are seen from the lane thread...
+    BOOST_CHECK(laneMessageContexts[li] == &lanes[li].messageContext);
+    BOOST_CHECK(laneCaches[li] == &lanes[li].groupIndexCache);
+    // ... and from the main thread.
+    BOOST_CHECK(&lanes[li].registry.get<MessageContext>() == &lanes[li].messageContext);
+  }
+  BOOST_CHECK_EQUAL(shared.calls.load(), 3);
+  // The main registry is left untouched.
+  BOOST_CHECK(&registry.get<MessageContext>() == &messageContext);
+  BOOST_CHECK(&registry.get<GroupIndexCache>() == &groupIndexCache);
+
+  // The grouping cached by a lane is dropped with the rest of its state.
+  lanes[0].groupIndexCache.sorted.emplace("key", GroupIndexCache::SortedGroups{});
+  lanes[0].clear();
+  BOOST_CHECK(lanes[0].groupIndexCache.sorted.empty());
+}
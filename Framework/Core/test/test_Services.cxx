@@ -184,3 +184,60 @@ BOOST_AUTO_TEST_CASE(TestServiceDeclaration)
   BOOST_CHECK(registry.active<CallbackService>() == true);
   BOOST_CHECK(registry.active<DummyService>() == false);
 }
+
+BOOST_AUTO_TEST_CASE(TestServiceRegistryCopyAndOverride)
+{
+  using namespace o2::framework;
+  struct OtherService {
+    int value;
+  };
+  struct LateService {
+    int value;
+  };
+  constexpr auto dummyHash = TypeIdHelpers::uniqueId<DummyService>();
+  constexpr auto otherHash = TypeIdHelpers::uniqueId<OtherService>();
+  constexpr auto lateHash = TypeIdHelpers::uniqueId<LateService>();
+  auto getDummy = [dummyHash](ServiceRegistry const& registry, uint64_t threadId) {
+    return reinterpret_cast<DummyService*>(registry.get(dummyHash, threadId, ServiceKind::Serial))->threadId;
+  };
+
+  ServiceRegistry registry;
+  DummyService original{0};
+  OtherService other{42};
+  registry.registerService(dummyHash, &original, ServiceKind::Serial, 0);
+  registry.registerService(otherHash, &other, ServiceKind::Serial, 0);
+  // Thread 1 gets its own entry, pointing to the same service
+  BOOST_CHECK_EQUAL(getDummy(registry, 1), 0);
+
+  ServiceRegistry copy{registry};
+  DummyService overridden{1};
+  copy.overrideService(dummyHash, &overridden);
+  // Override an unknown service, which must not create it
+  LateService late{7};
+  copy.overrideService(lateHash, &late);
+  BOOST_CHECK_EQUAL(copy.getPos(lateHash, 0), -1);
+
+  // All the entries of the copy are overridden, including the one of thread 1
+  // and those of threads which look up the service for the first time.
+  BOOST_CHECK_EQUAL(getDummy(copy, 0), 1);
+  BOOST_CHECK_EQUAL(getDummy(copy, 1), 1);
+  BOOST_CHECK_EQUAL(getDummy(copy, 2), 1);
+  // The other services are shared
+  BOOST_CHECK(copy.get(otherHash, 0, ServiceKind::Serial) == &other);
+  BOOST_CHECK(copy.get(otherHash, 3, ServiceKind::Serial) == &other);
+  // The original is untouched
+  BOOST_CHECK_EQUAL(getDummy(registry, 0), 0);
+  BOOST_CHECK_EQUAL(getDummy(registry, 1), 0);
+  BOOST_CHECK_EQUAL(getDummy(registry, 2), 0);
+
+  // Services registered in the copy are not visible in the original
+  copy.registerService(lateHash, &late, ServiceKind::Serial, 0);
+  BOOST_CHECK(copy.get(lateHash, 0, ServiceKind::Serial) == &late);
+  BOOST_CHECK_EQUAL(registry.getPos(lateHash, 0), -1);
+
+  // Assignment copies the overrides as well
+  ServiceRegistry assigned;
+  assigned = copy;
+  BOOST_CHECK_EQUAL(getDummy(assigned, 0), 1);
+  BOOST_CHECK(assigned.get(lateHash, 0, ServiceKind::Serial) == &late);
+}
@@ -17,6 +17,7 @@
 
 #include "Framework/Logger.h"
 #include "Framework/TableBuilder.h"
+#include "Framework/AnalysisHelpers.h"
 #include "Framework/TableConsumer.h"
 #include "Framework/DataAllocator.h"
 #include "Framework/OutputRoute.h"
@@ -344,6 +345,46 @@ BOOST_AUTO_TEST_CASE(TestSoAIntegration)
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestCursorBulkAppend)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.cursor<TestTable>();
+  rowWriter(0, 0, 0);
+  rowWriter(0, 10, 1);
+  // the rows cached by the cursor come before the bulk ones
+  std::vector<uint64_t> xs{20, 30, 40, 50};
+  std::vector<uint64_t> ys{2, 3, 4, 5};
+  builder.bulkAppend(TestTable::column_types{}, xs.size(), xs.data(), ys.data());
+  rowWriter(0, 60, 6);
+  auto table = builder.finalize();
+  BOOST_REQUIRE_EQUAL(table->num_rows(), 7);
+
+  size_t i = 0;
+  for (auto& row : TestTable{table}) {
+    BOOST_CHECK_EQUAL(row.x(), i * 10);
+    BOOST_CHECK_EQUAL(row.y(), i);
+    ++i;
+  }
+
+  TableBuilder arrayBuilder;
+  WritingCursor<ArrayTable> cursor;
+  cursor.resetCursor(arrayBuilder);
+  int a[4] = {1, 10, 300, 350};
+  cursor(a);
+  std::vector<int> flat{0, 20, 30, 40, 0, 11, 123, 256};
+  cursor.bulk(2, flat);
+  BOOST_CHECK_EQUAL(cursor.lastIndex(), 2);
+  BOOST_CHECK_THROW(cursor.bulk(3, flat), o2::framework::RuntimeErrorRef);
+  auto arrayTable = arrayBuilder.finalize();
+  BOOST_REQUIRE_EQUAL(arrayTable->num_rows(), 3);
+  auto row = ArrayTable{arrayTable}.begin();
+  BOOST_CHECK_EQUAL(row.pos()[3], 350);
+  row++;
+  BOOST_CHECK_EQUAL(row.pos()[1], 20);
+  row++;
+  BOOST_CHECK_EQUAL(row.pos()[3], 256);
+}
+
 BOOST_AUTO_TEST_CASE(TestDataAllocatorReturnType)
 {
   std::vector<OutputRoute> routes;
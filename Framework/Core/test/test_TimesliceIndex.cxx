@@ -99,3 +99,34 @@ BOOST_AUTO_TEST_CASE(TestLRUReplacement)
     BOOST_CHECK(action == TimesliceIndex::ActionTaken::Wait);
   }
 }
+
+BOOST_AUTO_TEST_CASE(TestDirtySlots)
+{
+  using namespace o2::framework;
+  TimesliceIndex index{1};
+  index.resize(10);
+  std::vector<TimesliceSlot> dirty;
+
+  index.extractDirtySlots(dirty);
+  BOOST_CHECK(dirty.empty());
+  index.associate(TimesliceId{10}, TimesliceSlot{3});
+  index.markAsDirty(TimesliceSlot{7}, true);
+  index.markAsDirty(TimesliceSlot{3}, true);
+  index.extractDirtySlots(dirty);
+  BOOST_REQUIRE_EQUAL(dirty.size(), 2);
+  BOOST_CHECK_EQUAL(dirty[0].index, 3);
+  BOOST_CHECK_EQUAL(dirty[1].index, 7);
+  // Extracting does not change the dirty state.
+  BOOST_CHECK(index.isDirty(TimesliceSlot{3}));
+  index.extractDirtySlots(dirty);
+  BOOST_CHECK(dirty.empty());
+  // Only a slot going from clean to dirty is reported again.
+  index.markAsDirty(TimesliceSlot{3}, true);
+  index.markAsDirty(TimesliceSlot{7}, false);
+  index.markAsDirty(TimesliceSlot{7}, true);
+  index.markAsDirty(TimesliceSlot{9}, true);
+  index.resize(8);
+  index.extractDirtySlots(dirty);
+  BOOST_REQUIRE_EQUAL(dirty.size(), 1);
+  BOOST_CHECK_EQUAL(dirty[0].index, 7);
+}
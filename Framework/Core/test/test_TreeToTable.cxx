@@ -17,6 +17,7 @@
 
 #include "Framework/CommonDataProcessors.h"
 #include "Framework/TableTreeHelpers.h"
+#include "Framework/DataInputDirector.h"
 #include "Framework/Logger.h"
 
 #include <TTree.h>
@@ -155,3 +156,39 @@ BOOST_AUTO_TEST_CASE(TreeToTableConversion)
 
   f2->Close();
 }
+
+BOOST_AUTO_TEST_CASE(TreeToTableColumnSelection)
+{
+  using namespace o2::framework;
+  using namespace o2::header;
+
+  TFile f("tree2tableselection.root", "RECREATE");
+  TTree t("O2foobar", "a tree with a branch which is not consumed");
+  Float_t foo, bar, extra;
+  t.Branch("fFoo", &foo, "fFoo/F");
+  t.Branch("fBar", &bar, "fBar/F");
+  t.Branch("fExtra", &extra, "fExtra/F");
+  for (int i = 0; i < 10; i++) {
+    foo = i;
+    bar = 2 * i;
+    extra = 3 * i;
+    t.Fill();
+  }
+  t.Write();
+
+  // The columns as they are passed to the reader by aod-reader-columns
+  DataInputDirector didir;
+  didir.setColumnsToRead("AOD/FOOBAR:fBar,fFoo");
+  TreeToTable tr2ta;
+  tr2ta.addAllColumns(&t, didir.getColumnsToRead(DataHeader(DataDescription{"FOOBAR"}, DataOrigin{"AOD"}, 0)));
+  tr2ta.fill(&t);
+  auto table = tr2ta.finalize();
+  f.Close();
+
+  BOOST_REQUIRE_EQUAL(table->Validate().ok(), true);
+  BOOST_REQUIRE_EQUAL(table->num_rows(), 10);
+  BOOST_REQUIRE_EQUAL(table->num_columns(), 2);
+  BOOST_CHECK(table->GetColumnByName("fFoo") != nullptr);
+  BOOST_CHECK(table->GetColumnByName("fBar") != nullptr);
+  BOOST_CHECK(table->GetColumnByName("fExtra") == nullptr);
+}
@@ -35,6 +35,8 @@ class DataSamplingConditionFactory
   // inside particular DataSamplingCondition*.cxx files.
   /// \brief Getter for DataSamplingConditionRandom
   static std::unique_ptr<DataSamplingCondition> createDataSamplingConditionRandom();
+  /// \brief Getter for DataSamplingConditionRandomHash
+  static std::unique_ptr<DataSamplingCondition> createDataSamplingConditionRandomHash();
   /// \brief Getter for DataSamplingConditionPayloadSize
   static std::unique_ptr<DataSamplingCondition> createDataSamplingConditionPayloadSize();
   /// \brief Getter for DataSamplingConditionNConsecutive
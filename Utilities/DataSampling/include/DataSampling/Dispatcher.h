@@ -20,7 +20,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
+#include "Framework/ConcreteDataMatcher.h"
 #include "Framework/DataProcessorSpec.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/Task.h"
@@ -69,11 +71,26 @@ class Dispatcher : public framework::Task
   void reportStats(monitoring::Monitoring& monitoring) const;
   void send(framework::DataAllocator& dataAllocator, const framework::DataRef& inputData, const framework::Output& output) const;
 
+  /// A policy which requires a given input, with the type of the output it should be sent to
+  struct Route {
+    DataSamplingPolicy* policy;
+    framework::ConcreteDataTypeMatcher output;
+  };
+  struct MatcherHash {
+    size_t operator()(const framework::ConcreteDataMatcher& matcher) const;
+  };
+  /// \brief Returns the routes of the policies which require data with given input header.
+  const std::vector<Route>& getRoutes(const framework::ConcreteDataMatcher& input);
+
   std::string mName;
   DataSamplingHeader::DeviceIDType mDeviceID = "invalid";
   std::string mReconfigurationSource;
   // policies should be shared between all pipeline threads
   std::vector<std::shared_ptr<DataSamplingPolicy>> mPolicies;
+  // The routes of each input seen so far, so that the policies are matched only once per input type.
+  // It has to be cleared whenever the policies change. Since it is filled by run(), as are the counters of the
+  // policies, the Dispatcher must not declare the "processing-threads" option.
+  std::unordered_map<framework::ConcreteDataMatcher, std::vector<Route>, MatcherHash> mRoutes;
 };
 
 } // namespace o2::utilities
@@ -0,0 +1,80 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DataSamplingConditionRandomHash.cxx
+/// \brief Implementation of a stateless random DataSamplingCondition
+
+#include "DataSampling/DataSamplingCondition.h"
+#include "DataSampling/DataSamplingConditionFactory.h"
+#include "Framework/DataProcessingHeader.h"
+
+#include <cassert>
+#include <limits>
+#include <random>
+
+#include <boost/property_tree/ptree.hpp>
+
+using namespace o2::framework;
+
+namespace o2::utilities
+{
+
+using namespace o2::header;
+
+/// \brief A DataSamplingCondition which makes random decisions from a hash of the TimesliceID and the seed.
+///
+/// Like DataSamplingConditionRandom, it takes the same decisions for the same seed on all the FLPs, but it does not
+/// keep any generator state, so that a decision costs the same whatever the order of the timeslices.
+class DataSamplingConditionRandomHash : public DataSamplingCondition
+{
+
+ public:
+  /// \brief Constructor.
+  DataSamplingConditionRandomHash() : DataSamplingCondition(), mThreshold(0), mSeed(0){};
+  /// \brief Default destructor
+  ~DataSamplingConditionRandomHash() override = default;
+
+  /// \brief Reads 'fraction' parameter (type double, between 0 and 1) and seed (int).
+  void configure(const boost::property_tree::ptree& config) override
+  {
+    mThreshold = static_cast<uint32_t>(config.get<double>("fraction") * std::numeric_limits<uint32_t>::max());
+
+    auto seed = config.get<uint64_t>("seed");
+    mSeed = (seed == 0) ? std::random_device()() : seed;
+  };
+  /// \brief Makes pseudo-random, deterministic decision based on TimesliceID.
+  bool decide(const o2::framework::DataRef& dataRef) override
+  {
+    const auto* dpHeader = get<DataProcessingHeader*>(dataRef.header);
+    assert(dpHeader);
+    return static_cast<uint32_t>(hash(mSeed + dpHeader->startTime) >> 32) < mThreshold;
+  }
+
+ private:
+  /// The finalizer of SplitMix64, which spreads consecutive inputs over the whole range.
+  static uint64_t hash(uint64_t x)
+  {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  uint32_t mThreshold;
+  uint64_t mSeed;
+};
+
+std::unique_ptr<DataSamplingCondition> DataSamplingConditionFactory::createDataSamplingConditionRandomHash()
+{
+  return std::make_unique<DataSamplingConditionRandomHash>();
+}
+
+} // namespace o2::utilities
@@ -70,6 +70,8 @@ void Dispatcher::init(InitContext& ctx)
     }
   }
 
+  mRoutes.clear();
+
   auto spec = ctx.services().get<const DeviceSpec>();
   mDeviceID.runtimeInit(spec.id.substr(0, DataSamplingHeader::deviceIDTypeSize).c_str());
 }
@@ -89,14 +91,13 @@ void Dispatcher::run(ProcessingContext& ctx)
     const auto* firstInputHeader = DataRefUtils::getHeader<header::DataHeader*>(firstPart);
     ConcreteDataMatcher inputMatcher{firstInputHeader->dataOrigin, firstInputHeader->dataDescription, firstInputHeader->subSpecification};
 
-    for (auto& policy : mPolicies) {
-      // fixme: in principle matching could be broken by having query "TST/RAWDATA/0" and having parts with just
-      //  the first subspec == 0, but others could be different. However, we trust that DPL does necessary checks
-      //  during workflow validation and when passing messages (e.g. query "TST/RAWDATA/0" should not match
-      //  a "TST/RAWDATA/*" output.
-      if (auto route = policy->match(inputMatcher); route != nullptr && policy->decide(firstPart)) {
-        auto routeAsConcreteDataType = DataSpecUtils::asConcreteDataTypeMatcher(*route);
-        auto dsheader = prepareDataSamplingHeader(*policy);
+    // fixme: in principle matching could be broken by having query "TST/RAWDATA/0" and having parts with just
+    //  the first subspec == 0, but others could be different. However, we trust that DPL does necessary checks
+    //  during workflow validation and when passing messages (e.g. query "TST/RAWDATA/0" should not match
+    //  a "TST/RAWDATA/*" output.
+    for (const auto& route : getRoutes(inputMatcher)) {
+      if (route.policy->decide(firstPart)) {
+        auto dsheader = prepareDataSamplingHeader(*route.policy);
         for (const auto& part : inputIt) {
           if (part.header != nullptr) {
             // We copy every header which is not DataHeader or DataProcessingHeader,
@@ -108,8 +109,8 @@ void Dispatcher::run(ProcessingContext& ctx)
             const auto* partInputHeader = DataRefUtils::getHeader<header::DataHeader*>(part);
 
             Output output{
-              routeAsConcreteDataType.origin,
-              routeAsConcreteDataType.description,
+              route.output.origin,
+              route.output.description,
               partInputHeader->subSpecification,
               part.spec->lifetime,
               std::move(headerStack)};
@@ -125,6 +126,30 @@ void Dispatcher::run(ProcessingContext& ctx)
   }
 }
 
+size_t Dispatcher::MatcherHash::operator()(const ConcreteDataMatcher& matcher) const
+{
+  size_t seed = std::hash<uint32_t>{}(matcher.origin.itg[0]);
+  for (auto value : {matcher.description.itg[0], matcher.description.itg[1], static_cast<uint64_t>(matcher.subSpec)}) {
+    seed ^= std::hash<uint64_t>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+const std::vector<Dispatcher::Route>& Dispatcher::getRoutes(const ConcreteDataMatcher& input)
+{
+  auto it = mRoutes.find(input);
+  if (it == mRoutes.end()) {
+    std::vector<Route> routes;
+    for (auto& policy : mPolicies) {
+      if (auto route = policy->match(input); route != nullptr) {
+        routes.push_back({policy.get(), DataSpecUtils::asConcreteDataTypeMatcher(*route)});
+      }
+    }
+    it = mRoutes.emplace(input, std::move(routes)).first;
+  }
+  return it->second;
+}
+
 void Dispatcher::reportStats(Monitoring& monitoring) const
 {
   uint64_t dispatcherTotalEvaluatedMessages = 0;
@@ -174,6 +199,7 @@ void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, co
 void Dispatcher::registerPolicy(std::unique_ptr<DataSamplingPolicy>&& policy)
 {
   mPolicies.emplace_back(std::move(policy));
+  mRoutes.clear();
 }
 
 const std::string& Dispatcher::getName()
@@ -73,6 +73,46 @@ BOOST_AUTO_TEST_CASE(DataSamplingConditionRandom)
   }
 }
 
+BOOST_AUTO_TEST_CASE(DataSamplingConditionRandomHash)
+{
+  auto conditionRandom = DataSamplingConditionFactory::create("randomHash");
+  BOOST_REQUIRE(conditionRandom);
+
+  boost::property_tree::ptree config;
+  config.put("fraction", "0.5");
+  config.put("seed", "943753948");
+  conditionRandom->configure(config);
+
+  auto decide = [&conditionRandom](DataProcessingHeader::StartTime id) {
+    DataProcessingHeader dph{id, 0};
+    o2::header::Stack headerStack{dph};
+    DataRef dr{nullptr, reinterpret_cast<const char*>(headerStack.data()), nullptr};
+    return conditionRandom->decide(dr);
+  };
+
+  // The decision depends only on the timeslice, whatever the order.
+  std::vector<bool> decisions;
+  size_t accepted = 0;
+  for (DataProcessingHeader::StartTime id = 0; id < 10000; id++) {
+    decisions.push_back(decide(id));
+    accepted += decisions.back();
+  }
+  BOOST_CHECK(accepted > 4500 && accepted < 5500);
+  for (DataProcessingHeader::StartTime id : {9999, 222, 222, 5000, 1, 7777}) {
+    BOOST_CHECK_EQUAL(decide(id), decisions[id]);
+  }
+
+  // Another instance with the same seed, e.g. on another FLP, takes the same decisions.
+  auto otherCondition = DataSamplingConditionFactory::create("randomHash");
+  otherCondition->configure(config);
+  for (DataProcessingHeader::StartTime id = 0; id < 100; id++) {
+    DataProcessingHeader dph{id, 0};
+    o2::header::Stack headerStack{dph};
+    DataRef dr{nullptr, reinterpret_cast<const char*>(headerStack.data()), nullptr};
+    BOOST_CHECK_EQUAL(otherCondition->decide(dr), decisions[id]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(DataSamplingConditionPayloadSize)
 {
   auto conditionPayloadSize = DataSamplingConditionFactory::create("payloadSize");
@@ -0,0 +1,118 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef ALICEO2_HISTOGRAMDELTA_H
+#define ALICEO2_HISTOGRAMDELTA_H
+
+/// \file HistogramDelta.h
+/// \brief Sparse, incrementally mergeable differences of a histogram
+
+#include "Mergers/MergeInterface.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class TH1;
+
+namespace o2::mergers
+{
+
+/// \brief The bins of a histogram which changed since the previous publication.
+///
+/// A producer which publishes the differences of a histogram
+/// (InputObjectsTimespan::LastDifference) usually changes only a small part of
+/// its bins between two publications. HistogramDelta carries only those, as
+/// pairs of global bin index and content difference, so that neither the
+/// message nor the merging scale with the total number of bins.
+///
+/// When used as the merging target, the object switches to a flat array with
+/// all the bins (including under- and overflows), to which the differences are
+/// added in place. No histogram object is created in the Mergers: it is up to
+/// the final consumer to apply the result to a TH1 with apply().
+///
+/// Only histograms with the same binning can be merged together, which is
+/// checked only with the number of bins. Profiles are not supported.
+class HistogramDelta : public MergeInterface
+{
+ public:
+  HistogramDelta() = default;
+  HistogramDelta(std::string name, int nBins) : MergeInterface(), mName(std::move(name)), mNBins(nBins) {}
+  ~HistogramDelta() override = default;
+
+  /// \brief Adds the differences of \a other to this object.
+  void merge(MergeInterface* const other) override;
+
+  /// \brief Adds a difference to the bin \a bin (a global bin number, as in TH1::GetBin()).
+  /// setHasSumw2() should be called before, if the errors are needed.
+  void add(int bin, double content, double sumw2 = 0);
+
+  /// \brief Adds all the bins and statistics to \a target, which should have the same binning.
+  void apply(TH1& target) const;
+
+  const std::string& getName() const { return mName; }
+  int getNBins() const { return mNBins; }
+  double getEntries() const { return mEntries; }
+  void setEntries(double entries) { mEntries = entries; }
+  /// \return the difference of the content of the bin \a bin
+  double getBinContent(int bin) const;
+  /// \return the number of bins which are kept, either sparse or in the flat array
+  size_t getNStoredBins() const { return isDense() ? mContents.size() : mIndices.size(); }
+  bool isDense() const { return !mContents.empty(); }
+  bool hasSumw2() const { return mHasSumw2; }
+  void setHasSumw2(bool hasSumw2) { mHasSumw2 = hasSumw2; }
+  const std::vector<double>& getStats() const { return mStats; }
+  void setStats(std::vector<double> stats) { mStats = std::move(stats); }
+
+ private:
+  /// Moves the sparse differences to the flat bin array
+  void densify();
+
+  std::string mName;
+  int mNBins = 0;
+  double mEntries = 0;
+  bool mHasSumw2 = false;
+  // The sparse differences
+  std::vector<int> mIndices;
+  std::vector<double> mValues;
+  std::vector<double> mSumw2Values;
+  // The flat bin arrays, used by the merging target
+  std::vector<double> mContents;
+  std::vector<double> mSumw2;
+  // The differences of the statistics as given by TH1::GetStats()
+  std::vector<double> mStats;
+
+  ClassDefOverride(HistogramDelta, 1);
+};
+
+/// \brief Produces the HistogramDeltas of a histogram, to be used on the producer side.
+///
+/// It keeps the bin contents of the previous call, so that each delta contains
+/// only the bins which changed since then. The histogram does not need to be
+/// reset between two publications.
+class HistogramDeltaEncoder
+{
+ public:
+  /// \return the bins of \a histogram which changed since the previous call
+  HistogramDelta encode(const TH1& histogram);
+  /// \brief Forgets the previous contents, so that the next delta contains all the non-empty bins.
+  void reset();
+
+ private:
+  std::vector<double> mContents;
+  std::vector<double> mSumw2;
+  std::vector<double> mStats;
+  double mEntries = 0;
+};
+
+} // namespace o2::mergers
+
+#endif //ALICEO2_HISTOGRAMDELTA_H
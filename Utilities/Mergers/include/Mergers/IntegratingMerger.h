@@ -24,6 +24,7 @@
 #include "Framework/Task.h"
 
 #include <memory>
+#include <vector>
 
 class TObject;
 
@@ -54,10 +55,13 @@ class IntegratingMerger : public framework::Task
  private:
   void publish(framework::DataAllocator& allocator);
   void clear();
+  /// Merges the received objects which are waiting for ParallelismType::TreeReduction
+  void mergePending();
 
  private:
   header::DataHeader::SubSpecificationType mSubSpec;
   ObjectStore mMergedObject = std::monostate{};
+  std::vector<std::vector<char>> mPendingPayloads;
   MergerConfig mConfig;
   std::unique_ptr<monitoring::Monitoring> mCollector;
   int mCyclesSinceReset = 0;
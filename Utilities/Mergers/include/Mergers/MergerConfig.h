@@ -46,6 +46,17 @@ enum class PublicationDecision {
   EachNSeconds,       // Merged object is published each N seconds.
 };
 
+enum class ParallelismType {
+  SingleThreaded, // Objects are deserialized and merged one after another.
+  TreeReduction   // Objects received during a cycle are kept serialized. Before each publication, they are deserialized
+                  // and merged pairwise by N threads, then merged into the merged object. It is worth it when a Merger
+                  // handles many inputs. Applies only to InputObjectsTimespan::LastDifference.
+                  // Trade-off: a copy of each payload is kept until the publication, since DPL releases the messages
+                  // after each processing call, and all the deserialization happens at once just before publishing,
+                  // which delays it. Deserializing on arrival would spread that work, but it would have to run on
+                  // the device thread, between the processing calls, which is what SingleThreaded already does.
+};
+
 enum class TopologySize {
   NumberOfLayers, // User specifies the number of layers in topology.
   ReductionFactor // User specifies how many sources should be handled by one merger (by maximum).
@@ -63,6 +74,7 @@ struct MergerConfig {
   ConfigEntry<MergedObjectTimespan, int> mergedObjectTimespan = {MergedObjectTimespan::FullHistory};
   ConfigEntry<PublicationDecision> publicationDecision = {PublicationDecision::EachNSeconds, 10};
   ConfigEntry<TopologySize, int> topologySize = {TopologySize::NumberOfLayers, 1};
+  ConfigEntry<ParallelismType, int> parallelismType = {ParallelismType::SingleThreaded, 1};
   std::string monitoringUrl = "infologger:///debug?qc";
   std::string detectorName;
 };
@@ -19,6 +19,8 @@
 
 #include <variant>
 #include <memory>
+#include <cstddef>
+#include <vector>
 #include "Framework/DataRef.h"
 
 class TObject;
@@ -38,6 +40,16 @@ namespace object_store_helpers
 /// \brief Takes a DataRef, deserializes it (if type is supported) and puts into an ObjectStore
 ObjectStore extractObjectFrom(const framework::DataRef& ref);
 
+/// \brief Deserializes a ROOT-serialized payload (if type is supported) and puts into an ObjectStore
+ObjectStore extractObjectFrom(const char* payload, size_t size);
+
+/// \brief Merges other into target. An empty target takes other over.
+void mergeInto(ObjectStore& target, ObjectStore&& other);
+
+/// \brief Deserializes ROOT-serialized payloads and merges them pairwise in a tree reduction with nThreads threads
+/// The result matches merging the payloads one after another, up to the order of floating point additions.
+ObjectStore reduceInParallel(const std::vector<std::vector<char>>& payloads, size_t nThreads);
+
 } // namespace object_store_helpers
 
 } // namespace o2::mergers
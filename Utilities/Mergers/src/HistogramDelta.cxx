@@ -0,0 +1,238 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file HistogramDelta.cxx
+/// \brief Implementation of HistogramDelta
+
+#include "Mergers/HistogramDelta.h"
+
+#include <TH1.h>
+#include <TArrayD.h>
+
+#include <stdexcept>
+#include <string_view>
+
+namespace o2::mergers
+{
+
+namespace
+{
+// The size of the array expected by TH1::GetStats(), enough for any dimension
+constexpr size_t NStats = TH1::kNstat;
+
+void checkSupported(const TH1& histogram)
+{
+  if (std::string_view(histogram.ClassName()).rfind("TProfile", 0) == 0) {
+    throw std::runtime_error(std::string("HistogramDelta does not support profiles, got '") + histogram.GetName() + "'");
+  }
+}
+} // namespace
+
+void HistogramDelta::merge(MergeInterface* const other)
+{
+  auto delta = dynamic_cast<const HistogramDelta* const>(other);
+  if (delta == nullptr) {
+    throw std::runtime_error("Object to be merged in '" + mName + "' is not a HistogramDelta");
+  }
+  if (delta->mNBins != mNBins) {
+    throw std::runtime_error("Cannot merge '" + delta->mName + "' with " + std::to_string(delta->mNBins) +
+                             " bins into '" + mName + "' with " + std::to_string(mNBins) + " bins");
+  }
+
+  // The target keeps all the bins, so that merging does not depend on how many
+  // differences were already integrated.
+  densify();
+  if (delta->mHasSumw2 && !mHasSumw2) {
+    // Without the sum of squares of weights, the errors are the contents.
+    mSumw2 = mContents;
+    mHasSumw2 = true;
+  }
+
+  if (delta->isDense()) {
+    for (int bin = 0; bin < mNBins; ++bin) {
+      mContents[bin] += delta->mContents[bin];
+    }
+    if (mHasSumw2) {
+      const auto& otherSumw2 = delta->mHasSumw2 ? delta->mSumw2 : delta->mContents;
+      for (int bin = 0; bin < mNBins; ++bin) {
+        mSumw2[bin] += otherSumw2[bin];
+      }
+    }
+  } else {
+    for (size_t i = 0; i < delta->mIndices.size(); ++i) {
+      add(delta->mIndices[i], delta->mValues[i], delta->mHasSumw2 ? delta->mSumw2Values[i] : delta->mValues[i]);
+    }
+  }
+
+  mEntries += delta->mEntries;
+  if (mStats.size() < delta->mStats.size()) {
+    mStats.resize(delta->mStats.size(), 0);
+  }
+  for (size_t i = 0; i < delta->mStats.size(); ++i) {
+    mStats[i] += delta->mStats[i];
+  }
+}
+
+void HistogramDelta::add(int bin, double content, double sumw2)
+{
+  if (bin < 0 || bin >= mNBins) {
+    throw std::runtime_error("Bin " + std::to_string(bin) + " is out of range for '" + mName + "'");
+  }
+  if (isDense()) {
+    mContents[bin] += content;
+    if (mHasSumw2) {
+      mSumw2[bin] += sumw2;
+    }
+  } else {
+    mIndices.push_back(bin);
+    mValues.push_back(content);
+    if (mHasSumw2) {
+      mSumw2Values.push_back(sumw2);
+    }
+  }
+}
+
+void HistogramDelta::densify()
+{
+  if (isDense() || mNBins == 0) {
+    return;
+  }
+  mContents.assign(mNBins, 0);
+  if (mHasSumw2) {
+    mSumw2.assign(mNBins, 0);
+  }
+  for (size_t i = 0; i < mIndices.size(); ++i) {
+    mContents[mIndices[i]] += mValues[i];
+    if (mHasSumw2) {
+      mSumw2[mIndices[i]] += mSumw2Values[i];
+    }
+  }
+  mIndices = {};
+  mValues = {};
+  mSumw2Values = {};
+}
+
+double HistogramDelta::getBinContent(int bin) const
+{
+  if (isDense()) {
+    return bin >= 0 && bin < mNBins ? mContents[bin] : 0;
+  }
+  double content = 0;
+  for (size_t i = 0; i < mIndices.size(); ++i) {
+    if (mIndices[i] == bin) {
+      content += mValues[i];
+    }
+  }
+  return content;
+}
+
+void HistogramDelta::apply(TH1& target) const
+{
+  checkSupported(target);
+  if (target.GetNcells() != mNBins) {
+    throw std::runtime_error("Cannot apply '" + mName + "' with " + std::to_string(mNBins) + " bins to '" +
+                             target.GetName() + "' with " + std::to_string(target.GetNcells()) + " bins");
+  }
+  if (mHasSumw2 && target.GetSumw2N() == 0) {
+    target.Sumw2();
+  }
+  // The statistics are taken before touching the bins, as TH1::GetStats()
+  // might recompute them from the bin contents.
+  double stats[NStats] = {0};
+  target.GetStats(stats);
+  double entries = target.GetEntries();
+
+  // AddBinContent() does not update the statistics, which are set below.
+  TArrayD* targetSumw2 = target.GetSumw2N() ? target.GetSumw2() : nullptr;
+  auto addBin = [&](int bin, double content, double sumw2) {
+    target.AddBinContent(bin, content);
+    if (targetSumw2) {
+      (*targetSumw2)[bin] += sumw2;
+    }
+  };
+  if (isDense()) {
+    for (int bin = 0; bin < mNBins; ++bin) {
+      addBin(bin, mContents[bin], mHasSumw2 ? mSumw2[bin] : mContents[bin]);
+    }
+  } else {
+    for (size_t i = 0; i < mIndices.size(); ++i) {
+      addBin(mIndices[i], mValues[i], mHasSumw2 ? mSumw2Values[i] : mValues[i]);
+    }
+  }
+
+  for (size_t i = 0; i < mStats.size() && i < NStats; ++i) {
+    stats[i] += mStats[i];
+  }
+  target.PutStats(stats);
+  target.SetEntries(entries + mEntries);
+}
+
+HistogramDelta HistogramDeltaEncoder::encode(const TH1& histogram)
+{
+  checkSupported(histogram);
+  const int nBins = histogram.GetNcells();
+  const bool hasSumw2 = histogram.GetSumw2N() > 0;
+  const TArrayD* sumw2 = hasSumw2 ? histogram.GetSumw2() : nullptr;
+  if (mContents.size() != static_cast<size_t>(nBins)) {
+    // First call or a different binning: everything is new.
+    reset();
+    mContents.assign(nBins, 0);
+  }
+  if (hasSumw2 && mSumw2.size() != static_cast<size_t>(nBins)) {
+    // Without the sum of squares of weights, the errors were the contents.
+    mSumw2 = mContents;
+  }
+
+  HistogramDelta delta(histogram.GetName(), nBins);
+  delta.setHasSumw2(hasSumw2);
+  for (int bin = 0; bin < nBins; ++bin) {
+    double content = histogram.GetBinContent(bin);
+    double contentDiff = content - mContents[bin];
+    double sumw2Diff = 0;
+    if (hasSumw2) {
+      sumw2Diff = sumw2->At(bin) - mSumw2[bin];
+      mSumw2[bin] = sumw2->At(bin);
+    }
+    if (contentDiff != 0 || sumw2Diff != 0) {
+      delta.add(bin, contentDiff, sumw2Diff);
+      mContents[bin] = content;
+    }
+  }
+  if (!hasSumw2) {
+    mSumw2.clear();
+  }
+
+  std::vector<double> stats(NStats, 0);
+  histogram.GetStats(stats.data());
+  if (mStats.size() != NStats) {
+    mStats.assign(NStats, 0);
+  }
+  std::vector<double> statsDiff(NStats);
+  for (size_t i = 0; i < NStats; ++i) {
+    statsDiff[i] = stats[i] - mStats[i];
+  }
+  delta.setStats(std::move(statsDiff));
+  mStats = std::move(stats);
+
+  delta.setEntries(histogram.GetEntries() - mEntries);
+  mEntries = histogram.GetEntries();
+  return delta;
+}
+
+void HistogramDeltaEncoder::reset()
+{
+  mContents.clear();
+  mSumw2.clear();
+  mStats.clear();
+  mEntries = 0;
+}
+
+} // namespace o2::mergers
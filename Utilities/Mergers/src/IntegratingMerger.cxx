@@ -23,9 +23,12 @@
 
 #include <Monitoring/MonitoringFactory.h>
 
+#include "Framework/DataRefUtils.h"
 #include "Framework/InputRecordWalker.h"
 #include "Framework/Logger.h"
 
+#include <TROOT.h>
+
 using namespace o2::framework;
 
 namespace o2::mergers
@@ -51,6 +54,12 @@ void IntegratingMerger::init(framework::InitContext& ictx)
     LOG(WARN) << "Could not find the DPL InfoLogger Context.";
   }
   ilContext->setField(AliceO2::InfoLogger::InfoLoggerContext::FieldName::Detector, mConfig.detectorName);
+
+  if (mConfig.parallelismType.value == ParallelismType::TreeReduction && mConfig.parallelismType.param > 1) {
+    // Objects are deserialized and merged in several threads.
+    ROOT::EnableThreadSafety();
+    LOG(INFO) << "Merging the received objects with " << mConfig.parallelismType.param << " threads";
+  }
 }
 
 void IntegratingMerger::run(framework::ProcessingContext& ctx)
@@ -58,29 +67,26 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
   // we have to avoid mistaking the timer input with data inputs.
   auto* timerHeader = ctx.inputs().get("timer-publish").header;
 
+  const bool parallel = mConfig.parallelismType.value == ParallelismType::TreeReduction && mConfig.parallelismType.param > 1;
   for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
     if (ref.header != timerHeader) {
-      auto other = object_store_helpers::extractObjectFrom(ref);
-      if (std::holds_alternative<std::monostate>(mMergedObject)) {
-        mMergedObject = std::move(object_store_helpers::extractObjectFrom(ref));
-      } else if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
-        // We expect that if the first object was TObject, then all should.
-        auto targetAsTObject = std::get<TObjectPtr>(mMergedObject);
-        auto otherAsTObject = std::get<TObjectPtr>(other);
-        algorithm::merge(targetAsTObject.get(), otherAsTObject.get());
-
-      } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
-        // We expect that if the first object inherited MergeInterface, then all should.
-        auto otherAsMergeInterface = std::get<MergeInterfacePtr>(other);
-        std::get<MergeInterfacePtr>(mMergedObject)->merge(otherAsMergeInterface.get());
+      if (parallel) {
+        // The device consumes the inputs one by one as they come, so they are kept until the publication,
+        // when they are deserialized and merged together.
+        auto dataHeader = DataRefUtils::getHeader<const header::DataHeader*>(ref);
+        if (dataHeader->payloadSerializationMethod != header::gSerializationMethodROOT) {
+          throw std::runtime_error("Could not extract object to be merged: It is not ROOT-serialized");
+        }
+        mPendingPayloads.emplace_back(ref.payload, ref.payload + dataHeader->payloadSize);
       } else {
-        throw std::runtime_error("mMergedObject' variant has no value.");
+        object_store_helpers::mergeInto(mMergedObject, object_store_helpers::extractObjectFrom(ref));
+        mDeltasMerged++;
       }
-      mDeltasMerged++;
     }
   }
 
   if (ctx.inputs().isValid("timer-publish")) {
+    mergePending();
     mCyclesSinceReset++;
     publish(ctx.outputs());
 
@@ -91,10 +97,21 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
   }
 }
 
+void IntegratingMerger::mergePending()
+{
+  if (mPendingPayloads.empty()) {
+    return;
+  }
+  object_store_helpers::mergeInto(mMergedObject, object_store_helpers::reduceInParallel(mPendingPayloads, mConfig.parallelismType.param));
+  mDeltasMerged += mPendingPayloads.size();
+  mPendingPayloads.clear();
+}
+
 // I am not calling it reset(), because it does not have to be performed during the FairMQs reset.
 void IntegratingMerger::clear()
 {
   mMergedObject = std::monostate{};
+  mPendingPayloads.clear();
   mCyclesSinceReset = 0;
   mTotalDeltasMerged = 0;
   mDeltasMerged = 0;
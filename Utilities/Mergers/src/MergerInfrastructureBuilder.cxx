@@ -70,6 +70,10 @@ std::string MergerInfrastructureBuilder::validateConfig()
     error += preamble + "reduction factor smaller than 2 (" + std::to_string(mConfig.topologySize.param) + ")\n";
   }
 
+  if (mConfig.parallelismType.value == ParallelismType::TreeReduction && mConfig.parallelismType.param < 1) {
+    error += preamble + "number of threads less than 1 (" + std::to_string(mConfig.parallelismType.param) + ")\n";
+  }
+
   if (mConfig.inputObjectTimespan.value == InputObjectsTimespan::FullHistory && mConfig.mergedObjectTimespan.value == MergedObjectTimespan::LastDifference) {
     error += preamble + "MergedObjectTimespan::LastDifference does not apply to InputObjectsTimespan::FullHistory\n";
   }
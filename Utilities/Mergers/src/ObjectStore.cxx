@@ -20,6 +20,9 @@
 #include "Mergers/MergerAlgorithm.h"
 #include <TObject.h>
 
+#include <algorithm>
+#include <future>
+
 namespace o2::mergers
 {
 
@@ -42,7 +45,14 @@ ObjectStore extractObjectFrom(const framework::DataRef& ref)
     throw std::runtime_error(errorPrefix + "It is not ROOT-serialized");
   }
 
-  o2::framework::FairTMessage ftm(const_cast<char*>(ref.payload), header->payloadSize);
+  return extractObjectFrom(ref.payload, header->payloadSize);
+}
+
+ObjectStore extractObjectFrom(const char* payload, size_t size)
+{
+  const static std::string errorPrefix = "Could not extract object to be merged: ";
+
+  o2::framework::FairTMessage ftm(const_cast<char*>(payload), size);
   auto* storedClass = ftm.GetClass();
   if (storedClass == nullptr) {
     throw std::runtime_error(errorPrefix + "Unknown stored class");
@@ -77,6 +87,75 @@ ObjectStore extractObjectFrom(const framework::DataRef& ref)
   }
 }
 
+namespace
+{
+
+// Calls function(i) for each i in [0, n), split in contiguous ranges among at most nThreads threads.
+template <typename F>
+void parallelFor(size_t n, size_t nThreads, F&& function)
+{
+  nThreads = std::min(n, nThreads);
+  if (nThreads <= 1) {
+    for (size_t i = 0; i < n; i++) {
+      function(i);
+    }
+    return;
+  }
+  std::vector<std::future<void>> futures;
+  const size_t chunk = (n + nThreads - 1) / nThreads;
+  for (size_t first = 0; first < n; first += chunk) {
+    const size_t last = std::min(n, first + chunk);
+    futures.push_back(std::async(std::launch::async, [&function, first, last]() {
+      for (size_t i = first; i < last; i++) {
+        function(i);
+      }
+    }));
+  }
+  // get() rethrows what was thrown in the thread
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+} // namespace
+
+void mergeInto(ObjectStore& target, ObjectStore&& other)
+{
+  if (std::holds_alternative<std::monostate>(target)) {
+    target = std::move(other);
+  } else if (std::holds_alternative<TObjectPtr>(target)) {
+    // We expect that if the first object was TObject, then all should.
+    auto targetAsTObject = std::get<TObjectPtr>(target);
+    auto otherAsTObject = std::get<TObjectPtr>(other);
+    algorithm::merge(targetAsTObject.get(), otherAsTObject.get());
+  } else if (std::holds_alternative<MergeInterfacePtr>(target)) {
+    // We expect that if the first object inherited MergeInterface, then all should.
+    auto otherAsMergeInterface = std::get<MergeInterfacePtr>(other);
+    std::get<MergeInterfacePtr>(target)->merge(otherAsMergeInterface.get());
+  } else {
+    throw std::runtime_error("mMergedObject' variant has no value.");
+  }
+}
+
+// In each step the object i*2*stride takes the object i*2*stride+stride, until
+// only the first one is left. The merges of a step do not share any object.
+ObjectStore reduceInParallel(const std::vector<std::vector<char>>& payloads, size_t nThreads)
+{
+  std::vector<ObjectStore> objects(payloads.size());
+  parallelFor(payloads.size(), nThreads, [&](size_t i) {
+    objects[i] = extractObjectFrom(payloads[i].data(), payloads[i].size());
+  });
+  for (size_t stride = 1; stride < objects.size(); stride *= 2) {
+    const size_t pairs = (objects.size() - stride + 2 * stride - 1) / (2 * stride);
+    parallelFor(pairs, nThreads, [&](size_t pair) {
+      const size_t i = pair * 2 * stride;
+      mergeInto(objects[i], std::move(objects[i + stride]));
+      objects[i + stride] = std::monostate{};
+    });
+  }
+  return objects.empty() ? ObjectStore{std::monostate{}} : std::move(objects[0]);
+}
+
 } // namespace object_store_helpers
 
 } // namespace o2::mergers
@@ -23,6 +23,7 @@
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/CustomMergeableTObject.h"
 #include "Mergers/CustomMergeableObject.h"
+#include "Mergers/HistogramDelta.h"
 
 #include <TObjArray.h>
 #include <TObjString.h>
@@ -329,3 +330,58 @@ BOOST_AUTO_TEST_CASE(Deleting)
   // I am afraid we can't check more than that.
   BOOST_CHECK_NO_THROW(algorithm::deleteTCollections(main));
 }
+
+BOOST_AUTO_TEST_CASE(MergerHistogramDelta)
+{
+  TH2F* producer1 = new TH2F("histo 2d", "histo 2d", bins, min, max, bins, min, max);
+  TH2F* producer2 = new TH2F("histo 2d", "histo 2d", bins, min, max, bins, min, max);
+  producer1->Sumw2();
+  HistogramDeltaEncoder encoder1;
+  HistogramDeltaEncoder encoder2;
+
+  producer1->Fill(1, 1);
+  producer1->Fill(5, 5, 2);
+  auto target = encoder1.encode(*producer1);
+  BOOST_CHECK_EQUAL(target.getNStoredBins(), 2);
+  BOOST_CHECK(!target.isDense());
+
+  producer2->Fill(5, 5);
+  producer2->Fill(-1, 3);
+  auto delta2 = encoder2.encode(*producer2);
+  BOOST_CHECK_EQUAL(delta2.getNStoredBins(), 2);
+  BOOST_CHECK(!delta2.hasSumw2());
+
+  // Only the bin which changed since the previous publication is sent
+  producer1->Fill(8, 2, 0.5);
+  auto delta1 = encoder1.encode(*producer1);
+  BOOST_CHECK_EQUAL(delta1.getNStoredBins(), 1);
+  BOOST_CHECK_EQUAL(delta1.getEntries(), 1);
+
+  target.merge(&delta2);
+  BOOST_CHECK(target.isDense());
+  target.merge(&delta1);
+  BOOST_CHECK_EQUAL(target.getBinContent(producer1->FindBin(5, 5)), 3);
+  BOOST_CHECK_EQUAL(target.getEntries(), 5);
+
+  TH2F* reference = dynamic_cast<TH2F*>(producer1->Clone("reference"));
+  reference->Add(producer2);
+  TH2F* result = new TH2F("result", "result", bins, min, max, bins, min, max);
+  target.apply(*result);
+  for (int bin = 0; bin < reference->GetNcells(); ++bin) {
+    BOOST_CHECK_CLOSE(result->GetBinContent(bin), reference->GetBinContent(bin), 0.001);
+    BOOST_CHECK_CLOSE(result->GetBinError(bin), reference->GetBinError(bin), 0.001);
+  }
+  BOOST_CHECK_EQUAL(result->GetEntries(), reference->GetEntries());
+  BOOST_CHECK_CLOSE(result->GetMean(1), reference->GetMean(1), 0.001);
+  BOOST_CHECK_CLOSE(result->GetMean(2), reference->GetMean(2), 0.001);
+
+  HistogramDelta other("other", 3);
+  BOOST_CHECK_THROW(target.merge(&other), std::runtime_error);
+  CustomMergeableObject custom;
+  BOOST_CHECK_THROW(target.merge(&custom), std::runtime_error);
+
+  delete producer1;
+  delete producer2;
+  delete reference;
+  delete result;
+}
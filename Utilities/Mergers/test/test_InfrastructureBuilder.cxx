@@ -73,6 +73,14 @@ BOOST_AUTO_TEST_CASE(InfrastructureBuilderLayers)
     BOOST_CHECK_THROW(builder.generateInfrastructure(), std::runtime_error);
   }
 
+  {
+    config.topologySize = {TopologySize::NumberOfLayers, 1};
+    config.parallelismType = {ParallelismType::TreeReduction, 0};
+    builder.setConfig(config);
+    BOOST_CHECK_THROW(builder.generateInfrastructure(), std::runtime_error);
+    config.parallelismType = {ParallelismType::SingleThreaded, 1};
+  }
+
   {
     config.topologySize = {TopologySize::NumberOfLayers, 1};
     builder.setConfig(config);
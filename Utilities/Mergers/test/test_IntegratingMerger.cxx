@@ -0,0 +1,134 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file test_IntegratingMerger.cxx
+/// \brief A unit test of the tree reduction used by IntegratingMerger
+
+#define BOOST_TEST_MODULE Test Utilities MergerIntegratingMerger
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "Mergers/ObjectStore.h"
+#include "Mergers/CustomMergeableObject.h"
+#include "Mergers/CustomMergeableTObject.h"
+
+#include <TH1F.h>
+#include <TMessage.h>
+#include <TROOT.h>
+
+#include <vector>
+
+using namespace o2::mergers;
+
+namespace
+{
+
+std::vector<char> serialize(const void* obj, const TClass* cl)
+{
+  TMessage tm(kMESS_OBJECT);
+  tm.WriteObjectAny(obj, cl);
+  return std::vector<char>(tm.Buffer(), tm.Buffer() + tm.BufferSize());
+}
+
+// The reference result: the objects deserialized and merged one after another.
+ObjectStore mergeSerially(const std::vector<std::vector<char>>& payloads)
+{
+  ObjectStore result = std::monostate{};
+  for (const auto& payload : payloads) {
+    object_store_helpers::mergeInto(result, object_store_helpers::extractObjectFrom(payload.data(), payload.size()));
+  }
+  return result;
+}
+
+const std::vector<size_t> objectCounts{1, 2, 5, 8};
+const std::vector<size_t> threadCounts{1, 4};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ReduceInParallelEmpty)
+{
+  for (auto threads : threadCounts) {
+    BOOST_CHECK(std::holds_alternative<std::monostate>(object_store_helpers::reduceInParallel({}, threads)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ReduceInParallelHistograms)
+{
+  ROOT::EnableThreadSafety();
+  TH1::AddDirectory(false);
+
+  for (auto n : objectCounts) {
+    std::vector<std::vector<char>> payloads;
+    for (size_t i = 0; i < n; i++) {
+      TH1F histo("histo", "histo", 100, 0, 100);
+      for (size_t entry = 0; entry <= i * 10; entry++) {
+        histo.Fill((i * 37 + entry * 13) % 100, i + 1);
+      }
+      payloads.push_back(serialize(&histo, histo.IsA()));
+    }
+
+    auto serial = mergeSerially(payloads);
+    BOOST_REQUIRE(std::holds_alternative<TObjectPtr>(serial));
+    auto* expected = dynamic_cast<TH1F*>(std::get<TObjectPtr>(serial).get());
+    BOOST_REQUIRE(expected != nullptr);
+
+    for (auto threads : threadCounts) {
+      auto reduced = object_store_helpers::reduceInParallel(payloads, threads);
+      BOOST_REQUIRE(std::holds_alternative<TObjectPtr>(reduced));
+      auto* result = dynamic_cast<TH1F*>(std::get<TObjectPtr>(reduced).get());
+      BOOST_REQUIRE(result != nullptr);
+      BOOST_CHECK_EQUAL(result->GetEntries(), expected->GetEntries());
+      for (int bin = 0; bin <= expected->GetNbinsX() + 1; bin++) {
+        BOOST_CHECK_EQUAL(result->GetBinContent(bin), expected->GetBinContent(bin));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ReduceInParallelCustomObjects)
+{
+  ROOT::EnableThreadSafety();
+
+  for (auto n : objectCounts) {
+    std::vector<std::vector<char>> payloads;
+    std::vector<std::vector<char>> payloadsTObject;
+    for (size_t i = 0; i < n; i++) {
+      CustomMergeableObject custom(i + 1);
+      payloads.push_back(serialize(&custom, TClass::GetClass(typeid(CustomMergeableObject))));
+      CustomMergeableTObject customTObject("custom", 10 * (i + 1));
+      payloadsTObject.push_back(serialize(&customTObject, customTObject.IsA()));
+    }
+
+    auto serial = mergeSerially(payloads);
+    auto serialTObject = mergeSerially(payloadsTObject);
+    BOOST_REQUIRE(std::holds_alternative<MergeInterfacePtr>(serial));
+    BOOST_REQUIRE(std::holds_alternative<MergeInterfacePtr>(serialTObject));
+    auto expected = dynamic_cast<CustomMergeableObject*>(std::get<MergeInterfacePtr>(serial).get())->getSecret();
+    auto expectedTObject = dynamic_cast<CustomMergeableTObject*>(std::get<MergeInterfacePtr>(serialTObject).get())->getSecret();
+    BOOST_CHECK_EQUAL(expected, static_cast<int>(n * (n + 1) / 2));
+
+    for (auto threads : threadCounts) {
+      auto reduced = object_store_helpers::reduceInParallel(payloads, threads);
+      BOOST_REQUIRE(std::holds_alternative<MergeInterfacePtr>(reduced));
+      auto* result = dynamic_cast<CustomMergeableObject*>(std::get<MergeInterfacePtr>(reduced).get());
+      BOOST_REQUIRE(result != nullptr);
+      BOOST_CHECK_EQUAL(result->getSecret(), expected);
+
+      auto reducedTObject = object_store_helpers::reduceInParallel(payloadsTObject, threads);
+      BOOST_REQUIRE(std::holds_alternative<MergeInterfacePtr>(reducedTObject));
+      auto* resultTObject = dynamic_cast<CustomMergeableTObject*>(std::get<MergeInterfacePtr>(reducedTObject).get());
+      BOOST_REQUIRE(resultTObject != nullptr);
+      BOOST_CHECK_EQUAL(resultTObject->getSecret(), expectedTObject);
+    }
+  }
+}
@@ -0,0 +1,143 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_ransInterleavedCoder.cxx
+/// @brief  compare the classic two stream literal coder with the N stream interleaved (SIMD) one
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include "rANS/rans.h"
+
+using source_t = uint16_t;
+using namespace o2::rans::internal;
+
+static constexpr size_t SymbolTablePrecision = 16;
+
+struct SourceMessage {
+  SourceMessage(size_t messageSize)
+  {
+    std::mt19937 mt(0);
+    std::normal_distribution<double> dist(1024, 64);
+    message.resize(messageSize);
+    for (auto& symbol : message) {
+      symbol = static_cast<source_t>(std::max(0., std::min(std::round(dist(mt)), 4095.)));
+    }
+    frequencies.addSamples(std::begin(message), std::end(message));
+  }
+
+  std::vector<source_t> message{};
+  o2::rans::FrequencyTable frequencies{};
+};
+
+static const SourceMessage& getSource()
+{
+  static SourceMessage source{1 << 24};
+  return source;
+}
+
+template <size_t nStreams_V>
+static void encode(const o2::rans::LiteralEncoder64<source_t>& encoder, const std::vector<source_t>& message, size_t messageSize,
+                   std::vector<uint32_t>& encodeBuffer, std::vector<source_t>& literals)
+{
+  literals.clear();
+  if constexpr (nStreams_V == 0) {
+    encoder.process(message.begin(), message.begin() + messageSize, encodeBuffer.begin(), literals);
+  } else {
+    encoder.processInterleaved<nStreams_V>(message.begin(), message.begin() + messageSize, encodeBuffer.begin(), literals);
+  }
+}
+
+// nStreams_V == 0 denotes the classic coder
+template <size_t nStreams_V, simd::InstructionSet set_V>
+static void BM_Encode(benchmark::State& state)
+{
+  const size_t messageSize = state.range(0);
+  const auto& source = getSource();
+  simd::setInstructionSet(set_V);
+  simd::simdEncoding() = set_V != simd::InstructionSet::Scalar;
+  const o2::rans::LiteralEncoder64<source_t> encoder{source.frequencies, SymbolTablePrecision};
+  std::vector<uint32_t> encodeBuffer(messageSize + 64);
+  std::vector<source_t> literals{};
+  literals.reserve(messageSize);
+
+  for (auto _ : state) {
+    encode<nStreams_V>(encoder, source.message, messageSize, encodeBuffer, literals);
+    benchmark::DoNotOptimize(encodeBuffer.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * messageSize * sizeof(source_t));
+  simd::setInstructionSet(simd::detectInstructionSet());
+  simd::simdEncoding() = false;
+}
+
+template <size_t nStreams_V, simd::InstructionSet set_V>
+static void BM_Decode(benchmark::State& state)
+{
+  const size_t messageSize = state.range(0);
+  const auto& source = getSource();
+  simd::setInstructionSet(set_V);
+  const o2::rans::LiteralEncoder64<source_t> encoder{source.frequencies, SymbolTablePrecision};
+  const o2::rans::LiteralDecoder64<source_t> decoder{source.frequencies, SymbolTablePrecision};
+  std::vector<uint32_t> encodeBuffer(messageSize + 64);
+  std::vector<source_t> literals{};
+  std::vector<source_t> decodeBuffer(messageSize);
+
+  literals.clear();
+  const auto encodedEnd = [&]() {
+    if constexpr (nStreams_V == 0) {
+      return encoder.process(source.message.begin(), source.message.begin() + messageSize, encodeBuffer.begin(), literals);
+    } else {
+      return encoder.processInterleaved<nStreams_V>(source.message.begin(), source.message.begin() + messageSize, encodeBuffer.begin(), literals);
+    }
+  }();
+
+  for (auto _ : state) {
+    auto literalsCopy = literals;
+    if constexpr (nStreams_V == 0) {
+      decoder.process(encodedEnd, decodeBuffer.begin(), messageSize, literalsCopy);
+    } else {
+      decoder.processInterleaved<nStreams_V>(encodedEnd, decodeBuffer.begin(), messageSize, literalsCopy);
+    }
+    benchmark::DoNotOptimize(decodeBuffer.data());
+  }
+  if (!std::equal(decodeBuffer.begin(), decodeBuffer.end(), source.message.begin())) {
+    state.SkipWithError("decoded message does not match source");
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * messageSize * sizeof(source_t));
+  simd::setInstructionSet(simd::detectInstructionSet());
+}
+
+using IS = simd::InstructionSet;
+
+BENCHMARK_TEMPLATE(BM_Encode, 0, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 4, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 4, IS::AVX2)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 8, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 8, IS::AVX2)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 8, IS::AVX512)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 16, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 16, IS::AVX2)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, 16, IS::AVX512)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+
+BENCHMARK_TEMPLATE(BM_Decode, 0, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 4, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 4, IS::AVX2)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 8, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 8, IS::AVX2)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 8, IS::AVX512)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 16, IS::Scalar)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 16, IS::AVX2)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, 16, IS::AVX512)->RangeMultiplier(8)->Range(1 << 12, 1 << 24);
+
+BENCHMARK_MAIN();
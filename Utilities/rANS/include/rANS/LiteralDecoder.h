@@ -32,6 +32,7 @@
 #include "rANS/internal/SymbolTable.h"
 #include "rANS/internal/Decoder.h"
 #include "rANS/internal/DecoderBase.h"
+#include "rANS/internal/InterleavedDecoder.h"
 
 namespace o2
 {
@@ -47,6 +48,10 @@ class LiteralDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
   template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const;
 
+  // decodes messages encoded by LiteralEncoder::processInterleaved with the same number of streams
+  template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  void processInterleaved(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const;
+
  private:
   using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
 };
@@ -105,6 +110,68 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
 
   LOG(trace) << "done decoding";
 }
+
+template <typename coder_T, typename stream_T, typename source_T>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+void LiteralDecoder<coder_T, stream_T, source_T>::processInterleaved(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const
+{
+  using namespace internal;
+  using interleavedCoder_t = InterleavedDecoder<coder_T, stream_T, nStreams_V>;
+  LOG(trace) << "start decoding";
+  RANSTimer t;
+  t.start();
+
+  if (messageLength == 0) {
+    LOG(warning) << "Empty message passed to decoder, skipping decode process";
+    return;
+  }
+
+  stream_IT inputIter = inputEnd;
+  source_IT it = outputBegin;
+
+  auto lookup = [&literals, this](const interleavedCoder_t& coder, size_t stream) {
+    const auto streamSymbol = (this->mReverseLUT)[coder.get(stream)];
+    const auto& decoderSymbol = (this->mSymbolTable)[streamSymbol];
+    source_T symbol = streamSymbol;
+    if (&decoderSymbol == &(this->mSymbolTable.getEscapeSymbol())) {
+      symbol = literals.back();
+      literals.pop_back();
+    }
+    return std::make_tuple(symbol, &decoderSymbol);
+  };
+
+  // make Iter point to the last last element
+  --inputIter;
+
+  interleavedCoder_t coder{this->mSymbolTablePrecission};
+  inputIter = coder.init(inputIter);
+
+  typename interleavedCoder_t::symbols_t symbols;
+  const size_t nFullGroups = messageLength / nStreams_V;
+  for (size_t group = 0; group < nFullGroups; ++group) {
+    for (size_t stream = 0; stream < nStreams_V; ++stream) {
+      const auto [symbol, decoderSymbol] = lookup(coder, stream);
+      *it++ = symbol;
+      symbols[stream] = decoderSymbol;
+    }
+    inputIter = coder.advanceSymbols(inputIter, symbols);
+  }
+
+  // incomplete group at the end of the message
+  for (size_t stream = 0; stream < messageLength % nStreams_V; ++stream) {
+    const auto [symbol, decoderSymbol] = lookup(coder, stream);
+    *it++ = symbol;
+    inputIter = coder.advanceSymbol(inputIter, *decoderSymbol, stream);
+  }
+  t.stop();
+  LOG(debug1) << "Decoder::" << __func__ << "<" << nStreams_V << "> { DecodedSymbols: " << messageLength << ","
+              << "processedBytes: " << messageLength * sizeof(source_T) << ","
+              << " inclusiveTimeMS: " << t.getDurationMS() << ","
+              << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (messageLength * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+
+  LOG(trace) << "done decoding";
+}
+
 } // namespace rans
 } // namespace o2
 
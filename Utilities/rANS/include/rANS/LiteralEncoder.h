@@ -25,6 +25,7 @@
 #include <stdexcept>
 
 #include "rANS/internal/EncoderBase.h"
+#include "rANS/internal/InterleavedEncoder.h"
 #include "rANS/internal/EncoderSymbol.h"
 #include "rANS/internal/helper.h"
 #include "rANS/internal/SymbolTable.h"
@@ -45,6 +46,11 @@ class LiteralEncoder : public internal::EncoderBase<coder_T, stream_T, source_T>
   template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
   stream_IT process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const;
 
+  // same as process, but using nStreams interleaved rANS states which are advanced in lock step (SIMD if available).
+  // The output is only decodable by LiteralDecoder::processInterleaved with the same nStreams.
+  template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
+  stream_IT processInterleaved(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const;
+
  private:
   using ransCoder_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::ransCoder_t;
 };
@@ -117,6 +123,63 @@ stream_IT LiteralEncoder<coder_T, stream_T, source_T>::process(source_IT inputBe
   return outputIter;
 };
 
+template <typename coder_T, typename stream_T, typename source_T>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
+stream_IT LiteralEncoder<coder_T, stream_T, source_T>::processInterleaved(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const
+{
+  using namespace internal;
+  using interleavedCoder_t = InterleavedEncoder<coder_T, stream_T, nStreams_V>;
+  LOG(trace) << "start encoding";
+  RANSTimer t;
+  t.start();
+
+  if (inputBegin == inputEnd) {
+    LOG(warning) << "passed empty message to encoder, skip encoding";
+    return outputBegin;
+  }
+
+  interleavedCoder_t coder{this->mSymbolTablePrecission};
+
+  stream_IT outputIter = outputBegin;
+  source_IT inputIT = inputEnd;
+
+  const auto inputBufferSize = std::distance(inputBegin, inputEnd);
+
+  auto lookup = [&literals, this](source_IT symbolIter) -> const auto& {
+    const source_T symbol = *symbolIter;
+    const auto& encoderSymbol = (this->mSymbolTable)[symbol];
+    if (&encoderSymbol == &(this->mSymbolTable.getEscapeSymbol())) {
+      literals.push_back(symbol);
+    }
+    return encoderSymbol;
+  };
+
+  // incomplete group at the end of the message, NB: working in reverse!
+  for (size_t stream = inputBufferSize % nStreams_V; stream-- > 0;) {
+    outputIter = coder.putSymbol(outputIter, lookup(--inputIT), stream);
+  }
+
+  typename interleavedCoder_t::symbols_t symbols;
+  while (inputIT != inputBegin) {
+    for (size_t stream = nStreams_V; stream-- > 0;) {
+      symbols[stream] = &lookup(--inputIT);
+    }
+    outputIter = coder.putSymbols(outputIter, symbols);
+  }
+  outputIter = coder.flush(outputIter);
+  // first iterator past the range so that sizes, distances and iterators work correctly.
+  ++outputIter;
+
+  t.stop();
+  LOG(debug1) << "Encoder::" << __func__ << "<" << nStreams_V << "> {ProcessedBytes: " << inputBufferSize * sizeof(source_T) << ","
+              << " inclusiveTimeMS: " << t.getDurationMS() << ","
+              << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (inputBufferSize * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+
+  LOG(trace) << "done encoding";
+
+  return outputIter;
+};
+
 } // namespace rans
 } // namespace o2
 
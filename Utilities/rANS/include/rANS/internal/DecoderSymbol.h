@@ -17,6 +17,7 @@
 #ifndef RANS_INTERNAL_DECODERSYMBOL_H
 #define RANS_INTERNAL_DECODERSYMBOL_H
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <cassert>
@@ -47,6 +48,10 @@ class DecoderSymbol
   inline constexpr count_t getFrequency() const noexcept { return mFrequency; };
   inline constexpr count_t getCumulative() const noexcept { return mCumulative; };
 
+  // member offsets in bytes, needed to gather symbols into SIMD registers
+  static constexpr size_t getFrequencyOffset() noexcept { return offsetof(DecoderSymbol, mFrequency); };
+  static constexpr size_t getCumulativeOffset() noexcept { return offsetof(DecoderSymbol, mCumulative); };
+
  private:
   count_t mCumulative{}; // Start of range.
   count_t mFrequency{};  // Symbol frequency.
@@ -17,6 +17,7 @@
 #ifndef RANS_INTERNAL_ENCODERSYMBOL_H
 #define RANS_INTERNAL_ENCODERSYMBOL_H
 
+#include <cstddef>
 #include <cstdint>
 #include <cassert>
 
@@ -131,6 +132,13 @@ class EncoderSymbol
   inline constexpr count_t getFrequencyComplement() const noexcept { return mFrequencyComplement; };
   inline constexpr count_t getReciprocalShift() const noexcept { return mReciprocalShift; };
 
+  // member offsets in bytes, needed to gather symbols into SIMD registers
+  static constexpr size_t getReciprocalFrequencyOffset() noexcept { return offsetof(EncoderSymbol, mReciprocalFrequency); };
+  static constexpr size_t getFrequencyOffset() noexcept { return offsetof(EncoderSymbol, mFrequency); };
+  static constexpr size_t getBiasOffset() noexcept { return offsetof(EncoderSymbol, mBias); };
+  static constexpr size_t getFrequencyComplementOffset() noexcept { return offsetof(EncoderSymbol, mFrequencyComplement); };
+  static constexpr size_t getReciprocalShiftOffset() noexcept { return offsetof(EncoderSymbol, mReciprocalShift); };
+
  private:
   T mReciprocalFrequency{};       // Fixed-point reciprocal frequency
   count_t mFrequency{};           // (Exclusive) upper bound of pre-normalization interval
@@ -0,0 +1,206 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedDecoder.h
+/// @brief  nStreams interleaved rANS decoder states, advanced in lock step
+
+#ifndef RANS_INTERNAL_INTERLEAVEDDECODER_H
+#define RANS_INTERNAL_INTERLEAVEDDECODER_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+#include "rANS/internal/DecoderSymbol.h"
+#include "rANS/internal/helper.h"
+#include "rANS/internal/simd.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+// Counterpart of InterleavedEncoder: symbol i of the message is decoded by stream i % nStreams,
+// streams are initialized and renormalized from first to last.
+template <typename state_T, typename stream_T, size_t nStreams_V>
+class InterleavedDecoder
+{
+  static_assert((sizeof(state_T) == sizeof(uint32_t) && sizeof(stream_T) == sizeof(uint8_t)) ||
+                  (sizeof(state_T) == sizeof(uint64_t) && sizeof(stream_T) == sizeof(uint32_t)),
+                "Coder can either be 32Bit with 8 Bit stream type or 64 Bit Type with 32 Bit stream type");
+  static_assert(nStreams_V > 0 && nStreams_V <= 32, "number of interleaved streams must be in [1,32]");
+
+ public:
+  static constexpr size_t NStreams = nStreams_V;
+  using symbols_t = std::array<const DecoderSymbol*, nStreams_V>;
+
+  explicit InterleavedDecoder(size_t symbolTablePrecission) noexcept;
+
+  // Initializes all streams, reading backwards from inputIter which points to the last element of the encoded message.
+  template <typename stream_IT>
+  stream_IT init(stream_IT inputIter);
+
+  // Returns the current cumulative frequency of the given stream (map it to a symbol yourself!)
+  inline uint32_t get(size_t stream) const noexcept { return mStates[stream] & ((pow2(mSymbolTablePrecission)) - 1); };
+
+  // Advances all streams by one symbol, symbols[i] is the symbol decoded by stream i.
+  template <typename stream_IT>
+  stream_IT advanceSymbols(stream_IT inputIter, const symbols_t& symbols);
+
+  // Advances a single stream, used for incomplete groups at the end of the message.
+  template <typename stream_IT>
+  stream_IT advanceSymbol(stream_IT inputIter, const DecoderSymbol& symbol, size_t stream);
+
+  inline simd::InstructionSet getInstructionSet() const noexcept { return mInstructionSet; };
+
+ private:
+  alignas(64) std::array<state_T, nStreams_V> mStates{};
+  size_t mSymbolTablePrecission{};
+  simd::InstructionSet mInstructionSet{simd::InstructionSet::Scalar};
+
+  template <typename stream_IT>
+  stream_IT advanceSymbolsSIMD(stream_IT inputIter, const symbols_t& symbols);
+
+  template <typename stream_IT, size_t... streams_V>
+  stream_IT advanceSymbolsScalar(stream_IT inputIter, const symbols_t& symbols, std::index_sequence<streams_V...>);
+
+  inline static constexpr state_T LOWER_BOUND = needs64Bit<state_T>() ? (1u << 31) : (1u << 23);
+  inline static constexpr state_T STREAM_BITS = sizeof(stream_T) * 8;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+InterleavedDecoder<state_T, stream_T, nStreams_V>::InterleavedDecoder(size_t symbolTablePrecission) noexcept : mSymbolTablePrecission{symbolTablePrecission}
+{
+  if constexpr (needs64Bit<state_T>()) {
+    const auto set = simd::instructionSet();
+    if (set == simd::InstructionSet::AVX512 && nStreams_V % simd::getNLanes64(simd::InstructionSet::AVX512) == 0) {
+      mInstructionSet = simd::InstructionSet::AVX512;
+    } else if (set != simd::InstructionSet::Scalar && nStreams_V % simd::getNLanes64(simd::InstructionSet::AVX2) == 0) {
+      mInstructionSet = simd::InstructionSet::AVX2;
+    }
+  }
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::init(stream_IT inputIter)
+{
+  for (size_t i = 0; i < nStreams_V; ++i) {
+    state_T state = 0;
+    if constexpr (needs64Bit<state_T>()) {
+      state = static_cast<state_T>(*inputIter) << 0;
+      --inputIter;
+      state |= static_cast<state_T>(*inputIter) << 32;
+      --inputIter;
+    } else {
+      state = static_cast<state_T>(*inputIter) << 0;
+      --inputIter;
+      state |= static_cast<state_T>(*inputIter) << 8;
+      --inputIter;
+      state |= static_cast<state_T>(*inputIter) << 16;
+      --inputIter;
+      state |= static_cast<state_T>(*inputIter) << 24;
+      --inputIter;
+    }
+    mStates[i] = state;
+  }
+  return inputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbols(stream_IT inputIter, const symbols_t& symbols)
+{
+  if (mInstructionSet != simd::InstructionSet::Scalar) {
+    return advanceSymbolsSIMD(inputIter, symbols);
+  }
+  return advanceSymbolsScalar(inputIter, symbols, std::make_index_sequence<nStreams_V>{});
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT, size_t... streams_V>
+inline stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbolsScalar(stream_IT inputIter, const symbols_t& symbols, std::index_sequence<streams_V...>)
+{
+  // unrolled at compile time, first stream first
+  ((inputIter = advanceSymbol(inputIter, *symbols[streams_V], streams_V)), ...);
+  return inputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbolsSIMD(stream_IT inputIter, const symbols_t& symbols)
+{
+#ifdef RANS_SIMD_X86
+  if constexpr (needs64Bit<state_T>() && (nStreams_V % 4 == 0)) {
+    uint32_t renormMask = 0;
+    if constexpr (nStreams_V % 8 == 0) {
+      if (mInstructionSet == simd::InstructionSet::AVX512) {
+        renormMask = simd::decodeAVX512<nStreams_V>(mStates.data(), symbols.data(), mSymbolTablePrecission, LOWER_BOUND);
+      } else {
+        renormMask = simd::decodeAVX2<nStreams_V>(mStates.data(), symbols.data(), mSymbolTablePrecission, LOWER_BOUND);
+      }
+    } else {
+      renormMask = simd::decodeAVX2<nStreams_V>(mStates.data(), symbols.data(), mSymbolTablePrecission, LOWER_BOUND);
+    }
+
+    // stream in, first stream first
+    while (renormMask) {
+      const size_t stream = __builtin_ctz(renormMask);
+      mStates[stream] = (mStates[stream] << STREAM_BITS) | *inputIter;
+      --inputIter;
+      assert(mStates[stream] >= LOWER_BOUND);
+      renormMask &= renormMask - 1;
+    }
+    return inputIter;
+  }
+#endif
+  return advanceSymbolsScalar(inputIter, symbols, std::make_index_sequence<nStreams_V>{});
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbol(stream_IT inputIter, const DecoderSymbol& symbol, size_t stream)
+{
+  static_assert(std::is_same<typename std::iterator_traits<stream_IT>::value_type, stream_T>::value);
+  assert(stream < nStreams_V);
+
+  const state_T mask = (pow2(mSymbolTablePrecission)) - 1;
+
+  // s, x = D(x)
+  state_T state = mStates[stream];
+  state = symbol.getFrequency() * (state >> mSymbolTablePrecission) + (state & mask) - symbol.getCumulative();
+
+  // renormalize
+  if (state < LOWER_BOUND) {
+    if constexpr (needs64Bit<state_T>()) {
+      state = (state << STREAM_BITS) | *inputIter;
+      --inputIter;
+      assert(state >= LOWER_BOUND);
+    } else {
+      do {
+        state = (state << STREAM_BITS) | *inputIter;
+        --inputIter;
+      } while (state < LOWER_BOUND);
+    }
+  }
+  mStates[stream] = state;
+  return inputIter;
+};
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDDECODER_H */
@@ -0,0 +1,228 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedEncoder.h
+/// @brief  nStreams interleaved rANS encoder states, advanced in lock step
+
+#ifndef RANS_INTERNAL_INTERLEAVEDENCODER_H
+#define RANS_INTERNAL_INTERLEAVEDENCODER_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+#include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/helper.h"
+#include "rANS/internal/simd.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+// Symbol i of a message is encoded by stream i % nStreams. Streams share a single output buffer, encoding runs
+// backwards over the message and within a group of nStreams symbols the streams are renormalized from the last to the
+// first one, so that the decoder, running forward, can read back in the order it needs the data.
+// Streams are flushed from last to first. For nStreams = 2 this is the layout of the classic two way interleaved coder.
+template <typename state_T, typename stream_T, size_t nStreams_V>
+class InterleavedEncoder
+{
+  __extension__ using uint128_t = unsigned __int128;
+
+  static_assert((sizeof(state_T) == sizeof(uint32_t) && sizeof(stream_T) == sizeof(uint8_t)) ||
+                  (sizeof(state_T) == sizeof(uint64_t) && sizeof(stream_T) == sizeof(uint32_t)),
+                "Coder can either be 32Bit with 8 Bit stream type or 64 Bit Type with 32 Bit stream type");
+  static_assert(nStreams_V > 0 && nStreams_V <= 32, "number of interleaved streams must be in [1,32]");
+
+ public:
+  static constexpr size_t NStreams = nStreams_V;
+  using symbols_t = std::array<const EncoderSymbol<state_T>*, nStreams_V>;
+
+  explicit InterleavedEncoder(size_t symbolTablePrecission) noexcept;
+
+  // Encodes one symbol per stream, symbols[i] is encoded by stream i.
+  template <typename stream_IT>
+  stream_IT putSymbols(stream_IT outputIter, const symbols_t& symbols);
+
+  // Encodes a single symbol in the given stream, used for incomplete groups at the end of the message.
+  template <typename stream_IT>
+  stream_IT putSymbol(stream_IT outputIter, const EncoderSymbol<state_T>& symbol, size_t stream);
+
+  template <typename stream_IT>
+  stream_IT flush(stream_IT outputIter);
+
+  inline simd::InstructionSet getInstructionSet() const noexcept { return mInstructionSet; };
+
+ private:
+  alignas(64) std::array<state_T, nStreams_V> mStates;
+  size_t mSymbolTablePrecission{};
+  simd::InstructionSet mInstructionSet{simd::InstructionSet::Scalar};
+
+  template <typename stream_IT>
+  stream_IT putSymbolsSIMD(stream_IT outputIter, const symbols_t& symbols);
+
+  template <typename stream_IT, size_t... streams_V>
+  stream_IT putSymbolsScalar(stream_IT outputIter, const symbols_t& symbols, std::index_sequence<streams_V...>);
+
+  inline static constexpr state_T LOWER_BOUND = needs64Bit<state_T>() ? (1u << 31) : (1u << 23);
+  inline static constexpr state_T STREAM_BITS = sizeof(stream_T) * 8;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+InterleavedEncoder<state_T, stream_T, nStreams_V>::InterleavedEncoder(size_t symbolTablePrecission) noexcept : mSymbolTablePrecission{symbolTablePrecission}
+{
+  mStates.fill(LOWER_BOUND);
+  // SIMD kernels exist only for the 64 Bit state, they need full registers of streams
+  if constexpr (needs64Bit<state_T>()) {
+    if (!simd::simdEncoding()) {
+      return;
+    }
+    const auto set = simd::instructionSet();
+    if (set == simd::InstructionSet::AVX512 && nStreams_V % simd::getNLanes64(simd::InstructionSet::AVX512) == 0) {
+      mInstructionSet = simd::InstructionSet::AVX512;
+    } else if (set != simd::InstructionSet::Scalar && nStreams_V % simd::getNLanes64(simd::InstructionSet::AVX2) == 0) {
+      mInstructionSet = simd::InstructionSet::AVX2;
+    }
+  }
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbols(stream_IT outputIter, const symbols_t& symbols)
+{
+  if (mInstructionSet != simd::InstructionSet::Scalar) {
+    return putSymbolsSIMD(outputIter, symbols);
+  }
+  return putSymbolsScalar(outputIter, symbols, std::make_index_sequence<nStreams_V>{});
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT, size_t... streams_V>
+inline stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbolsScalar(stream_IT outputIter, const symbols_t& symbols, std::index_sequence<streams_V...>)
+{
+  // unrolled at compile time, last stream first
+  ((outputIter = putSymbol(outputIter, *symbols[nStreams_V - 1 - streams_V], nStreams_V - 1 - streams_V)), ...);
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbolsSIMD(stream_IT outputIter, const symbols_t& symbols)
+{
+#ifdef RANS_SIMD_X86
+  if constexpr (needs64Bit<state_T>() && (nStreams_V % 4 == 0)) {
+    const std::array<state_T, nStreams_V> previousStates = mStates;
+
+    uint32_t renormMask = 0;
+    if constexpr (nStreams_V % 8 == 0) {
+      if (mInstructionSet == simd::InstructionSet::AVX512) {
+        renormMask = simd::encodeAVX512<nStreams_V>(mStates.data(), symbols.data(), mSymbolTablePrecission);
+      } else {
+        renormMask = simd::encodeAVX2<nStreams_V>(mStates.data(), symbols.data(), mSymbolTablePrecission);
+      }
+    } else {
+      renormMask = simd::encodeAVX2<nStreams_V>(mStates.data(), symbols.data(), mSymbolTablePrecission);
+    }
+
+    // stream out in the same order as the scalar coder would: last stream first
+    while (renormMask) {
+      const size_t stream = 31 - __builtin_clz(renormMask);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(previousStates[stream]);
+      renormMask &= ~(1u << stream);
+    }
+    return outputIter;
+  }
+#endif
+  return putSymbolsScalar(outputIter, symbols, std::make_index_sequence<nStreams_V>{});
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbol(stream_IT outputIter, const EncoderSymbol<state_T>& symbol, size_t stream)
+{
+  assert(symbol.getFrequency() != 0); // can't encode symbol with freq=0
+  assert(stream < nStreams_V);
+
+  state_T state = mStates[stream];
+
+  // renormalize
+  const state_T maxState = ((LOWER_BOUND >> mSymbolTablePrecission) << STREAM_BITS) * symbol.getFrequency(); // this turns into a shift.
+  if constexpr (needs64Bit<state_T>() && isRandomAccessIter_v<stream_IT>) {
+    // branchless: always store, only advance if needed. The store is overwritten by a later renormalization or flush.
+    const bool renorm = state >= maxState;
+    *(outputIter + 1) = static_cast<stream_T>(state);
+    outputIter += renorm;
+    state = renorm ? (state >> STREAM_BITS) : state;
+  } else if (state >= maxState) {
+    if constexpr (needs64Bit<state_T>()) {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state);
+      state >>= STREAM_BITS;
+      assert(state < maxState);
+    } else {
+      do {
+        ++outputIter;
+        //stream out 8 Bits
+        *outputIter = static_cast<stream_T>(state & 0xff);
+        state >>= STREAM_BITS;
+      } while (state >= maxState);
+    }
+  }
+
+  // x = C(s,x)
+  state_T quotient = 0;
+  if constexpr (needs64Bit<state_T>()) {
+    quotient = static_cast<state_T>((static_cast<uint128_t>(state) * symbol.getReciprocalFrequency()) >> 64);
+  } else {
+    quotient = static_cast<state_T>((static_cast<uint64_t>(state) * symbol.getReciprocalFrequency()) >> 32);
+  }
+  quotient = quotient >> symbol.getReciprocalShift();
+
+  mStates[stream] = state + symbol.getBias() + quotient * symbol.getFrequencyComplement();
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::flush(stream_IT outputIter)
+{
+  for (size_t i = nStreams_V; i-- > 0;) {
+    const state_T state = mStates[i];
+    if constexpr (needs64Bit<state_T>()) {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 32);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 0);
+    } else {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 24);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 16);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 8);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 0);
+    }
+    mStates[i] = 0;
+  }
+  return outputIter;
+};
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDENCODER_H */
@@ -0,0 +1,280 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   simd.h
+/// @brief  runtime dispatched AVX2/AVX-512 kernels for the state updates of interleaved 64 bit rANS coders
+
+#ifndef RANS_INTERNAL_SIMD_H
+#define RANS_INTERNAL_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/DecoderSymbol.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(__CLING__)
+#define RANS_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+namespace simd
+{
+
+enum class InstructionSet : uint8_t { Scalar,
+                                      AVX2,
+                                      AVX512 };
+
+/// widest instruction set supported by the CPU we are running on
+inline InstructionSet detectInstructionSet() noexcept
+{
+#ifdef RANS_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return InstructionSet::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return InstructionSet::AVX2;
+  }
+#endif
+  return InstructionSet::Scalar;
+}
+
+/// instruction set used by newly created coders, defaults to the widest one available.
+/// Can be lowered (e.g. to Scalar) for validation and benchmarking.
+inline InstructionSet& instructionSet() noexcept
+{
+  static InstructionSet instructionSet = detectInstructionSet();
+  return instructionSet;
+}
+
+inline void setInstructionSet(InstructionSet set) noexcept
+{
+  instructionSet() = set < detectInstructionSet() ? set : detectInstructionSet();
+}
+
+/// The encoder kernels need five gathers and an emulated 64x64 Bit multiplication per register and did not beat the
+/// unrolled scalar interleaved encoder in benchmarks, so encoders only use them on request. Decoders always do.
+inline bool& simdEncoding() noexcept
+{
+  static bool simdEncoding = false;
+  return simdEncoding;
+}
+
+/// number of 64 bit lanes processed by one register of the given instruction set
+inline constexpr size_t getNLanes64(InstructionSet set) noexcept
+{
+  switch (set) {
+    case InstructionSet::AVX512:
+      return 8;
+    case InstructionSet::AVX2:
+      return 4;
+    default:
+      return 1;
+  }
+}
+
+#ifdef RANS_SIMD_X86
+
+// Symbols are gathered straight from the symbol tables: the index vectors hold the addresses of the symbols
+// of each lane, the base of the gather is null.
+template <typename symbol_T>
+__attribute__((target("avx2"))) inline __m256i gather64(__m256i symbols, size_t offset) noexcept
+{
+  return _mm256_i64gather_epi64(nullptr, _mm256_add_epi64(symbols, _mm256_set1_epi64x(offset)), 1);
+}
+
+template <typename symbol_T>
+__attribute__((target("avx2"))) inline __m256i gather32(__m256i symbols, size_t offset) noexcept
+{
+  return _mm256_cvtepu32_epi64(_mm256_i64gather_epi32(nullptr, _mm256_add_epi64(symbols, _mm256_set1_epi64x(offset)), 1));
+}
+
+template <typename symbol_T>
+__attribute__((target("avx512f"))) inline __m512i gather64(__m512i symbols, size_t offset) noexcept
+{
+  return _mm512_i64gather_epi64(_mm512_add_epi64(symbols, _mm512_set1_epi64(offset)), nullptr, 1);
+}
+
+template <typename symbol_T>
+__attribute__((target("avx512f"))) inline __m512i gather32(__m512i symbols, size_t offset) noexcept
+{
+  return _mm512_cvtepu32_epi64(_mm512_i64gather_epi32(_mm512_add_epi64(symbols, _mm512_set1_epi64(offset)), nullptr, 1));
+}
+
+// upper 64 bits of the 128 bit product of unsigned 64 bit integers, assembled from 32x32->64 bit multiplies
+__attribute__((target("avx2"))) inline __m256i mulhi64(__m256i a, __m256i b) noexcept
+{
+  const __m256i lowerMask = _mm256_set1_epi64x(0xffffffff);
+  const __m256i aHi = _mm256_srli_epi64(a, 32);
+  const __m256i bHi = _mm256_srli_epi64(b, 32);
+  const __m256i loLo = _mm256_mul_epu32(a, b);
+  const __m256i loHi = _mm256_mul_epu32(a, bHi);
+  const __m256i hiLo = _mm256_mul_epu32(aHi, b);
+  const __m256i hiHi = _mm256_mul_epu32(aHi, bHi);
+  const __m256i t = _mm256_add_epi64(hiLo, _mm256_srli_epi64(loLo, 32));
+  const __m256i w = _mm256_add_epi64(_mm256_and_si256(t, lowerMask), loHi);
+  return _mm256_add_epi64(_mm256_add_epi64(hiHi, _mm256_srli_epi64(t, 32)), _mm256_srli_epi64(w, 32));
+}
+
+// lower 64 bits of the product of an unsigned 64 bit and an unsigned 32 bit integer
+__attribute__((target("avx2"))) inline __m256i mullo64x32(__m256i a, __m256i b) noexcept
+{
+  return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), 32));
+}
+
+__attribute__((target("avx512f"))) inline __m512i mulhi64(__m512i a, __m512i b) noexcept
+{
+  const __m512i lowerMask = _mm512_set1_epi64(0xffffffff);
+  const __m512i aHi = _mm512_srli_epi64(a, 32);
+  const __m512i bHi = _mm512_srli_epi64(b, 32);
+  const __m512i loLo = _mm512_mul_epu32(a, b);
+  const __m512i loHi = _mm512_mul_epu32(a, bHi);
+  const __m512i hiLo = _mm512_mul_epu32(aHi, b);
+  const __m512i hiHi = _mm512_mul_epu32(aHi, bHi);
+  const __m512i t = _mm512_add_epi64(hiLo, _mm512_srli_epi64(loLo, 32));
+  const __m512i w = _mm512_add_epi64(_mm512_and_si512(t, lowerMask), loHi);
+  return _mm512_add_epi64(_mm512_add_epi64(hiHi, _mm512_srli_epi64(t, 32)), _mm512_srli_epi64(w, 32));
+}
+
+__attribute__((target("avx512f"))) inline __m512i mullo64x32(__m512i a, __m512i b) noexcept
+{
+  return _mm512_add_epi64(_mm512_mul_epu32(a, b), _mm512_slli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), b), 32));
+}
+
+/// Renormalization check and state update of nStreams 64 bit encoder states, symbols[i] is encoded by stream i.
+/// Returns a bitmask of all streams that need to stream out their lower 32 bits. The caller has to do so using the
+/// states *before* the call, the new states already account for the renormalization.
+template <size_t nStreams_V>
+__attribute__((target("avx2"))) inline uint32_t encodeAVX2(uint64_t* states, const EncoderSymbol<uint64_t>* const* symbols, size_t symbolTablePrecision) noexcept
+{
+  static_assert(nStreams_V % 4 == 0);
+  using symbol_t = EncoderSymbol<uint64_t>;
+  const __m256i signBit = _mm256_set1_epi64x(0x8000000000000000);
+  const __m128i boundShift = _mm_cvtsi64_si128(63 - symbolTablePrecision);
+  uint32_t renormMask = 0;
+
+  for (size_t i = 0; i < nStreams_V; i += 4) {
+    const __m256i symbolAddresses = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symbols + i));
+    __m256i state = _mm256_load_si256(reinterpret_cast<const __m256i*>(states + i));
+    const __m256i frequency = gather32<symbol_t>(symbolAddresses, symbol_t::getFrequencyOffset());
+
+    // renormalize: stream out 32 bits if state >= maxState = ((LOWER_BOUND >> precision) << 32) * frequency, unsigned comparison
+    const __m256i maxState = _mm256_sll_epi64(frequency, boundShift);
+    const __m256i keep = _mm256_cmpgt_epi64(_mm256_xor_si256(maxState, signBit), _mm256_xor_si256(state, signBit));
+    renormMask |= static_cast<uint32_t>(~_mm256_movemask_pd(_mm256_castsi256_pd(keep)) & 0xf) << i;
+    state = _mm256_blendv_epi8(_mm256_srli_epi64(state, 32), state, keep);
+
+    // x = C(s,x)
+    const __m256i reciprocal = gather64<symbol_t>(symbolAddresses, symbol_t::getReciprocalFrequencyOffset());
+    const __m256i shift = gather32<symbol_t>(symbolAddresses, symbol_t::getReciprocalShiftOffset());
+    const __m256i bias = gather32<symbol_t>(symbolAddresses, symbol_t::getBiasOffset());
+    const __m256i complement = gather32<symbol_t>(symbolAddresses, symbol_t::getFrequencyComplementOffset());
+    const __m256i quotient = _mm256_srlv_epi64(mulhi64(state, reciprocal), shift);
+    state = _mm256_add_epi64(_mm256_add_epi64(state, bias), mullo64x32(quotient, complement));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(states + i), state);
+  }
+  return renormMask;
+}
+
+template <size_t nStreams_V>
+__attribute__((target("avx512f"))) inline uint32_t encodeAVX512(uint64_t* states, const EncoderSymbol<uint64_t>* const* symbols, size_t symbolTablePrecision) noexcept
+{
+  static_assert(nStreams_V % 8 == 0);
+  using symbol_t = EncoderSymbol<uint64_t>;
+  const __m128i boundShift = _mm_cvtsi64_si128(63 - symbolTablePrecision);
+  uint32_t renormMask = 0;
+
+  for (size_t i = 0; i < nStreams_V; i += 8) {
+    const __m512i symbolAddresses = _mm512_loadu_si512(symbols + i);
+    __m512i state = _mm512_load_si512(states + i);
+    const __m512i frequency = gather32<symbol_t>(symbolAddresses, symbol_t::getFrequencyOffset());
+
+    // renormalize
+    const __m512i maxState = _mm512_sll_epi64(frequency, boundShift);
+    const __mmask8 renorm = _mm512_cmp_epu64_mask(state, maxState, _MM_CMPINT_NLT);
+    renormMask |= static_cast<uint32_t>(renorm) << i;
+    state = _mm512_mask_srli_epi64(state, renorm, state, 32);
+
+    // x = C(s,x)
+    const __m512i reciprocal = gather64<symbol_t>(symbolAddresses, symbol_t::getReciprocalFrequencyOffset());
+    const __m512i shift = gather32<symbol_t>(symbolAddresses, symbol_t::getReciprocalShiftOffset());
+    const __m512i bias = gather32<symbol_t>(symbolAddresses, symbol_t::getBiasOffset());
+    const __m512i complement = gather32<symbol_t>(symbolAddresses, symbol_t::getFrequencyComplementOffset());
+    const __m512i quotient = _mm512_srlv_epi64(mulhi64(state, reciprocal), shift);
+    state = _mm512_add_epi64(_mm512_add_epi64(state, bias), mullo64x32(quotient, complement));
+    _mm512_store_si512(states + i, state);
+  }
+  return renormMask;
+}
+
+/// State update s, x = D(x) of nStreams 64 bit decoder states, symbols[i] is the symbol decoded by stream i.
+/// Returns a bitmask of all streams whose new state dropped below LOWER_BOUND and that need to stream in 32 bits.
+template <size_t nStreams_V>
+__attribute__((target("avx2"))) inline uint32_t decodeAVX2(uint64_t* states, const DecoderSymbol* const* symbols, size_t symbolTablePrecision, uint64_t lowerBound) noexcept
+{
+  static_assert(nStreams_V % 4 == 0);
+  const __m128i precision = _mm_cvtsi64_si128(symbolTablePrecision);
+  const __m256i mask = _mm256_set1_epi64x((1ull << symbolTablePrecision) - 1);
+  // states are < 2^63 at all times, a signed comparison is sufficient
+  const __m256i bound = _mm256_set1_epi64x(lowerBound);
+  uint32_t renormMask = 0;
+
+  for (size_t i = 0; i < nStreams_V; i += 4) {
+    const __m256i symbolAddresses = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symbols + i));
+    __m256i state = _mm256_load_si256(reinterpret_cast<const __m256i*>(states + i));
+    const __m256i frequency = gather32<DecoderSymbol>(symbolAddresses, DecoderSymbol::getFrequencyOffset());
+    const __m256i cumulative = gather32<DecoderSymbol>(symbolAddresses, DecoderSymbol::getCumulativeOffset());
+    const __m256i product = mullo64x32(_mm256_srl_epi64(state, precision), frequency);
+    state = _mm256_sub_epi64(_mm256_add_epi64(product, _mm256_and_si256(state, mask)), cumulative);
+    const __m256i renorm = _mm256_cmpgt_epi64(bound, state);
+    renormMask |= static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(renorm))) << i;
+    _mm256_store_si256(reinterpret_cast<__m256i*>(states + i), state);
+  }
+  return renormMask;
+}
+
+template <size_t nStreams_V>
+__attribute__((target("avx512f"))) inline uint32_t decodeAVX512(uint64_t* states, const DecoderSymbol* const* symbols, size_t symbolTablePrecision, uint64_t lowerBound) noexcept
+{
+  static_assert(nStreams_V % 8 == 0);
+  const __m128i precision = _mm_cvtsi64_si128(symbolTablePrecision);
+  const __m512i mask = _mm512_set1_epi64((1ull << symbolTablePrecision) - 1);
+  const __m512i bound = _mm512_set1_epi64(lowerBound);
+  uint32_t renormMask = 0;
+
+  for (size_t i = 0; i < nStreams_V; i += 8) {
+    const __m512i symbolAddresses = _mm512_loadu_si512(symbols + i);
+    __m512i state = _mm512_load_si512(states + i);
+    const __m512i frequency = gather32<DecoderSymbol>(symbolAddresses, DecoderSymbol::getFrequencyOffset());
+    const __m512i cumulative = gather32<DecoderSymbol>(symbolAddresses, DecoderSymbol::getCumulativeOffset());
+    const __m512i product = mullo64x32(_mm512_srl_epi64(state, precision), frequency);
+    state = _mm512_sub_epi64(_mm512_add_epi64(product, _mm512_and_si512(state, mask)), cumulative);
+    renormMask |= static_cast<uint32_t>(_mm512_cmp_epu64_mask(state, bound, _MM_CMPINT_LT)) << i;
+    _mm512_store_si512(states + i, state);
+  }
+  return renormMask;
+}
+
+#endif /* RANS_SIMD_X86 */
+
+} // namespace simd
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_SIMD_H */
@@ -148,6 +148,21 @@ struct EncodeDecodeLiteral : public EncodeDecodeBase<o2::rans::LiteralEncoder, o
   std::vector<typename Params<coder_T>::source_t> literals;
 };
 
+template <typename coder_T, class dictString_T, class testString_T, size_t nStreams_V>
+struct EncodeDecodeInterleaved : public EncodeDecodeBase<o2::rans::LiteralEncoder, o2::rans::LiteralDecoder, coder_T, dictString_T, testString_T> {
+  void encode() override
+  {
+    BOOST_CHECK_NO_THROW(this->encoder.template processInterleaved<nStreams_V>(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), literals));
+  };
+  void decode() override
+  {
+    BOOST_CHECK_NO_THROW(this->decoder.template processInterleaved<nStreams_V>(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size(), literals));
+    BOOST_CHECK(literals.empty());
+  };
+
+  std::vector<typename Params<coder_T>::source_t> literals;
+};
+
 template <typename coder_T, class dictString_T, class testString_T>
 struct EncodeDecodeDedup : public EncodeDecodeBase<o2::rans::DedupEncoder, o2::rans::DedupDecoder, coder_T, dictString_T, testString_T> {
   void encode() override
@@ -186,4 +201,83 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, testCase_T, testCase_t)
   testCase.encode();
   testCase.decode();
   testCase.check();
-};
\ No newline at end of file
+};
+
+using interleavedTestCase_t = boost::mpl::vector<EncodeDecodeInterleaved<uint32_t, EmptyTestString, EmptyTestString, 4>,
+                                                 EncodeDecodeInterleaved<uint64_t, EmptyTestString, EmptyTestString, 8>,
+                                                 EncodeDecodeInterleaved<uint32_t, FullTestString, FullTestString, 4>,
+                                                 EncodeDecodeInterleaved<uint64_t, FullTestString, FullTestString, 4>,
+                                                 EncodeDecodeInterleaved<uint64_t, FullTestString, FullTestString, 8>,
+                                                 EncodeDecodeInterleaved<uint64_t, FullTestString, FullTestString, 16>,
+                                                 EncodeDecodeInterleaved<uint64_t, EmptyTestString, FullTestString, 8>,
+                                                 EncodeDecodeInterleaved<uint64_t, EmptyTestString, FullTestString, 16>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecodeInterleaved, testCase_T, interleavedTestCase_t)
+{
+  testCase_T testCase;
+  testCase.encode();
+  testCase.decode();
+  testCase.check();
+};
+
+BOOST_AUTO_TEST_CASE(test_interleavedLayout)
+{
+  // two interleaved streams are bit compatible with the classic coder
+  FullTestString source;
+  const std::string& s = source.data;
+  o2::rans::FrequencyTable frequencies;
+  frequencies.addSamples(std::begin(s), std::end(s));
+  const o2::rans::LiteralEncoder64<char> encoder{frequencies, 16};
+
+  std::vector<uint32_t> classic{};
+  std::vector<uint32_t> interleaved{};
+  std::vector<char> literals{};
+  encoder.process(std::begin(s), std::end(s), std::back_inserter(classic), literals);
+  encoder.processInterleaved<2>(std::begin(s), std::end(s), std::back_inserter(interleaved), literals);
+  BOOST_CHECK_EQUAL_COLLECTIONS(classic.begin(), classic.end(), interleaved.begin(), interleaved.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_interleavedSIMD)
+{
+  // SIMD and scalar code paths have to produce identical output
+  using namespace o2::rans::internal;
+  std::vector<int32_t> source(100003);
+  uint32_t seed = 42;
+  for (auto& symbol : source) {
+    seed = seed * 1664525u + 1013904223u;
+    symbol = static_cast<int32_t>((seed >> 16) % 17) * static_cast<int32_t>((seed >> 8) % 5) - 20;
+  }
+  o2::rans::FrequencyTable frequencies;
+  frequencies.addSamples(std::begin(source), std::begin(source) + source.size() / 2);
+  const o2::rans::LiteralEncoder64<int32_t> encoder{frequencies, 18};
+  const o2::rans::LiteralDecoder64<int32_t> decoder{frequencies, 18};
+
+  simd::simdEncoding() = true;
+  auto encode = [&](simd::InstructionSet set) {
+    simd::setInstructionSet(set);
+    std::vector<uint32_t> encoded{};
+    std::vector<int32_t> literals{};
+    encoder.processInterleaved<16>(std::begin(source), std::end(source), std::back_inserter(encoded), literals);
+    return std::make_tuple(encoded, literals);
+  };
+
+  auto decode = [&](simd::InstructionSet set, const std::vector<uint32_t>& encoded, std::vector<int32_t> literals) {
+    simd::setInstructionSet(set);
+    std::vector<int32_t> decoded{};
+    decoder.processInterleaved<16>(encoded.end(), std::back_inserter(decoded), source.size(), literals);
+    BOOST_CHECK(literals.empty());
+    return decoded;
+  };
+
+  const auto [scalarEncoded, scalarLiterals] = encode(simd::InstructionSet::Scalar);
+  for (auto set : {simd::InstructionSet::AVX2, simd::InstructionSet::AVX512}) {
+    const auto [encoded, literals] = encode(set);
+    BOOST_CHECK_EQUAL_COLLECTIONS(scalarEncoded.begin(), scalarEncoded.end(), encoded.begin(), encoded.end());
+    const auto decoded = decode(set, scalarEncoded, scalarLiterals);
+    BOOST_CHECK_EQUAL_COLLECTIONS(source.begin(), source.end(), decoded.begin(), decoded.end());
+  }
+  const auto decoded = decode(simd::InstructionSet::Scalar, scalarEncoded, scalarLiterals);
+  BOOST_CHECK_EQUAL_COLLECTIONS(source.begin(), source.end(), decoded.begin(), decoded.end());
+  simd::setInstructionSet(simd::detectInstructionSet());
+  simd::simdEncoding() = false;
+}